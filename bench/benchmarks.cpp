@@ -0,0 +1,920 @@
+/**
+ * @file benchmarks.cpp
+ * @brief Benchmarks micro y de extremo a extremo del Decodificador PRT-7.
+ *
+ * Mini-arnés al estilo de Google Benchmark, sin dependencias: cada benchmark
+ * recibe un EstadoBenchmark y repite su cuerpo mientras `seguir()` devuelva
+ * true. El arnés ajusta la cantidad de iteraciones hasta que la medición dure
+ * al menos el tiempo mínimo y reporta el tiempo por iteración y, si el
+ * benchmark lo indica, los elementos (caracteres, tramas) por segundo.
+ *
+ * Uso: BenchmarksPRT7 [--filtro TEXTO] [--tiempo-minimo SEGUNDOS]
+ *
+ * Se enlaza con la biblioteca `prt7`, igual que el programa principal. Para
+ * que los números sirvan, compilar con optimizaciones (e.g.,
+ * -DCMAKE_BUILD_TYPE=Release).
+ */
+
+#include <cstdio>       // Para printf()
+#include <cstdlib>      // Para atof(), mkstemp()
+#include <cstring>      // Para memcpy(), strcmp()
+#include <climits>      // Para INT_MAX
+#include <ctime>        // Para clock_gettime()
+#include <iostream>
+#include <atomic>       // Para std::atomic (fin de los lectores)
+#include <thread>       // Para std::thread (lectores de la instantánea)
+#include <unistd.h>     // Para close(), unlink(), usleep()
+
+#include "prt7/prt7.h"
+
+using namespace std;
+
+// ARNÉS DE BENCHMARKS
+
+/**
+ * @brief Impide que el compilador descarte un valor calculado dentro de un benchmark.
+ * @param valor Valor que debe considerarse usado.
+ */
+template <typename T>
+inline void noOptimizar(const T& valor) {
+    asm volatile("" : : "r,m"(valor) : "memory");
+}
+
+/**
+ * @brief Reloj monotónico en nanosegundos.
+ * @return Nanosegundos desde un origen arbitrario.
+ */
+static unsigned long long relojBenchmark() {
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (unsigned long long)ahora.tv_sec * 1000000000ULL + (unsigned long long)ahora.tv_nsec;
+}
+
+/**
+ * @class EstadoBenchmark
+ * @brief Controla las iteraciones de una corrida de un benchmark.
+ */
+class EstadoBenchmark {
+private:
+    unsigned long long iteraciones;   ///< Iteraciones pedidas para esta corrida.
+    unsigned long long restantes;     ///< Iteraciones que faltan.
+    unsigned long long inicio;        ///< Momento de la primera iteración.
+    unsigned long long fin;           ///< Momento en que terminó la última.
+    unsigned long long elementos;     ///< Elementos procesados en total (ver setElementosProcesados).
+    long argumento;                   ///< Parámetro del benchmark.
+
+public:
+    /**
+     * @brief Constructor.
+     * @param cantidad Iteraciones a ejecutar.
+     * @param parametro Parámetro del benchmark registrado.
+     */
+    EstadoBenchmark(unsigned long long cantidad, long parametro)
+        : iteraciones(cantidad), restantes(cantidad), inicio(0), fin(0), elementos(0),
+          argumento(parametro) {}
+    
+    /**
+     * @brief Decide si se ejecuta otra iteración. El cronómetro arranca en la primera llamada.
+     * @return true mientras queden iteraciones.
+     */
+    bool seguir() {
+        if (restantes == iteraciones) {
+            inicio = relojBenchmark();
+        }
+        if (restantes == 0) {
+            fin = relojBenchmark();
+            return false;
+        }
+        restantes--;
+        return true;
+    }
+    
+    /**
+     * @brief Indica cuántos elementos se procesaron en toda la corrida, para reportar elementos/s.
+     * @param cantidad Elementos procesados.
+     */
+    void setElementosProcesados(unsigned long long cantidad) {
+        elementos = cantidad;
+    }
+    
+    /**
+     * @brief Obtiene el parámetro del benchmark.
+     * @return El argumento con que se registró.
+     */
+    long getArgumento() const {
+        return argumento;
+    }
+    
+    /**
+     * @brief Obtiene las iteraciones de la corrida.
+     * @return Iteraciones pedidas.
+     */
+    unsigned long long getIteraciones() const {
+        return iteraciones;
+    }
+    
+    /**
+     * @brief Obtiene la duración medida.
+     * @return Nanosegundos entre la primera y la última iteración.
+     */
+    unsigned long long getDuracion() const {
+        return fin - inicio;
+    }
+    
+    /**
+     * @brief Obtiene los elementos procesados.
+     * @return Lo indicado con setElementosProcesados.
+     */
+    unsigned long long getElementos() const {
+        return elementos;
+    }
+};
+
+/**
+ * @struct RegistroBenchmark
+ * @brief Un benchmark registrado: nombre, función y parámetro.
+ */
+struct RegistroBenchmark {
+    const char* nombre;                     ///< Nombre mostrado en el reporte.
+    void (*funcion)(EstadoBenchmark&);      ///< Cuerpo del benchmark.
+    long argumento;                         ///< Parámetro que recibe en su estado.
+};
+
+static const int MAX_BENCHMARKS = 64;
+static RegistroBenchmark registrados[MAX_BENCHMARKS];
+static int cantidadRegistrados = 0;
+
+/**
+ * @brief Registra un benchmark (lo usa la macro PRT7_BENCHMARK).
+ * @param nombre Nombre mostrado.
+ * @param funcion Cuerpo del benchmark.
+ * @param argumento Parámetro del benchmark.
+ * @return Siempre true (para inicializar una variable estática).
+ */
+static bool registrarBenchmark(const char* nombre, void (*funcion)(EstadoBenchmark&), long argumento) {
+    if (cantidadRegistrados < MAX_BENCHMARKS) {
+        registrados[cantidadRegistrados].nombre = nombre;
+        registrados[cantidadRegistrados].funcion = funcion;
+        registrados[cantidadRegistrados].argumento = argumento;
+        cantidadRegistrados++;
+    }
+    return true;
+}
+
+#define PRT7_CONCATENAR_(a, b) a##b
+#define PRT7_CONCATENAR(a, b) PRT7_CONCATENAR_(a, b)
+
+/**
+ * @brief Registra `funcion` con el nombre y parámetro dados.
+ */
+#define PRT7_BENCHMARK(nombre, funcion, argumento) \
+    static bool PRT7_CONCATENAR(registroBenchmark, __LINE__) = \
+        registrarBenchmark(nombre, funcion, argumento)
+
+/**
+ * @brief Ejecuta un benchmark hasta que la corrida dure al menos el tiempo mínimo y la reporta.
+ * @param registro Benchmark a ejecutar.
+ * @param tiempoMinimo Duración mínima de la corrida medida, en nanosegundos.
+ */
+static void ejecutarBenchmark(const RegistroBenchmark& registro, unsigned long long tiempoMinimo) {
+    unsigned long long iteraciones = 1;
+    
+    while (true) {
+        EstadoBenchmark estado(iteraciones, registro.argumento);
+        registro.funcion(estado);
+        unsigned long long duracion = estado.getDuracion();
+        
+        if (duracion >= tiempoMinimo || iteraciones >= (1ULL << 40)) {
+            double porIteracion = (double)duracion / (double)iteraciones;
+            printf("%-36s %14.1f ns %14llu", registro.nombre, porIteracion, iteraciones);
+            
+            if (estado.getElementos() > 0 && duracion > 0) {
+                double porSegundo = (double)estado.getElementos() * 1e9 / (double)duracion;
+                printf(" %12.2fM/s", porSegundo / 1e6);
+            }
+            printf("\n");
+            fflush(stdout);
+            return;
+        }
+        
+        // Estimar las iteraciones necesarias, con margen, sin crecer más de 10x por paso
+        unsigned long long estimadas = duracion > 0
+            ? (unsigned long long)((double)iteraciones * 1.4 * (double)tiempoMinimo / (double)duracion)
+            : iteraciones * 10;
+        if (estimadas > iteraciones * 10) estimadas = iteraciones * 10;
+        if (estimadas <= iteraciones) estimadas = iteraciones + 1;
+        iteraciones = estimadas;
+    }
+}
+
+// GENERADORES DE CAPTURAS SINTÉTICAS
+
+/**
+ * @brief Generador pseudoaleatorio xorshift64 (determinista para una semilla).
+ * @param estado Estado del generador (se actualiza).
+ * @return Siguiente valor.
+ */
+static unsigned long long siguienteAleatorio(unsigned long long* estado) {
+    unsigned long long x = *estado;
+    x ^= x << 13;
+    x ^= x >> 7;
+    x ^= x << 17;
+    *estado = x;
+    return x;
+}
+
+/**
+ * @brief Genera una captura de texto con tramas "I", LOAD y MAP mezcladas y "FIN" al final.
+ * @param tramas Cantidad de tramas LOAD + MAP.
+ * @param mapeoPorMil Proporción de tramas MAP, en milésimas (e.g., 200 = 20 %).
+ * @param semilla Semilla del generador.
+ * @param tamano Recibe los bytes de la captura.
+ * @return Texto de la captura; liberar con `delete[]`.
+ */
+static char* generarCaptura(size_t tramas, long mapeoPorMil, unsigned long long semilla, size_t* tamano) {
+    const size_t MAX_TRAMA = 16;  // "M,-2147483647\n" es la más larga
+    char* texto = new char[tramas * MAX_TRAMA + 8];
+    size_t posicion = 0;
+    unsigned long long estado = semilla != 0 ? semilla : 1;
+    
+    texto[posicion++] = 'I';
+    texto[posicion++] = '\n';
+    
+    for (size_t i = 0; i < tramas; i++) {
+        unsigned long long valor = siguienteAleatorio(&estado);
+        
+        if ((long)(valor % 1000) < mapeoPorMil) {
+            int rotacion = (int)((valor >> 10) % 61) - 30;
+            posicion += (size_t)sprintf(texto + posicion, "M,%d\n", rotacion);
+        } else {
+            texto[posicion++] = 'L';
+            texto[posicion++] = ',';
+            texto[posicion++] = (char)('A' + (valor >> 10) % 26);
+            texto[posicion++] = '\n';
+        }
+    }
+    
+    memcpy(texto + posicion, "FIN\n", 4);
+    posicion += 4;
+    *tamano = posicion;
+    return texto;
+}
+
+/**
+ * @brief Genera la misma captura que `generarCaptura`, pero en modo binario después de "I" y "BIN".
+ *
+ * Los LOAD consecutivos se agrupan en tramas de carga de hasta MAX_CARGA_BINARIA caracteres.
+ * @param tramas Cantidad de tramas LOAD + MAP.
+ * @param mapeoPorMil Proporción de tramas MAP, en milésimas.
+ * @param semilla Semilla del generador.
+ * @param tamano Recibe los bytes de la captura.
+ * @return Bytes de la captura; liberar con `delete[]`.
+ */
+static char* generarCapturaBinaria(size_t tramas, long mapeoPorMil, unsigned long long semilla, size_t* tamano) {
+    char* datos = new char[tramas * 8 + 16];
+    char corrida[MAX_CARGA_BINARIA];
+    size_t largo = 0;
+    size_t posicion = 0;
+    unsigned long long estado = semilla != 0 ? semilla : 1;
+    
+    memcpy(datos, "I\nBIN\n", 6);
+    posicion += 6;
+    
+    for (size_t i = 0; i < tramas; i++) {
+        unsigned long long valor = siguienteAleatorio(&estado);
+        bool mapeo = (long)(valor % 1000) < mapeoPorMil;
+        
+        if ((mapeo && largo > 0) || largo == MAX_CARGA_BINARIA) {
+            posicion += codificarCargaBinaria(corrida, largo, datos + posicion);
+            largo = 0;
+        }
+        if (mapeo) {
+            posicion += codificarMapeoBinario((int)((valor >> 10) % 61) - 30, datos + posicion);
+        } else {
+            corrida[largo++] = (char)('A' + (valor >> 10) % 26);
+        }
+    }
+    if (largo > 0) {
+        posicion += codificarCargaBinaria(corrida, largo, datos + posicion);
+    }
+    
+    memcpy(datos + posicion, "FIN\n", 4);
+    posicion += 4;
+    *tamano = posicion;
+    return datos;
+}
+
+/**
+ * @brief Genera una captura de texto o binaria con GeneradorDeTramas, con "I" al comienzo y "FIN" al final.
+ * @param tramas Cantidad de tramas (líneas o tramas binarias).
+ * @param perfil Proporciones del flujo.
+ * @param tamano Recibe los bytes de la captura.
+ * @return Bytes de la captura; liberar con `delete[]`.
+ */
+static char* generarCapturaDePerfil(size_t tramas, const PerfilDeCarga& perfil, size_t* tamano) {
+    GeneradorDeTramas generador(perfil);
+    size_t capacidad = tramas * 8 + 2 * GeneradorDeTramas::MAX_TRAMA;
+    char* datos = new char[capacidad];
+    size_t posicion = 0;
+    
+    while (true) {
+        unsigned long long escritas;
+        posicion += generador.generar(datos + posicion, capacidad - posicion,
+                                      tramas - generador.getGeneradas(), &escritas);
+        if (generador.getGeneradas() == tramas) break;
+        
+        // Sin lugar para otra trama: se duplica el buffer
+        char* mayor = new char[capacidad * 2];
+        memcpy(mayor, datos, posicion);
+        delete[] datos;
+        datos = mayor;
+        capacidad *= 2;
+    }
+    
+    posicion += generador.finalizar(datos + posicion);
+    *tamano = posicion;
+    return datos;
+}
+
+/**
+ * @brief Genera un arreglo de líneas (sin terminador) para los benchmarks del parser.
+ * @param cantidad Cantidad de líneas.
+ * @param validas true para tramas válidas, false para líneas mal formadas.
+ * @param lineas Recibe punteros a las líneas dentro del texto devuelto.
+ * @param longitudes Recibe las longitudes.
+ * @return Texto con las líneas; liberar con `delete[]`.
+ */
+static char* generarLineas(size_t cantidad, bool validas, const char** lineas, int* longitudes) {
+    static const char* MAL_FORMADAS[] = { "X,1", "L", "M,", "M,-", "L;A", "MAP", "", "M,x12" };
+    char* texto = new char[cantidad * 16];
+    size_t posicion = 0;
+    unsigned long long estado = 42;
+    
+    for (size_t i = 0; i < cantidad; i++) {
+        unsigned long long valor = siguienteAleatorio(&estado);
+        int largo;
+        
+        if (validas && valor % 2 == 0) {
+            largo = sprintf(texto + posicion, "L,%c", (char)('A' + (valor >> 8) % 26));
+        } else if (validas) {
+            largo = sprintf(texto + posicion, "M,%d", (int)((valor >> 8) % 2001) - 1000);
+        } else {
+            largo = sprintf(texto + posicion, "%s", MAL_FORMADAS[(valor >> 8) % 8]);
+        }
+        lineas[i] = texto + posicion;
+        longitudes[i] = largo;
+        posicion += (size_t)largo + 1;
+    }
+    return texto;
+}
+
+// BENCHMARKS: ROTOR DE MAPEO
+
+/**
+ * @brief rotar con N pequeños (1 a 25, positivos y negativos).
+ */
+static void bmRotarPequeno(EstadoBenchmark& estado) {
+    RotorDeMapeo rotor;
+    int n = 1;
+    while (estado.seguir()) {
+        rotor.rotar(n);
+        n = n == 25 ? -25 : n + 1;
+    }
+    noOptimizar(rotor.getDesplazamiento());
+    estado.setElementosProcesados(estado.getIteraciones());
+}
+PRT7_BENCHMARK("rotar/pequeno", bmRotarPequeno, 0);
+
+/**
+ * @brief rotar con N cercanos a los extremos de int.
+ */
+static void bmRotarGrande(EstadoBenchmark& estado) {
+    RotorDeMapeo rotor;
+    int n = INT_MAX;
+    while (estado.seguir()) {
+        rotor.rotar(n);
+        n = n > 0 ? -n : -(n + 1);
+    }
+    noOptimizar(rotor.getDesplazamiento());
+    estado.setElementosProcesados(estado.getIteraciones());
+}
+PRT7_BENCHMARK("rotar/grande", bmRotarGrande, 0);
+
+/**
+ * @brief getMapeo (tabla) sobre un bloque de caracteres A-Z.
+ */
+static void bmGetMapeo(EstadoBenchmark& estado) {
+    const int LARGO = 4096;
+    char entrada[LARGO];
+    for (int i = 0; i < LARGO; i++) entrada[i] = (char)('A' + i % 26);
+    RotorDeMapeo rotor;
+    rotor.rotar(7);
+    
+    unsigned suma = 0;
+    while (estado.seguir()) {
+        for (int i = 0; i < LARGO; i++) {
+            suma += (unsigned char)rotor.getMapeo(entrada[i]);
+        }
+        noOptimizar(suma);
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * LARGO);
+}
+PRT7_BENCHMARK("getMapeo/tabla", bmGetMapeo, 0);
+
+/**
+ * @brief getMapeoEnlazado (recorrido del anillo), como referencia de la tabla.
+ */
+static void bmGetMapeoEnlazado(EstadoBenchmark& estado) {
+    const int LARGO = 4096;
+    char entrada[LARGO];
+    for (int i = 0; i < LARGO; i++) entrada[i] = (char)('A' + i % 26);
+    RotorDeMapeo rotor;
+    rotor.rotar(7);
+    
+    unsigned suma = 0;
+    while (estado.seguir()) {
+        for (int i = 0; i < LARGO; i++) {
+            suma += (unsigned char)rotor.getMapeoEnlazado(entrada[i]);
+        }
+        noOptimizar(suma);
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * LARGO);
+}
+PRT7_BENCHMARK("getMapeo/enlazado", bmGetMapeoEnlazado, 0);
+
+/**
+ * @brief Rotor de otro alfabeto: una rotación y 64 getMapeo sobre bytes de todo el rango, por elemento.
+ *
+ * Compara la tabla plana (alfanumérico, 36 símbolos) con las tablas constexpr
+ * sin reescritura al rotar (256 símbolos).
+ */
+template <typename Alfabeto>
+static void bmRotorDeAlfabeto(EstadoBenchmark& estado) {
+    const int LARGO = 64;
+    char entrada[LARGO];
+    for (int i = 0; i < LARGO; i++) entrada[i] = (char)(i * 37);
+    Rotor<Alfabeto> rotor;
+    
+    unsigned suma = 0;
+    int n = 1;
+    while (estado.seguir()) {
+        rotor.rotar(n);
+        n = n == 25 ? -25 : n + 1;
+        for (int i = 0; i < LARGO; i++) {
+            suma += (unsigned char)rotor.getMapeo(entrada[i]);
+        }
+        noOptimizar(suma);
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * LARGO);
+}
+PRT7_BENCHMARK("rotorDeAlfabeto/latino", bmRotorDeAlfabeto<AlfabetoLatino>, 0);
+PRT7_BENCHMARK("rotorDeAlfabeto/alfanumerico", bmRotorDeAlfabeto<AlfabetoAlfanumerico>, 0);
+PRT7_BENCHMARK("rotorDeAlfabeto/bytes", bmRotorDeAlfabeto<AlfabetoDeBytes>, 0);
+
+/**
+ * @brief Cascada con avance por carga: descifrar con K rotores (argumento K, o -K para mover
+ *        el rotor K-1 antes de cada carácter y recalcular siempre todos los tramos).
+ */
+static void bmCascada(EstadoBenchmark& estado) {
+    static const char* const NOMBRES[] = {"I", "II", "III", "IV", "V"};
+    long argumento = estado.getArgumento();
+    int rotores = (int)(argumento < 0 ? -argumento : argumento);
+    bool recalcularSiempre = argumento < 0;
+    
+    char especificacion[64] = "";
+    for (int r = 0; r < rotores; r++) {
+        if (r > 0) strcat(especificacion, ",");
+        strcat(especificacion, NOMBRES[r % 5]);
+    }
+    strcat(especificacion, "/B");
+    CascadaDeRotores cascada;
+    cascada.configurar(especificacion);
+    cascada.setPasoPorCarga(true);
+    
+    const int LARGO = 64;
+    char entrada[LARGO];
+    for (int i = 0; i < LARGO; i++) entrada[i] = (char)('A' + i * 7 % 26);
+    
+    unsigned suma = 0;
+    while (estado.seguir()) {
+        for (int i = 0; i < LARGO; i++) {
+            if (recalcularSiempre) cascada.rotar(rotores - 1, 1);
+            suma += (unsigned char)cascada.descifrar(entrada[i]);
+        }
+        noOptimizar(suma);
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * LARGO);
+}
+PRT7_BENCHMARK("cascada/K=1", bmCascada, 1);
+PRT7_BENCHMARK("cascada/K=3", bmCascada, 3);
+PRT7_BENCHMARK("cascada/K=8", bmCascada, 8);
+PRT7_BENCHMARK("cascada/K=8/sin_cache", bmCascada, -8);
+
+// BENCHMARKS: LISTA DE CARGA
+
+/**
+ * @brief insertarAlFinal de N caracteres en una lista nueva (N = argumento).
+ */
+static void bmInsertarAlFinal(EstadoBenchmark& estado) {
+    long cantidad = estado.getArgumento();
+    while (estado.seguir()) {
+        ListaDeCarga lista;
+        for (long i = 0; i < cantidad; i++) {
+            lista.insertarAlFinal((char)('A' + i % 26));
+        }
+        noOptimizar(lista.getLongitud());
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * (unsigned long long)cantidad);
+}
+PRT7_BENCHMARK("insertarAlFinal/1000", bmInsertarAlFinal, 1000);
+PRT7_BENCHMARK("insertarAlFinal/1000000", bmInsertarAlFinal, 1000000);
+
+/**
+ * @brief Mensaje en vivo: tras cada carácter se recorre lo nuevo (argumento 1) o todo el mensaje (0).
+ */
+static void bmVistaEnVivo(EstadoBenchmark& estado) {
+    const long CANTIDAD = 10000;
+    bool incremental = estado.getArgumento() != 0;
+    
+    while (estado.seguir()) {
+        ListaDeCarga lista;
+        size_t recorridos = 0;
+        const char* datos;
+        size_t cantidad;
+        
+        for (long i = 0; i < CANTIDAD; i++) {
+            lista.insertarAlFinal((char)('A' + i % 26));
+            if (!incremental) lista.reiniciarVista();
+            while (lista.leerNuevos(&datos, &cantidad)) {
+                recorridos += cantidad;
+            }
+        }
+        noOptimizar(recorridos);
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * CANTIDAD);
+}
+PRT7_BENCHMARK("vistaEnVivo/incremental", bmVistaEnVivo, 1);
+PRT7_BENCHMARK("vistaEnVivo/completa", bmVistaEnVivo, 0);
+
+/**
+ * @brief Mensaje de 4 Mi caracteres en corridas de 64: con sumidero a /dev/null (argumento 1) o acumulado (0).
+ */
+static void bmSumidero(EstadoBenchmark& estado) {
+    const size_t CANTIDAD = 1 << 22;
+    const size_t CORRIDA = 64;
+    bool enFlujo = estado.getArgumento() != 0;
+    char corrida[CORRIDA];
+    for (size_t i = 0; i < CORRIDA; i++) corrida[i] = (char)('A' + i % 26);
+    
+    while (estado.seguir()) {
+        ListaDeCarga lista;
+        SumideroDeDescriptor sumidero(&lista);
+        if (enFlujo && !sumidero.abrir("/dev/null")) break;
+        
+        for (size_t i = 0; i < CANTIDAD; i += CORRIDA) {
+            lista.insertarBloque(corrida, CORRIDA);
+            if (enFlujo) sumidero.volcarSiHaceFalta();
+        }
+        if (enFlujo) sumidero.volcar();
+        noOptimizar(lista.getRetenidos());
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * CANTIDAD);
+}
+PRT7_BENCHMARK("sumidero/acumulado", bmSumidero, 0);
+PRT7_BENCHMARK("sumidero/flujo", bmSumidero, 1);
+
+// BENCHMARKS: PARSER
+
+/**
+ * @brief parsearLinea sobre ranuras reutilizables; argumento 1 = válidas, 0 = mal formadas.
+ */
+static void bmParsearLinea(EstadoBenchmark& estado) {
+    const size_t CANTIDAD = 4096;
+    const char* lineas[CANTIDAD];
+    int longitudes[CANTIDAD];
+    char* texto = generarLineas(CANTIDAD, estado.getArgumento() != 0, lineas, longitudes);
+    RanurasDeTrama ranuras;
+    
+    while (estado.seguir()) {
+        for (size_t i = 0; i < CANTIDAD; i++) {
+            noOptimizar(parsearLinea(lineas[i], longitudes[i], &ranuras));
+        }
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * CANTIDAD);
+    delete[] texto;
+}
+PRT7_BENCHMARK("parsearLinea/validas", bmParsearLinea, 1);
+PRT7_BENCHMARK("parsearLinea/mal_formadas", bmParsearLinea, 0);
+
+/**
+ * @brief clasificarTrama sobre tramas válidas; argumento 1 = con sufijo "*HH", 0 = sin checksum.
+ */
+static void bmClasificarTrama(EstadoBenchmark& estado) {
+    const size_t CANTIDAD = 4096;
+    const char* lineas[CANTIDAD];
+    int longitudes[CANTIDAD];
+    char* texto = generarLineas(CANTIDAD, true, lineas, longitudes);
+    char* conChecksum = new char[CANTIDAD * 16];
+    
+    if (estado.getArgumento() != 0) {
+        for (size_t i = 0; i < CANTIDAD; i++) {
+            char* destino = conChecksum + i * 16;
+            unsigned char suma = 0;
+            for (int j = 0; j < longitudes[i]; j++) {
+                suma ^= (unsigned char)lineas[i][j];
+            }
+            longitudes[i] = sprintf(destino, "%.*s*%02X", longitudes[i], lineas[i], suma);
+            lineas[i] = destino;
+        }
+    }
+    RegistroTrama registro;
+    
+    while (estado.seguir()) {
+        for (size_t i = 0; i < CANTIDAD; i++) {
+            clasificarTrama(lineas[i], longitudes[i], &registro);
+            noOptimizar(registro.tipo);
+        }
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * CANTIDAD);
+    delete[] conChecksum;
+    delete[] texto;
+}
+PRT7_BENCHMARK("clasificarTrama/sin_checksum", bmClasificarTrama, 0);
+PRT7_BENCHMARK("clasificarTrama/con_checksum", bmClasificarTrama, 1);
+
+// BENCHMARKS: REPRODUCCIÓN DE EXTREMO A EXTREMO
+
+static const size_t TRAMAS_REPRODUCCION = 1000000;  ///< Tramas de cada captura sintética.
+
+/**
+ * @brief Reproducción en lote (procesarTexto) de una captura en memoria; argumento = MAP por mil.
+ */
+static void bmReproduccionLote(EstadoBenchmark& estado) {
+    size_t tamano;
+    char* captura = generarCaptura(TRAMAS_REPRODUCCION, estado.getArgumento(), 7, &tamano);
+    
+    while (estado.seguir()) {
+        ListaDeCarga carga;
+        RotorDeMapeo rotor;
+        Decodificador decodificador(&carga, &rotor);
+        size_t posicion = 0;
+        size_t consumidos = 1;
+        
+        while (consumidos > 0 && decodificador.procesarTexto(captura + posicion, tamano - posicion, &consumidos)) {
+            posicion += consumidos;
+        }
+        noOptimizar(carga.getLongitud());
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * TRAMAS_REPRODUCCION);
+    delete[] captura;
+}
+PRT7_BENCHMARK("reproduccion/lote/mapeo=1%", bmReproduccionLote, 10);
+PRT7_BENCHMARK("reproduccion/lote/mapeo=20%", bmReproduccionLote, 200);
+PRT7_BENCHMARK("reproduccion/lote/mapeo=50%", bmReproduccionLote, 500);
+
+/**
+ * @brief Reproducción línea por línea (clasificarTrama + procesar); argumento = MAP por mil.
+ */
+static void bmReproduccionPorLinea(EstadoBenchmark& estado) {
+    size_t tamano;
+    char* captura = generarCaptura(TRAMAS_REPRODUCCION, estado.getArgumento(), 7, &tamano);
+    
+    while (estado.seguir()) {
+        ListaDeCarga carga;
+        RotorDeMapeo rotor;
+        Decodificador decodificador(&carga, &rotor);
+        RegistroTrama registro;
+        const char* linea = captura;
+        const char* fin = captura + tamano;
+        
+        while (linea < fin) {
+            const char* terminador = (const char*)memchr(linea, '\n', fin - linea);
+            int longitud = (int)(terminador - linea);
+            clasificarTrama(linea, longitud, &registro);
+            if (!decodificador.procesar(registro, linea, longitud)) break;
+            linea = terminador + 1;
+        }
+        noOptimizar(carga.getLongitud());
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * TRAMAS_REPRODUCCION);
+    delete[] captura;
+}
+PRT7_BENCHMARK("reproduccion/por_linea/mapeo=1%", bmReproduccionPorLinea, 10);
+PRT7_BENCHMARK("reproduccion/por_linea/mapeo=20%", bmReproduccionPorLinea, 200);
+PRT7_BENCHMARK("reproduccion/por_linea/mapeo=50%", bmReproduccionPorLinea, 500);
+
+/**
+ * @brief Reproducción con DecodificadorContinuo, alimentado de a 4 KiB; argumento = MAP por mil.
+ */
+static void bmReproduccionContinua(EstadoBenchmark& estado) {
+    const size_t TROZO = 4096;
+    size_t tamano;
+    char* captura = generarCaptura(TRAMAS_REPRODUCCION, estado.getArgumento(), 7, &tamano);
+    
+    while (estado.seguir()) {
+        RotorDeMapeo rotor;
+        Decodificador decodificador(nullptr, &rotor);
+        DecodificadorContinuo continuo(&decodificador);
+        
+        for (size_t posicion = 0; posicion < tamano; posicion += TROZO) {
+            size_t cantidad = tamano - posicion < TROZO ? tamano - posicion : TROZO;
+            if (!continuo.alimentar(captura + posicion, cantidad)) break;
+        }
+        continuo.finalizar();
+        noOptimizar(decodificador.getTramasCarga());
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * TRAMAS_REPRODUCCION);
+    delete[] captura;
+}
+PRT7_BENCHMARK("reproduccion/continua/mapeo=1%", bmReproduccionContinua, 10);
+PRT7_BENCHMARK("reproduccion/continua/mapeo=20%", bmReproduccionContinua, 200);
+PRT7_BENCHMARK("reproduccion/continua/mapeo=50%", bmReproduccionContinua, 500);
+
+/**
+ * @brief Como reproduccion/continua (mapeo=20%), con bitácora; argumento = milisegundos entre puntos de control.
+ *
+ * Con 0 se escribe un punto de control por cada trozo de 4 KiB (fsync cada
+ * REGISTROS_POR_FSYNC), el peor caso del camino caliente.
+ */
+static void bmReproduccionConBitacora(EstadoBenchmark& estado) {
+    const size_t TROZO = 4096;
+    size_t tamano;
+    char* captura = generarCaptura(TRAMAS_REPRODUCCION, 200, 7, &tamano);
+    
+    while (estado.seguir()) {
+        char ruta[] = "/tmp/prt7-bitacora-XXXXXX";
+        int temporal = mkstemp(ruta);
+        if (temporal == -1) break;
+        close(temporal);
+        
+        RotorDeMapeo rotor;
+        Decodificador decodificador(nullptr, &rotor);
+        DecodificadorContinuo continuo(&decodificador);
+        BitacoraDeControl bitacora((int)estado.getArgumento());
+        bitacora.abrir(ruta);
+        unlink(ruta);
+        bitacora.observar(&decodificador);
+        
+        for (size_t posicion = 0; posicion < tamano; posicion += TROZO) {
+            size_t cantidad = tamano - posicion < TROZO ? tamano - posicion : TROZO;
+            bool continuar = continuo.alimentar(captura + posicion, cantidad);
+            bitacora.registrarSiVencido(continuo, posicion + cantidad);
+            if (!continuar) break;
+        }
+        continuo.finalizar();
+        bitacora.registrar(continuo, tamano);
+        noOptimizar(bitacora.getRegistros());
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * TRAMAS_REPRODUCCION);
+    delete[] captura;
+}
+PRT7_BENCHMARK("reproduccion/bitacora/por_trozo", bmReproduccionConBitacora, 0);
+PRT7_BENCHMARK("reproduccion/bitacora/250ms", bmReproduccionConBitacora, 250);
+
+/**
+ * @brief Como reproduccion/continua, pero con la captura en modo binario; argumento = MAP por mil.
+ */
+static void bmReproduccionBinaria(EstadoBenchmark& estado) {
+    const size_t TROZO = 4096;
+    size_t tamano;
+    char* captura = generarCapturaBinaria(TRAMAS_REPRODUCCION, estado.getArgumento(), 7, &tamano);
+    
+    while (estado.seguir()) {
+        RotorDeMapeo rotor;
+        Decodificador decodificador(nullptr, &rotor);
+        DecodificadorContinuo continuo(&decodificador);
+        
+        for (size_t posicion = 0; posicion < tamano; posicion += TROZO) {
+            size_t cantidad = tamano - posicion < TROZO ? tamano - posicion : TROZO;
+            if (!continuo.alimentar(captura + posicion, cantidad)) break;
+        }
+        continuo.finalizar();
+        noOptimizar(decodificador.getTramasCarga());
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * TRAMAS_REPRODUCCION);
+    delete[] captura;
+}
+PRT7_BENCHMARK("reproduccion/binaria/mapeo=1%", bmReproduccionBinaria, 10);
+PRT7_BENCHMARK("reproduccion/binaria/mapeo=20%", bmReproduccionBinaria, 200);
+PRT7_BENCHMARK("reproduccion/binaria/mapeo=50%", bmReproduccionBinaria, 500);
+
+/**
+ * @brief Como reproduccion/continua, con un flujo del GeneradorDeTramas: corridas de LOAD, M,N de
+ * hasta 2147483647 y, según el argumento, esa cantidad por mil de líneas mal formadas y con ruido.
+ */
+static void bmReproduccionFuzz(EstadoBenchmark& estado) {
+    const size_t TROZO = 4096;
+    PerfilDeCarga perfil;
+    perfil.semilla = 7;
+    perfil.corridaMaxima = 16;
+    perfil.rotacionMaxima = INT_MAX;
+    perfil.malFormadasPorMil = estado.getArgumento();
+    perfil.ruidoPorMil = estado.getArgumento();
+    perfil.reiniciosPorMil = estado.getArgumento() / 10;
+    size_t tamano;
+    char* captura = generarCapturaDePerfil(TRAMAS_REPRODUCCION, perfil, &tamano);
+    
+    while (estado.seguir()) {
+        RotorDeMapeo rotor;
+        Decodificador decodificador(nullptr, &rotor);
+        DecodificadorContinuo continuo(&decodificador);
+        
+        for (size_t posicion = 0; posicion < tamano; posicion += TROZO) {
+            size_t cantidad = tamano - posicion < TROZO ? tamano - posicion : TROZO;
+            if (!continuo.alimentar(captura + posicion, cantidad)) break;
+        }
+        continuo.finalizar();
+        noOptimizar(decodificador.getTramasCarga());
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * TRAMAS_REPRODUCCION);
+    delete[] captura;
+}
+PRT7_BENCHMARK("reproduccion/fuzz/sin_errores", bmReproduccionFuzz, 0);
+PRT7_BENCHMARK("reproduccion/fuzz/errores=5%", bmReproduccionFuzz, 50);
+
+/**
+ * @brief Lector de la instantánea, como el monitor: copia el estado cada `intervaloUs` hasta que le piden terminar.
+ * @param instantanea Instantánea que se lee.
+ * @param intervaloUs Microsegundos entre dos lecturas.
+ * @param terminar Se pone en true para que el hilo termine.
+ */
+static void leerCadaIntervalo(InstantaneaDeEstado* instantanea, long intervaloUs, const atomic<bool>* terminar) {
+    EstadoDecodificador copia;
+    long suma = 0;
+    while (!terminar->load(memory_order_relaxed)) {
+        instantanea->leer(&copia);
+        suma += copia.tramasCarga;
+        usleep((useconds_t)intervaloUs);
+    }
+    noOptimizar(suma);
+}
+
+/**
+ * @brief Como reproduccion/lote (mapeo=20%), publicando una instantánea; argumento = microsegundos entre
+ *        lecturas de un hilo lector (0 = sin lector).
+ */
+static void bmReproduccionConInstantanea(EstadoBenchmark& estado) {
+    size_t tamano;
+    char* captura = generarCaptura(TRAMAS_REPRODUCCION, 200, 7, &tamano);
+    long intervaloUs = estado.getArgumento();
+    
+    InstantaneaDeEstado instantanea;
+    atomic<bool> terminar(false);
+    thread lector;
+    if (intervaloUs > 0) {
+        lector = thread(leerCadaIntervalo, &instantanea, intervaloUs, &terminar);
+    }
+    
+    while (estado.seguir()) {
+        ListaDeCarga carga;
+        RotorDeMapeo rotor;
+        Decodificador decodificador(&carga, &rotor);
+        decodificador.setInstantanea(&instantanea);
+        size_t posicion = 0;
+        size_t consumidos = 1;
+        
+        while (consumidos > 0 && decodificador.procesarTexto(captura + posicion, tamano - posicion, &consumidos)) {
+            posicion += consumidos;
+        }
+        noOptimizar(carga.getLongitud());
+    }
+    estado.setElementosProcesados(estado.getIteraciones() * TRAMAS_REPRODUCCION);
+    
+    terminar.store(true, memory_order_relaxed);
+    if (lector.joinable()) lector.join();
+    delete[] captura;
+}
+PRT7_BENCHMARK("reproduccion/instantanea/sin_lector", bmReproduccionConInstantanea, 0);
+PRT7_BENCHMARK("reproduccion/instantanea/lector_100us", bmReproduccionConInstantanea, 100);
+
+// FUNCIÓN PRINCIPAL
+
+/**
+ * @brief Ejecuta los benchmarks registrados cuyo nombre contenga el filtro.
+ * @param argc Cantidad de argumentos.
+ * @param argv `--filtro TEXTO` y `--tiempo-minimo SEGUNDOS` (por defecto 0.5).
+ * @return 0 si terminó, 1 si hubo un argumento inválido.
+ */
+int main(int argc, char* argv[]) {
+    const char* filtro = "";
+    double tiempoMinimo = 0.5;
+    
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--filtro") == 0 && i + 1 < argc) {
+            filtro = argv[++i];
+        } else if (strcmp(argv[i], "--tiempo-minimo") == 0 && i + 1 < argc) {
+            tiempoMinimo = atof(argv[++i]);
+        } else {
+            cout << "Uso: " << argv[0] << " [--filtro TEXTO] [--tiempo-minimo SEGUNDOS]" << endl;
+            return 1;
+        }
+    }
+    
+    printf("%-36s %17s %14s %14s\n", "Benchmark", "Tiempo/iter", "Iteraciones", "Elementos/s");
+    for (int i = 0; i < cantidadRegistrados; i++) {
+        if (strstr(registrados[i].nombre, filtro) != nullptr) {
+            ejecutarBenchmark(registrados[i], (unsigned long long)(tiempoMinimo * 1e9));
+        }
+    }
+    return 0;
+}
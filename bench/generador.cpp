@@ -0,0 +1,636 @@
+/**
+ * @file generador.cpp
+ * @brief GeneradorPRT7: emite flujos PRT-7 sintéticos para someter al decodificador a carga.
+ *
+ * Escribe un flujo determinista (ver GeneradorDeTramas) a la salida estándar,
+ * a un archivo o a una pseudoterminal, a la tasa pedida o tan rápido como lo
+ * acepte el destino. Con `--pty` el decodificador lee del esclavo como de un
+ * puerto serial real, así que se mide el camino serial completo (termios,
+ * LectorDeLineas) y no solo la reproducción de capturas:
+ *
+ *     GeneradorPRT7 --pty --tramas 1000000 --corrida 50 --mal-formadas 20
+ *     DecodificadorPRT7 --puerto /dev/pts/N --verbosidad resumen --salida unix:/tmp/eco
+ *
+ * Con `--eco RUTA` el generador escucha en un socket UNIX el mensaje que el
+ * decodificador envía con `--salida unix:RUTA`; mide la latencia desde que
+ * se escribe cada trozo hasta que vuelven sus caracteres decodificados y
+ * verifica que el mensaje coincida con el esperado.
+ *
+ * Al terminar imprime en stderr los conteos que el decodificador debe
+ * informar (con el formato de su resumen), el rendimiento logrado y el
+ * tiempo bloqueado escribiendo, que indica cuándo el decodificador es el
+ * cuello de botella. Como la salida estándar puede ser el flujo, los
+ * mensajes y errores van siempre a stderr.
+ */
+
+#include <atomic>       // Para std::atomic (fin del eco)
+#include <cerrno>       // Para errno
+#include <csignal>      // Para signal(), SIGPIPE
+#include <cstdio>       // Para snprintf()
+#include <cstdlib>      // Para strtoll(), posix_openpt(), ptsname()
+#include <cstring>      // Para strcmp(), memcpy()
+#include <fcntl.h>      // Para open(), O_NOCTTY
+#include <iostream>
+#include <poll.h>       // Para poll()
+#include <sys/ioctl.h>  // Para ioctl(), TIOCINQ
+#include <sys/socket.h> // Para socket(), bind(), accept()
+#include <sys/un.h>     // Para struct sockaddr_un
+#include <termios.h>    // Para cfmakeraw(), tcsetattr()
+#include <thread>       // Para std::thread (lector del eco)
+#include <unistd.h>     // Para write(), close(), usleep()
+
+#include "prt7/prt7.h"
+
+using namespace std;
+
+// FUNCIÓN: HASH DEL MENSAJE
+
+/**
+ * @brief Suma caracteres a un hash FNV-1a de 64 bits.
+ * @param hash Hash acumulado.
+ * @param datos Caracteres.
+ * @param cantidad Cantidad de caracteres.
+ * @return El hash actualizado.
+ */
+static unsigned long long sumarHash(unsigned long long hash, const char* datos, size_t cantidad) {
+    for (size_t i = 0; i < cantidad; i++) {
+        hash = (hash ^ (unsigned char)datos[i]) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+static const unsigned long long HASH_INICIAL = 14695981039346656037ULL;
+
+// FUNCIÓN: ECO DEL DECODIFICADOR
+
+/**
+ * @struct MarcaDeEnvio
+ * @brief Momento en que se empezó a escribir un trozo y caracteres esperados hasta él.
+ */
+struct MarcaDeEnvio {
+    unsigned long long hasta;     ///< Caracteres esperados en total al terminar el trozo.
+    unsigned long long instante;  ///< Reloj al empezar a escribirlo, en nanosegundos.
+};
+
+/**
+ * @struct EcoDelDecodificador
+ * @brief Estado compartido entre el hilo que escribe y el que recibe el mensaje decodificado.
+ */
+struct EcoDelDecodificador {
+    int escucha;                                ///< Socket UNIX en escucha.
+    ColaSPSC<MarcaDeEnvio, 4096> marcas;        ///< Trozos escritos cuyos caracteres aún no volvieron.
+    std::atomic<bool> terminado;                ///< El generador ya escribió todo.
+    std::atomic<unsigned long long> esperados;  ///< Caracteres esperados en total (válido al terminar).
+    unsigned long long recibidos;               ///< (Lector) Caracteres recibidos.
+    unsigned long long hash;                    ///< (Lector) Hash de lo recibido.
+    bool conectado;                             ///< (Lector) El decodificador se conectó.
+    HistogramaLatencia latencia;                ///< (Lector) Latencia de cada trozo.
+    
+    /**
+     * @brief Constructor.
+     */
+    EcoDelDecodificador() : escucha(-1), terminado(false), esperados(0), recibidos(0),
+                            hash(HASH_INICIAL), conectado(false) {}
+};
+
+/**
+ * @brief Crea el socket UNIX en el que se recibe el mensaje decodificado.
+ * @param ruta Ruta del socket (se reemplaza si existe).
+ * @return El descriptor en escucha, o -1 en caso de error.
+ */
+static int escucharUnix(const char* ruta) {
+    struct sockaddr_un direccion;
+    if (strlen(ruta) >= sizeof(direccion.sun_path)) return -1;
+    
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+    memcpy(direccion.sun_path, ruta, strlen(ruta) + 1);
+    unlink(ruta);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) return -1;
+    if (bind(fd, (struct sockaddr*)&direccion, sizeof(direccion)) == -1 || listen(fd, 1) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Espera hasta 100 ms que un descriptor tenga datos o conexiones.
+ * @param fd Descriptor a esperar.
+ * @return true si está listo para leer.
+ */
+static bool esperarLectura(int fd) {
+    struct pollfd espera;
+    espera.fd = fd;
+    espera.events = POLLIN;
+    espera.revents = 0;
+    return poll(&espera, 1, 100) > 0;
+}
+
+/**
+ * @brief Hilo lector del eco: acepta al decodificador y mide cuándo vuelve cada trozo.
+ *
+ * Termina cuando el decodificador cierra la conexión, o cuando el generador
+ * terminó y pasan 2 segundos sin datos (e.g., con `--sin-fin`).
+ * @param eco Estado compartido.
+ */
+static void recibirEco(EcoDelDecodificador* eco) {
+    int conexion = -1;
+    while (conexion == -1) {
+        if (esperarLectura(eco->escucha)) {
+            conexion = accept(eco->escucha, nullptr, nullptr);
+        } else if (eco->terminado.load(memory_order_acquire)) {
+            return;
+        }
+    }
+    eco->conectado = true;
+    
+    char bloque[65536];
+    int inactivos = 0;
+    while (true) {
+        if (!esperarLectura(conexion)) {
+            if (eco->terminado.load(memory_order_acquire) && ++inactivos >= 20) break;
+            continue;
+        }
+        ssize_t n = read(conexion, bloque, sizeof(bloque));
+        if (n < 0 && errno == EINTR) continue;
+        if (n <= 0) break;
+        inactivos = 0;
+        
+        eco->recibidos += (unsigned long long)n;
+        eco->hash = sumarHash(eco->hash, bloque, (size_t)n);
+        
+        unsigned long long ahora = relojInstrumentacion();
+        MarcaDeEnvio* marca;
+        while ((marca = eco->marcas.frente()) != nullptr && marca->hasta <= eco->recibidos) {
+            eco->latencia.registrar(ahora - marca->instante);
+            eco->marcas.liberar();
+        }
+    }
+    close(conexion);
+}
+
+// FUNCIÓN: PSEUDOTERMINAL
+
+/**
+ * @brief Crea una pseudoterminal y deja su esclavo abierto en modo raw.
+ *
+ * El esclavo queda abierto para que escribir al maestro no falle antes de
+ * que el decodificador lo abra, y en modo raw porque el decodificador
+ * conserva los indicadores de entrada que encuentra (ICRNL cambiaría los
+ * bytes 0x0D de las tramas binarias).
+ * @param esclavo Recibe el descriptor del esclavo.
+ * @param ruta Recibe la ruta del esclavo (al menos 256 bytes).
+ * @return El descriptor del maestro, o -1 en caso de error.
+ */
+static int abrirPseudoterminal(int* esclavo, char* ruta) {
+    int maestro = posix_openpt(O_RDWR | O_NOCTTY);
+    if (maestro == -1) return -1;
+    
+    const char* nombre = nullptr;
+    if (grantpt(maestro) == 0 && unlockpt(maestro) == 0) {
+        nombre = ptsname(maestro);
+    }
+    if (nombre == nullptr || strlen(nombre) >= 256) {
+        close(maestro);
+        return -1;
+    }
+    strcpy(ruta, nombre);
+    
+    *esclavo = open(ruta, O_RDWR | O_NOCTTY);
+    if (*esclavo == -1) {
+        close(maestro);
+        return -1;
+    }
+    
+    struct termios modo;
+    tcgetattr(*esclavo, &modo);
+    cfmakeraw(&modo);
+    tcsetattr(*esclavo, TCSANOW, &modo);
+    return maestro;
+}
+
+/**
+ * @brief Espera (hasta 10 s) a que el decodificador lea todo lo escrito a la pseudoterminal.
+ * @param esclavo Descriptor del esclavo.
+ */
+static void esperarVaciado(int esclavo) {
+    for (int i = 0; i < 10000; i++) {
+        int pendientes = 0;
+        if (ioctl(esclavo, TIOCINQ, &pendientes) == -1 || pendientes == 0) return;
+        usleep(1000);
+    }
+}
+
+// FUNCIÓN: OPCIONES DEL PROGRAMA
+
+/**
+ * @struct OpcionesGenerador
+ * @brief Opciones de ejecución del generador.
+ */
+struct OpcionesGenerador {
+    PerfilDeCarga perfil;           ///< Proporciones del flujo.
+    unsigned long long tramas;      ///< Tramas a generar (0 = sin límite).
+    unsigned long long tasa;        ///< Tramas por segundo (0 = tan rápido como se pueda).
+    bool sinFin;                    ///< No enviar "FIN" al terminar.
+    bool pty;                       ///< Escribir a una pseudoterminal nueva.
+    int espera;                     ///< Milisegundos de espera antes de empezar a escribir.
+    char salida[256];               ///< Archivo de destino ("-" = salida estándar).
+    char esperado[256];             ///< Archivo para el mensaje esperado ("" = ninguno).
+    char eco[256];                  ///< Socket UNIX para recibir el mensaje decodificado ("" = sin eco).
+    
+    /**
+     * @brief Constructor. Por defecto, un millón de tramas a la salida estándar.
+     */
+    OpcionesGenerador() : tramas(1000000), tasa(0), sinFin(false), pty(false), espera(-1) {
+        strcpy(salida, "-");
+        esperado[0] = '\0';
+        eco[0] = '\0';
+    }
+};
+
+/**
+ * @brief Convierte un texto a entero validando el rango.
+ * @param texto El texto a convertir.
+ * @param minimo Valor mínimo aceptado.
+ * @param maximo Valor máximo aceptado.
+ * @param valor Recibe el número convertido.
+ * @return true si el texto es un entero completo dentro del rango.
+ */
+static bool leerNumero(const char* texto, long long minimo, long long maximo, long long* valor) {
+    char* fin;
+    errno = 0;
+    long long numero = strtoll(texto, &fin, 10);
+    if (fin == texto || *fin != '\0' || errno != 0 || numero < minimo || numero > maximo) {
+        return false;
+    }
+    *valor = numero;
+    return true;
+}
+
+/**
+ * @brief Copia un texto a un buffer de 256 bytes.
+ * @param destino Buffer de destino.
+ * @param valor Texto a copiar.
+ * @return false si el texto no cabe.
+ */
+static bool copiarTexto(char* destino, const char* valor) {
+    if (strlen(valor) >= 256) return false;
+    strcpy(destino, valor);
+    return true;
+}
+
+/**
+ * @brief Aplica una opción con valor.
+ * @param clave Nombre de la opción sin los guiones iniciales.
+ * @param valor Valor de la opción.
+ * @param opciones Opciones a modificar.
+ * @return true si la clave existe y el valor es válido.
+ */
+static bool aplicarOpcion(const char* clave, const char* valor, OpcionesGenerador* opciones) {
+    PerfilDeCarga* perfil = &opciones->perfil;
+    long long numero;
+    
+    if (strcmp(clave, "salida") == 0) return copiarTexto(opciones->salida, valor);
+    if (strcmp(clave, "esperado") == 0) return copiarTexto(opciones->esperado, valor);
+    if (strcmp(clave, "eco") == 0) return copiarTexto(opciones->eco, valor);
+    
+    if (strcmp(clave, "semilla") == 0) {
+        if (!leerNumero(valor, 1, 9223372036854775807LL, &numero)) return false;
+        perfil->semilla = (unsigned long long)numero;
+    } else if (strcmp(clave, "tramas") == 0) {
+        if (!leerNumero(valor, 0, 9223372036854775807LL, &numero)) return false;
+        opciones->tramas = (unsigned long long)numero;
+    } else if (strcmp(clave, "tasa") == 0) {
+        if (!leerNumero(valor, 0, 1000000000LL, &numero)) return false;
+        opciones->tasa = (unsigned long long)numero;
+    } else if (strcmp(clave, "mapeo") == 0) {
+        if (!leerNumero(valor, 0, 1000, &numero)) return false;
+        perfil->mapeoPorMil = (long)numero;
+    } else if (strcmp(clave, "mal-formadas") == 0) {
+        if (!leerNumero(valor, 0, 1000, &numero)) return false;
+        perfil->malFormadasPorMil = (long)numero;
+    } else if (strcmp(clave, "ruido") == 0) {
+        if (!leerNumero(valor, 0, 1000, &numero)) return false;
+        perfil->ruidoPorMil = (long)numero;
+    } else if (strcmp(clave, "reinicios") == 0) {
+        if (!leerNumero(valor, 0, 1000, &numero)) return false;
+        perfil->reiniciosPorMil = (long)numero;
+    } else if (strcmp(clave, "corrida") == 0) {
+        if (!leerNumero(valor, 1, 1000000, &numero)) return false;
+        perfil->corridaMaxima = (int)numero;
+    } else if (strcmp(clave, "rotacion-maxima") == 0) {
+        if (!leerNumero(valor, 0, 2147483647LL, &numero)) return false;
+        perfil->rotacionMaxima = (int)numero;
+    } else if (strcmp(clave, "espera") == 0) {
+        if (!leerNumero(valor, 0, 3600000, &numero)) return false;
+        opciones->espera = (int)numero;
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Muestra la ayuda de uso del programa.
+ * @param programa Nombre con el que se invocó el programa.
+ */
+static void mostrarUso(const char* programa) {
+    cerr << "Uso: " << programa << " [opciones]" << endl
+         << "  --tramas N           Tramas a generar (por defecto 1000000; 0 = sin limite)" << endl
+         << "  --semilla N          Semilla del sorteo (por defecto 1): igual semilla, igual flujo" << endl
+         << "  --mapeo POR_MIL      Tramas MAP entre las validas (por defecto 200)" << endl
+         << "  --mal-formadas POR_MIL  Lineas mal formadas o descartadas (por defecto 0)" << endl
+         << "  --ruido POR_MIL      Tramas con bytes de ruido en los extremos (por defecto 0)" << endl
+         << "  --reinicios POR_MIL  Marcadores I en medio del flujo (por defecto 0)" << endl
+         << "  --corrida N          Largo maximo de las corridas de LOAD (por defecto 1)" << endl
+         << "  --rotacion-maxima N  |N| maximo de los M,N, hasta 2147483647 (por defecto 30)" << endl
+         << "  --binario            Negocia BIN y envia tramas binarias (sin errores ni ruido)" << endl
+         << "  --tasa N             Tramas por segundo (por defecto 0 = tan rapido como se pueda)" << endl
+         << "  --sin-fin            No envia FIN al terminar" << endl
+         << "  --salida RUTA        Archivo de destino (por defecto \"-\" = salida estandar)" << endl
+         << "  --pty                Escribe a una pseudoterminal nueva; su ruta se informa" << endl
+         << "                       en stderr para usarla con --puerto" << endl
+         << "  --espera MS          Espera antes de escribir (con --pty, por defecto 1000)" << endl
+         << "  --esperado RUTA      Guarda el mensaje que el decodificador debe obtener" << endl
+         << "  --eco RUTA           Recibe en un socket UNIX el mensaje del decodificador" << endl
+         << "                       (--salida unix:RUTA), mide la latencia y lo verifica" << endl
+         << "  --ayuda              Muestra este mensaje" << endl;
+}
+
+/**
+ * @brief Interpreta los argumentos de la línea de comandos.
+ * @param argc Cantidad de argumentos.
+ * @param argv Argumentos del programa.
+ * @param opciones Opciones a llenar.
+ * @return 0 para continuar, 1 si hubo un error, -1 si solo se pidió la ayuda.
+ */
+static int analizarArgumentos(int argc, char* argv[], OpcionesGenerador* opciones) {
+    for (int i = 1; i < argc; i++) {
+        const char* argumento = argv[i];
+        
+        if (strcmp(argumento, "--ayuda") == 0 || strcmp(argumento, "-h") == 0) {
+            mostrarUso(argv[0]);
+            return -1;
+        }
+        if (strcmp(argumento, "--binario") == 0) {
+            opciones->perfil.binario = true;
+            continue;
+        }
+        if (strcmp(argumento, "--sin-fin") == 0) {
+            opciones->sinFin = true;
+            continue;
+        }
+        if (strcmp(argumento, "--pty") == 0) {
+            opciones->pty = true;
+            continue;
+        }
+        if (argumento[0] != '-' || argumento[1] != '-') {
+            cerr << "ERROR: Argumento desconocido '" << argumento << "'" << endl;
+            return 1;
+        }
+        if (i + 1 >= argc) {
+            cerr << "ERROR: Falta el valor de " << argumento << endl;
+            return 1;
+        }
+        
+        const char* valor = argv[++i];
+        if (!aplicarOpcion(argumento + 2, valor, opciones)) {
+            cerr << "ERROR: Opcion invalida " << argumento << " " << valor << endl;
+            return 1;
+        }
+    }
+    
+    const PerfilDeCarga& perfil = opciones->perfil;
+    if (perfil.binario && (perfil.malFormadasPorMil > 0 || perfil.ruidoPorMil > 0 || perfil.reiniciosPorMil > 0)) {
+        cerr << "ERROR: --binario no admite --mal-formadas, --ruido ni --reinicios" << endl;
+        return 1;
+    }
+    if (perfil.malFormadasPorMil + perfil.reiniciosPorMil > 1000) {
+        cerr << "ERROR: --mal-formadas y --reinicios suman mas de 1000 por mil" << endl;
+        return 1;
+    }
+    return 0;
+}
+
+// FUNCIÓN: MENSAJE ESPERADO
+
+/**
+ * @struct DestinosEsperado
+ * @brief Destinos del mensaje esperado (argumento de `registrarEsperado`).
+ */
+struct DestinosEsperado {
+    SalidaBufferizada* archivo;   ///< Archivo del mensaje esperado (o nullptr).
+    unsigned long long hash;      ///< Hash de lo esperado, para compararlo con el eco.
+};
+
+/**
+ * @brief Recibe los caracteres esperados del generador.
+ * @param contexto Puntero a DestinosEsperado.
+ * @param datos Caracteres esperados.
+ * @param cantidad Cantidad de caracteres.
+ */
+static void registrarEsperado(void* contexto, const char* datos, size_t cantidad) {
+    DestinosEsperado* destinos = static_cast<DestinosEsperado*>(contexto);
+    if (destinos->archivo != nullptr) destinos->archivo->escribir(datos, (int)cantidad);
+    destinos->hash = sumarHash(destinos->hash, datos, cantidad);
+}
+
+// FUNCIÓN PRINCIPAL
+
+/**
+ * @brief Escribe un trozo completo, acumulando el tiempo bloqueado.
+ * @param fd Descriptor de destino.
+ * @param datos Bytes a escribir.
+ * @param cantidad Cantidad de bytes.
+ * @param bloqueado Tiempo bloqueado acumulado, en nanosegundos.
+ * @return false si el destino dejó de aceptar datos (e.g., EPIPE).
+ */
+static bool escribirTrozo(int fd, const char* datos, size_t cantidad, unsigned long long* bloqueado) {
+    unsigned long long inicio = relojInstrumentacion();
+    bool completo = escribirTodo(fd, datos, cantidad);
+    *bloqueado += relojInstrumentacion() - inicio;
+    return completo;
+}
+
+int main(int argc, char* argv[]) {
+    OpcionesGenerador opciones;
+    int resultado = analizarArgumentos(argc, argv, &opciones);
+    if (resultado != 0) return resultado < 0 ? 0 : 1;
+    
+    // Un lector que se va (EPIPE) termina la generación, no el programa
+    signal(SIGPIPE, SIG_IGN);
+    
+    int fd = STDOUT_FILENO;
+    int esclavo = -1;
+    if (opciones.pty) {
+        char ruta[256];
+        fd = abrirPseudoterminal(&esclavo, ruta);
+        if (fd == -1) {
+            cerr << "ERROR: No se pudo crear la pseudoterminal" << endl;
+            return 1;
+        }
+        cerr << "PTY: " << ruta << endl;
+    } else if (strcmp(opciones.salida, "-") != 0) {
+        fd = open(opciones.salida, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd == -1) {
+            cerr << "ERROR: No se pudo abrir " << opciones.salida << endl;
+            return 1;
+        }
+    }
+    
+    SalidaBufferizada* archivoEsperado = nullptr;
+    int fdEsperado = -1;
+    if (opciones.esperado[0] != '\0') {
+        fdEsperado = open(opciones.esperado, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fdEsperado == -1) {
+            cerr << "ERROR: No se pudo abrir " << opciones.esperado << endl;
+            return 1;
+        }
+        archivoEsperado = new SalidaBufferizada(fdEsperado);
+    }
+    
+    EcoDelDecodificador* eco = nullptr;
+    thread lectorEco;
+    if (opciones.eco[0] != '\0') {
+        eco = new EcoDelDecodificador();
+        eco->escucha = escucharUnix(opciones.eco);
+        if (eco->escucha == -1) {
+            cerr << "ERROR: No se pudo escuchar en " << opciones.eco << endl;
+            return 1;
+        }
+        lectorEco = thread(recibirEco, eco);
+    }
+    
+    int espera = opciones.espera >= 0 ? opciones.espera : (opciones.pty ? 1000 : 0);
+    if (espera > 0) usleep((useconds_t)espera * 1000);
+    
+    GeneradorDeTramas generador(opciones.perfil);
+    DestinosEsperado destinos;
+    destinos.archivo = archivoEsperado;
+    destinos.hash = HASH_INICIAL;
+    generador.setAlGenerar(registrarEsperado, &destinos);
+    
+    // Trozos chicos con tasa (para repartir las tramas en el tiempo), de 64 KB sin ella
+    const size_t CAPACIDAD = 65536;
+    char* trozo = new char[CAPACIDAD];
+    unsigned long long bytes = 0;
+    unsigned long long bloqueado = 0;
+    unsigned long long retrasoMaximo = 0;
+    bool abierto = true;
+    unsigned long long inicio = relojInstrumentacion();
+    
+    while (abierto && (opciones.tramas == 0 || generador.getGeneradas() < opciones.tramas)) {
+        unsigned long long pedidas = opciones.tramas == 0 ? ~0ULL : opciones.tramas - generador.getGeneradas();
+        size_t capacidad = CAPACIDAD;
+        
+        if (opciones.tasa > 0) {
+            // Tramas que ya deberían haberse enviado según la tasa
+            unsigned long long transcurrido = relojInstrumentacion() - inicio;
+            unsigned long long debidas = (unsigned long long)((double)transcurrido * (double)opciones.tasa / 1e9);
+            if (debidas <= generador.getGeneradas()) {
+                unsigned long long proxima = (unsigned long long)((double)(generador.getGeneradas() + 1) * 1e9 /
+                                                                  (double)opciones.tasa);
+                unsigned long long dormir = (proxima - transcurrido) / 1000;
+                usleep((useconds_t)(dormir < 10000 ? dormir : 10000));
+                continue;
+            }
+            
+            // El retraso es lo que lleva esperando la trama más antigua del lote
+            unsigned long long debida = (unsigned long long)((double)generador.getGeneradas() * 1e9 /
+                                                             (double)opciones.tasa);
+            if (transcurrido > debida && transcurrido - debida > retrasoMaximo) retrasoMaximo = transcurrido - debida;
+            
+            if (debidas - generador.getGeneradas() < pedidas) pedidas = debidas - generador.getGeneradas();
+            if (capacidad > 4096) capacidad = 4096 + GeneradorDeTramas::MAX_TRAMA;
+        }
+        
+        size_t largo = generador.generar(trozo, capacidad, pedidas, nullptr);
+        if (eco != nullptr) {
+            // La latencia se mide desde que se empieza a escribir; sin lugar, el trozo no se mide
+            MarcaDeEnvio* marca = eco->marcas.reservar();
+            if (marca != nullptr) {
+                marca->hasta = (unsigned long long)generador.getTramasCarga();
+                marca->instante = relojInstrumentacion();
+                eco->marcas.publicar();
+            }
+        }
+        abierto = escribirTrozo(fd, trozo, largo, &bloqueado);
+        bytes += largo;
+    }
+    
+    if (abierto && !opciones.sinFin) {
+        size_t largo = generador.finalizar(trozo);
+        abierto = escribirTrozo(fd, trozo, largo, &bloqueado);
+        bytes += largo;
+    }
+    unsigned long long duracion = relojInstrumentacion() - inicio;
+    delete[] trozo;
+    
+    if (esclavo != -1) {
+        esperarVaciado(esclavo);
+        close(esclavo);
+    }
+    if (fd != STDOUT_FILENO) close(fd);
+    
+    if (archivoEsperado != nullptr) {
+        archivoEsperado->volcar();
+        delete archivoEsperado;
+        close(fdEsperado);
+    }
+    
+    if (eco != nullptr) {
+        eco->esperados.store((unsigned long long)generador.getTramasCarga(), memory_order_relaxed);
+        eco->terminado.store(true, memory_order_release);
+        lectorEco.join();
+        close(eco->escucha);
+        unlink(opciones.eco);
+    }
+    
+    // Resumen con el formato del decodificador, para compararlo con el suyo
+    long total = generador.getTramasCarga() + generador.getTramasMapeo() +
+                 generador.getTramasMalFormadas() + generador.getTramasDescartadas();
+    cerr << "Tramas procesadas: " << total
+         << " (carga: " << generador.getTramasCarga() << ", mapeo: " << generador.getTramasMapeo()
+         << ", mal formadas: " << generador.getTramasMalFormadas()
+         << ", descartadas: " << generador.getTramasDescartadas()
+         << ", reparadas: " << generador.getTramasReparadas() << ")" << endl;
+    
+    double segundos = (double)duracion / 1e9;
+    char linea[256];
+    snprintf(linea, sizeof(linea),
+             "[generador] %llu tramas, %llu bytes en %.1f ms (%.0f tramas/s, %.2f MB/s), "
+             "bloqueado escribiendo %.1f ms, retraso maximo %.1f ms",
+             generador.getGeneradas(), bytes, segundos * 1e3,
+             segundos > 0 ? (double)generador.getGeneradas() / segundos : 0.0,
+             segundos > 0 ? (double)bytes / segundos / 1e6 : 0.0,
+             (double)bloqueado / 1e6, (double)retrasoMaximo / 1e6);
+    cerr << linea << endl;
+    
+    bool coincide = true;
+    if (eco != nullptr) {
+        if (!eco->conectado) {
+            cerr << "[eco] El decodificador no se conecto a " << opciones.eco << endl;
+            coincide = false;
+        } else {
+            coincide = eco->recibidos == eco->esperados.load(memory_order_relaxed) && eco->hash == destinos.hash;
+            snprintf(linea, sizeof(linea),
+                     "[eco] %llu de %llu caracteres, latencia p50 %.3f ms, p99 %.3f ms, p99.9 %.3f ms, "
+                     "maximo %.3f ms; el mensaje %s",
+                     eco->recibidos, eco->esperados.load(memory_order_relaxed),
+                     (double)eco->latencia.percentil(500) / 1e6, (double)eco->latencia.percentil(990) / 1e6,
+                     (double)eco->latencia.percentil(999) / 1e6, (double)eco->latencia.getMaximo() / 1e6,
+                     coincide ? "coincide" : "NO coincide");
+            cerr << linea << endl;
+        }
+        delete eco;
+    }
+    
+    if (!abierto) {
+        cerr << "ERROR: El destino dejo de aceptar datos" << endl;
+        return 1;
+    }
+    return coincide ? 0 : 1;
+}
@@ -0,0 +1,100 @@
+/**
+ * @file prt7/binario.h
+ * @brief Formato binario compacto de tramas PRT-7 (modo negociado con la línea "BIN").
+ *
+ * En el formato de texto cada carácter de carga ocupa 4 bytes ("L,X\n") y
+ * cada rotación entre 4 y 8. Después de la línea de texto "BIN" el emisor
+ * puede enviar tramas binarias:
+ *
+ *     SINCRONIA  tipo  contenido  crc8
+ *
+ * - BINARIO_CARGA: longitud (varint, 1 a MAX_CARGA_BINARIA) seguida de esa
+ *   cantidad de caracteres cifrados; equivale a una corrida de tramas "L,X".
+ * - BINARIO_MAPEO: rotación con signo (varint zigzag); equivale a "M,N".
+ * - crc8: CRC-8 (polinomio 0x07) de `tipo` y `contenido`.
+ *
+ * Cualquier byte distinto de SINCRONIA donde se espera una trama termina el
+ * modo binario y el flujo vuelve a ser texto, así que los marcadores "I" y
+ * "FIN" se siguen enviando como texto; los '\r' y '\n' sueltos se saltan
+ * (e.g., el '\n' de un "BIN\r\n" enviado con `println`). Conviene que el emisor envíe un '\n'
+ * antes del texto: si se perdió la sincronía, el receptor salta bytes hasta
+ * la próxima SINCRONIA o el próximo '\n'.
+ */
+
+#ifndef PRT7_BINARIO_H
+#define PRT7_BINARIO_H
+
+#include <cstddef>      // Para size_t
+
+static const unsigned char SINCRONIA_BINARIA = 0xA7;  ///< Primer byte de toda trama binaria.
+static const unsigned char BINARIO_CARGA = 0x01;      ///< Tipo: corrida de caracteres cifrados.
+static const unsigned char BINARIO_MAPEO = 0x02;      ///< Tipo: rotación del rotor.
+static const size_t MAX_CARGA_BINARIA = 1024;         ///< Caracteres máximos por trama de carga.
+static const size_t MAX_VARINT = 5;                   ///< Bytes máximos de un varint de 32 bits.
+
+/// Tamaño máximo de una trama binaria completa (sincronía, tipo, longitud, carga y CRC).
+static const size_t MAX_TRAMA_BINARIA = 2 + MAX_VARINT + MAX_CARGA_BINARIA + 1;
+
+/**
+ * @enum ResultadoBinario
+ * @brief Resultado de analizar los bytes al comienzo de un bloque en modo binario.
+ */
+enum ResultadoBinario {
+    BINARIO_INCOMPLETA,  ///< Faltan bytes para completar la trama.
+    BINARIO_TRAMA_CARGA, ///< Trama de carga válida.
+    BINARIO_TRAMA_MAPEO, ///< Trama de mapeo válida.
+    BINARIO_INVALIDA,    ///< Tipo, longitud o CRC incorrectos; la trama se descarta.
+    BINARIO_TEXTO        ///< El primer byte no es SINCRONIA: el flujo vuelve a ser texto.
+};
+
+/**
+ * @struct TramaBinaria
+ * @brief Trama binaria analizada, como vista sobre los bytes recibidos.
+ */
+struct TramaBinaria {
+    const char* carga;  ///< Caracteres cifrados (solo para BINARIO_TRAMA_CARGA).
+    size_t largo;       ///< Cantidad de caracteres de `carga`.
+    int rotacion;       ///< Rotación (solo para BINARIO_TRAMA_MAPEO).
+    size_t tamano;      ///< Bytes que ocupa la trama (o que se descartan si es inválida).
+};
+
+/**
+ * @brief Calcula el CRC-8 (polinomio 0x07, valor inicial 0) de un bloque.
+ * @param datos Inicio del bloque.
+ * @param cantidad Cantidad de bytes.
+ * @param inicial CRC de los bloques anteriores, para calcularlo por partes.
+ * @return El CRC del bloque.
+ */
+unsigned char calcularCrc8(const unsigned char* datos, size_t cantidad, unsigned char inicial = 0);
+
+/**
+ * @brief Analiza la trama binaria que comienza en `datos`.
+ *
+ * Ante una trama inválida (tipo, longitud o CRC) quien llama decide cómo
+ * resincronizar; `tamano` es entonces la extensión que declaraba la trama
+ * (1 si ni siquiera su encabezado era válido).
+ * @param datos Bytes recibidos.
+ * @param cantidad Cantidad de bytes disponibles.
+ * @param trama Recibe la trama (su `tamano` vale para todos los resultados salvo INCOMPLETA y TEXTO).
+ * @return El resultado del análisis.
+ */
+ResultadoBinario analizarTramaBinaria(const char* datos, size_t cantidad, TramaBinaria* trama);
+
+/**
+ * @brief Codifica una trama de carga.
+ * @param cifrados Caracteres cifrados (1 a MAX_CARGA_BINARIA).
+ * @param largo Cantidad de caracteres.
+ * @param destino Buffer de al menos MAX_TRAMA_BINARIA bytes.
+ * @return Bytes escritos en `destino`.
+ */
+size_t codificarCargaBinaria(const char* cifrados, size_t largo, char* destino);
+
+/**
+ * @brief Codifica una trama de mapeo.
+ * @param rotacion Rotación con signo.
+ * @param destino Buffer de al menos MAX_TRAMA_BINARIA bytes.
+ * @return Bytes escritos en `destino`.
+ */
+size_t codificarMapeoBinario(int rotacion, char* destino);
+
+#endif // PRT7_BINARIO_H
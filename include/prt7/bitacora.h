@@ -0,0 +1,173 @@
+/**
+ * @file prt7/bitacora.h
+ * @brief Bitácora de puntos de control para reanudar una sesión después de reiniciar el proceso.
+ */
+
+#ifndef PRT7_BITACORA_H
+#define PRT7_BITACORA_H
+
+#include <cstddef>      // Para size_t
+
+#include "prt7/decodificador.h"
+#include "prt7/decodificador_continuo.h"
+#include "prt7/lista_de_carga.h"
+#include "prt7/rotor.h"
+
+/**
+ * @struct PuntoDeControl
+ * @brief Estado de una sesión en un momento dado: todo lo necesario para continuarla.
+ */
+struct PuntoDeControl {
+    int desplazamiento;                ///< Posición del rotor.
+    long tramasCarga;                  ///< Tramas LOAD procesadas.
+    long tramasMapeo;                  ///< Tramas MAP procesadas.
+    long tramasMalFormadas;            ///< Líneas mal formadas.
+    long tramasDescartadas;            ///< Tramas descartadas por el entramado.
+    long tramasReparadas;              ///< Tramas reparadas.
+    unsigned long long posicionEntrada; ///< Bytes de la entrada ya entregados al decodificador.
+    size_t longitudMensaje;            ///< Caracteres decodificados hasta este punto.
+    EstadoContinuo continuo;           ///< Línea o trama incompleta y modo del flujo.
+    
+    /**
+     * @brief Obtiene el número de secuencia de la próxima trama.
+     * @return Tramas recibidas hasta este punto.
+     */
+    long getSecuencia() const {
+        return tramasCarga + tramasMapeo + tramasMalFormadas + tramasDescartadas;
+    }
+};
+
+/**
+ * @class BitacoraDeControl
+ * @brief Archivo de solo agregado con un registro por punto de control.
+ *
+ * Cada registro lleva la posición del rotor, los conteos (y con ellos el
+ * número de secuencia), la posición en la entrada, el estado del
+ * DecodificadorContinuo y los caracteres decodificados desde el registro
+ * anterior, así que el mensaje se reconstruye concatenando los registros
+ * sin volver a procesar la captura. Los caracteres se reciben con
+ * `Decodificador::setAlDecodificar` (ver `observar`).
+ *
+ * Un registro se escribe con un solo `writev()` como mucho cada
+ * `intervaloMs` milisegundos y `fsync()` se llama una vez cada
+ * `registrosPorFsync` registros (y al sincronizar explícitamente), de modo
+ * que el costo en el camino caliente es una copia de los caracteres
+ * decodificados. Al recuperar, un registro final cortado por una caída
+ * (longitud o CRC incorrectos) se descarta y se trunca.
+ *
+ * Formato: la cabecera MARCA y después, por registro, un byte 'P', el largo
+ * del cuerpo (4 bytes), el cuerpo y el CRC-8 del cuerpo. Los enteros se
+ * guardan en el orden de bytes de la máquina: la bitácora no se comparte
+ * entre plataformas.
+ */
+class BitacoraDeControl {
+public:
+    static const int INTERVALO_MS = 250;      ///< Tiempo mínimo entre dos puntos de control, por defecto.
+    static const int REGISTROS_POR_FSYNC = 8; ///< Registros escritos por cada fsync(), por defecto.
+    
+private:
+    int fd;                    ///< Descriptor de la bitácora (-1 si está cerrada).
+    char* nuevos;              ///< Caracteres decodificados desde el último registro.
+    size_t largoNuevos;        ///< Bytes usados en `nuevos`.
+    size_t capacidadNuevos;    ///< Bytes reservados en `nuevos`.
+    size_t longitudMensaje;    ///< Caracteres registrados en total.
+    int intervaloMs;           ///< Tiempo mínimo entre dos puntos de control.
+    int registrosPorFsync;     ///< Registros por cada fsync().
+    int sinSincronizar;        ///< Registros escritos desde el último fsync().
+    long ultimoRegistro;       ///< Momento del último registro, en milisegundos.
+    unsigned long long ultimaPosicion; ///< Posición de la entrada en el último registro.
+    long registros;            ///< Registros escritos en esta ejecución.
+    long sincronizaciones;     ///< Llamadas a fsync() en esta ejecución.
+    
+    /**
+     * @brief Agrega caracteres decodificados al registro en curso (función para setAlDecodificar).
+     * @param contexto La bitácora.
+     * @param datos Caracteres decodificados.
+     * @param cantidad Cantidad de caracteres.
+     */
+    static void alDecodificar(void* contexto, const char* datos, size_t cantidad);
+    
+public:
+    /**
+     * @brief Constructor. La bitácora queda cerrada hasta llamar a `abrir`.
+     * @param intervalo Tiempo mínimo entre dos puntos de control, en milisegundos.
+     * @param porFsync Registros escritos por cada fsync() (1 = sincronizar cada registro).
+     */
+    explicit BitacoraDeControl(int intervalo = INTERVALO_MS, int porFsync = REGISTROS_POR_FSYNC);
+    
+    /**
+     * @brief Destructor. Sincroniza y cierra el archivo.
+     */
+    ~BitacoraDeControl();
+    
+    /**
+     * @brief Abre (o crea) el archivo de la bitácora.
+     * @param ruta Path del archivo.
+     * @return false si no se pudo abrir o no es una bitácora.
+     */
+    bool abrir(const char* ruta);
+    
+    /**
+     * @brief Lee la bitácora, reconstruye el mensaje y obtiene el último punto de control.
+     *
+     * Si el último punto es de una sesión terminada ("FIN"), la bitácora se
+     * vacía y se empieza una sesión nueva. Llamar una vez, antes de `observar`.
+     * @param carga Lista a la que se agregan los caracteres registrados.
+     * @param punto Recibe el último punto de control.
+     * @return true si hay una sesión para reanudar (y `punto` es válido).
+     */
+    bool recuperar(ListaDeCarga* carga, PuntoDeControl* punto);
+    
+    /**
+     * @brief Empieza a recibir los caracteres decodificados de un decodificador.
+     * @param decodificador Decodificador cuya salida se registra (reemplaza su setAlDecodificar).
+     */
+    void observar(Decodificador* decodificador);
+    
+    /**
+     * @brief Escribe un punto de control con el estado actual.
+     * @param continuo Decodificador de flujo continuo (con su decodificador, rotor y conteos).
+     * @param posicionEntrada Bytes de la entrada ya entregados a `continuo`.
+     * @return false si no se pudo escribir.
+     */
+    bool registrar(const DecodificadorContinuo& continuo, unsigned long long posicionEntrada);
+    
+    /**
+     * @brief Escribe un punto de control si pasó el intervalo desde el anterior.
+     * @param continuo Decodificador de flujo continuo.
+     * @param posicionEntrada Bytes de la entrada ya entregados a `continuo`.
+     * @return false si tocaba escribir y no se pudo.
+     */
+    bool registrarSiVencido(const DecodificadorContinuo& continuo, unsigned long long posicionEntrada);
+    
+    /**
+     * @brief Fuerza a disco los registros escritos (fsync).
+     */
+    void sincronizar();
+    
+    /**
+     * @brief Obtiene los registros escritos en esta ejecución.
+     * @return Cantidad de puntos de control.
+     */
+    long getRegistros() const {
+        return registros;
+    }
+    
+    /**
+     * @brief Obtiene las llamadas a fsync() de esta ejecución.
+     * @return Cantidad de sincronizaciones.
+     */
+    long getSincronizaciones() const {
+        return sincronizaciones;
+    }
+};
+
+/**
+ * @brief Aplica un punto de control recuperado a un rotor, un decodificador y su flujo continuo.
+ * @param punto Punto de control.
+ * @param continuo Decodificador de flujo continuo recién creado (con un rotor sin rotar).
+ * @return false si el estado del flujo del punto no es válido.
+ */
+bool reanudarSesion(const PuntoDeControl& punto, DecodificadorContinuo* continuo);
+
+#endif // PRT7_BITACORA_H
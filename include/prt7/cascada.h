@@ -0,0 +1,231 @@
+/**
+ * @file prt7/cascada.h
+ * @brief Cascada de rotores con reflector y avance tipo Enigma, con tabla compuesta en caché.
+ */
+
+#ifndef PRT7_CASCADA_H
+#define PRT7_CASCADA_H
+
+#include <cstddef>      // Para size_t
+
+#include "prt7/rotor.h"
+
+/**
+ * @class CascadaDeRotores
+ * @brief K rotores cableados en serie, con reflector opcional y reglas de avance tipo Enigma.
+ *
+ * El rotor 0 es el rápido (el de la entrada). Cada rotor tiene un cableado
+ * (una permutación de A-Z) y una muesca. En la posición `p`, la señal que
+ * entra por el contacto `x` sale por `cableado[(x + p) % 26] - p`. El
+ * carácter cifrado atraviesa los rotores del 0 al K-1. Si hay reflector,
+ * vuelve por ellos en orden inverso (como en la Enigma, cifrar y descifrar
+ * son la misma operación). Sin reflector, descifrar aplica los cableados
+ * inversos del K-1 al 0.
+ *
+ * Para cada rotor r >= 1 se guarda la permutación compuesta del tramo que
+ * empieza en él (rotores r a K-1 y reflector) en `tramos[r]`. Cuando se
+ * mueve el rotor j, en la carga siguiente se recalculan solo los tramos j a
+ * 1, cada uno a partir del siguiente. Descifrar un carácter son tres
+ * lecturas de tabla: la entrada y la salida del rotor 0 en su posición y
+ * `tramos[1]`. Con avance por carga el rotor j se mueve una vez cada 26^j
+ * caracteres, así que el costo promedio tampoco depende de K.
+ *
+ * Un paso (`avanzar`) mueve el rotor 0. Cada rotor que está en su muesca
+ * arrastra al siguiente, y los intermedios que están en su muesca también
+ * avanzan (doble paso). Los rotores en su muesca se llevan en una máscara de
+ * bits, así que un paso sin arrastre cuesta O(1).
+ */
+class CascadaDeRotores {
+public:
+    static const int LONGITUD = 26;           ///< Símbolos de cada rotor (A-Z).
+    static const int MAX_ROTORES = 10;        ///< Rotores de la cascada ("Mk,N" lleva un dígito).
+    static const int MAX_PASOS = 17576;       ///< Pasos por trama "MP,N" (26^3, un ciclo de tres rotores).
+    static const int SIN_MUESCA = -1;         ///< Rotor que no arrastra al siguiente.
+    
+private:
+    typedef TablasDeAlfabeto<AlfabetoLatino> Tablas;
+    
+    int cantidad;                                          ///< Rotores cargados.
+    unsigned char adelante[MAX_ROTORES][LONGITUD][LONGITUD]; ///< Contacto de salida hacia el reflector, por posición.
+    unsigned char atras[MAX_ROTORES][LONGITUD][LONGITUD];   ///< Contacto de salida hacia la entrada, por posición.
+    int posiciones[MAX_ROTORES];                           ///< Posición de cada rotor (0 = 'A').
+    int muescas[MAX_ROTORES];                              ///< Posición que arrastra al siguiente rotor.
+    unsigned enMuesca;                                     ///< Bit i: el rotor i (no el último) está en su muesca.
+    unsigned char reflector[LONGITUD];                     ///< Cableado del reflector.
+    bool conReflector;                                     ///< La señal vuelve por los rotores.
+    bool pasoPorCarga;                                     ///< Avanzar un paso antes de cada carácter.
+    unsigned char tramos[MAX_ROTORES + 1][LONGITUD];       ///< Tramo desde el rotor r; `tramos[K]` es el reflector.
+    int vencido;                                           ///< Mayor rotor movido sin recalcular sus tramos (0 = ninguno).
+    long recalculos;                                       ///< Tramos recalculados.
+    
+    /**
+     * @brief Recalcula los tramos `vencido` a 1 con las posiciones actuales.
+     */
+    void recalcularTramos();
+    
+    /**
+     * @brief Actualiza el bit de `enMuesca` de un rotor después de moverlo.
+     * @param rotor Índice del rotor.
+     */
+    void actualizarMuesca(int rotor) {
+        if (rotor < cantidad - 1 && posiciones[rotor] == muescas[rotor]) {
+            enMuesca |= 1u << rotor;
+        } else {
+            enMuesca &= ~(1u << rotor);
+        }
+    }
+    
+    /**
+     * @brief Mueve un rotor una posición hacia adelante.
+     * @param rotor Índice del rotor.
+     */
+    void moverUno(int rotor) {
+        posiciones[rotor] = posiciones[rotor] == LONGITUD - 1 ? 0 : posiciones[rotor] + 1;
+        actualizarMuesca(rotor);
+        if (rotor > vencido) vencido = rotor;
+    }
+    
+    /**
+     * @brief Da un paso con las reglas de avance (ver la descripción de la clase).
+     */
+    void pasoUnico() {
+        unsigned mueven = 1u | (enMuesca << 1) | (enMuesca & ~1u);
+        while (mueven != 0) {
+            moverUno(__builtin_ctz(mueven));
+            mueven &= mueven - 1;
+        }
+    }
+    
+public:
+    /**
+     * @brief Constructor. Crea una cascada sin rotores ni reflector (ver `configurar`).
+     */
+    CascadaDeRotores();
+    
+    /**
+     * @brief Agrega un rotor al final de la cascada (del lado del reflector), en la posición 'A'.
+     * @param cableado 26 letras A-Z sin repetir: la salida de cada contacto en la posición 'A'.
+     * @param muesca Posición (0 a 25) en la que arrastra al siguiente rotor, o SIN_MUESCA.
+     * @return false si la cascada está llena o el cableado no es una permutación de A-Z.
+     */
+    bool agregarRotor(const char* cableado, int muesca);
+    
+    /**
+     * @brief Coloca un reflector al final de la cascada.
+     * @param cableado 26 letras A-Z que intercambian las letras de a pares, sin dejar ninguna fija.
+     * @return false si el cableado no es una involución sin puntos fijos.
+     */
+    bool setReflector(const char* cableado);
+    
+    /**
+     * @brief Configura la cascada desde un texto como "III,II,I/B".
+     *
+     * Los rotores van separados por comas, del 0 (el rápido) al último, y el
+     * reflector opcional va después de '/'. Cada rotor es un nombre del
+     * catálogo (I a V de la Enigma I, con sus muescas) o un cableado de 26
+     * letras seguido opcionalmente de "@X" (la letra de la muesca). El
+     * reflector es B, C o un cableado de 26 letras.
+     * @param especificacion Texto de la configuración.
+     * @return false si el texto no es válido (la cascada queda vacía).
+     */
+    bool configurar(const char* especificacion);
+    
+    /**
+     * @brief Activa o desactiva el avance de un paso antes de cada carácter A-Z (como una tecla de la Enigma).
+     * @param activo true para avanzar en cada carga.
+     */
+    void setPasoPorCarga(bool activo) {
+        pasoPorCarga = activo;
+    }
+    
+    /**
+     * @brief Rota un rotor N posiciones sin arrastrar a los demás (trama "Mk,N").
+     * @param rotor Índice del rotor (0 a getCantidad() - 1).
+     * @param N Posiciones a rotar; negativo para retroceder. El costo no depende de |N|.
+     */
+    void rotar(int rotor, int N) {
+        PRT7_CONTAR(rotaciones, 1);
+        int pasos = N % LONGITUD;
+        if (pasos == 0) return;
+        
+        posiciones[rotor] = (posiciones[rotor] + pasos + LONGITUD) % LONGITUD;
+        actualizarMuesca(rotor);
+        if (rotor > vencido) vencido = rotor;
+    }
+    
+    /**
+     * @brief Avanza la cascada con las reglas de avance (trama "MP,N").
+     * @param pasos Cantidad de pasos (0 a MAX_PASOS).
+     */
+    void avanzar(int pasos) {
+        for (int i = 0; i < pasos; i++) {
+            pasoUnico();
+        }
+    }
+    
+    /**
+     * @brief Descifra un carácter; si está activo el paso por carga, antes avanza un paso.
+     * @param in El carácter cifrado.
+     * @return El carácter descifrado. Los bytes fuera de A-Z pasan sin cambios y sin avanzar.
+     */
+    char descifrar(char in) {
+        PRT7_CONTAR(consultasMapeo, 1);
+        int x = Tablas::posicion[(unsigned char)in];
+        if (x < 0 || cantidad == 0) return in;
+        
+        if (pasoPorCarga) pasoUnico();
+        if (vencido > 0) recalcularTramos();
+        
+        int p = posiciones[0];
+        if (conReflector) x = adelante[0][p][x];
+        return (char)('A' + atras[0][p][tramos[1][x]]);
+    }
+    
+    /**
+     * @brief Descifra una corrida de caracteres, como `descifrar` carácter por carácter.
+     * @param entrada Caracteres cifrados.
+     * @param salida Destino de los caracteres descifrados (puede ser igual a `entrada`).
+     * @param largo Cantidad de caracteres.
+     */
+    void descifrarCorrida(const char* entrada, char* salida, size_t largo) {
+        PRT7_CONTAR(caracteresEnLote, largo);
+        for (size_t i = 0; i < largo; i++) {
+            salida[i] = descifrar(entrada[i]);
+        }
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de rotores.
+     * @return Rotores de la cascada (0 si no está configurada).
+     */
+    int getCantidad() const {
+        return cantidad;
+    }
+    
+    /**
+     * @brief Obtiene la posición de un rotor.
+     * @param rotor Índice del rotor.
+     * @return Posición de 0 a 25 (0 = 'A').
+     */
+    int getPosicion(int rotor) const {
+        return posiciones[rotor];
+    }
+    
+    /**
+     * @brief Indica si la cascada tiene reflector.
+     * @return true si la señal vuelve por los rotores.
+     */
+    bool tieneReflector() const {
+        return conReflector;
+    }
+    
+    /**
+     * @brief Obtiene cuántas tablas de tramo se recalcularon.
+     * @return Tramos recalculados desde la construcción.
+     */
+    long getRecalculos() const {
+        return recalculos;
+    }
+};
+
+#endif // PRT7_CASCADA_H
@@ -0,0 +1,228 @@
+/**
+ * @file prt7/cola_spsc.h
+ * @brief Cola circular sin bloqueos de un productor y un consumidor.
+ */
+
+#ifndef PRT7_COLA_SPSC_H
+#define PRT7_COLA_SPSC_H
+
+#include <atomic>       // Para std::atomic
+#include <cstddef>      // Para size_t
+#include <thread>       // Para std::this_thread::yield()
+#include <unistd.h>     // Para usleep()
+
+/**
+ * @class EsperaEscalonada
+ * @brief Espera activa corta que pasa a dormir cada vez más mientras la condición no cambia.
+ *
+ * Los primeros intentos solo ceden el procesador; luego duerme de 50 µs a 2 ms,
+ * para no consumir CPU cuando el puerto está inactivo.
+ */
+class EsperaEscalonada {
+private:
+    int intentos; ///< Intentos fallidos consecutivos.
+    
+public:
+    /**
+     * @brief Constructor.
+     */
+    EsperaEscalonada() : intentos(0) {}
+    
+    /**
+     * @brief Espera un intervalo acorde a la cantidad de intentos previos.
+     */
+    void esperar() {
+        if (intentos < 64) {
+            std::this_thread::yield();
+        } else {
+            int paso = intentos - 64;
+            usleep(paso < 6 ? 50u << paso : 2000u);
+        }
+        intentos++;
+    }
+};
+
+/**
+ * @class ColaSPSC
+ * @brief Cola circular de capacidad fija para un productor y un consumidor, sin bloqueos.
+ *
+ * Cada lado escribe solo su índice (`escritura` el productor, `lectura` el
+ * consumidor); el consumidor guarda una copia de `escritura` para no leer la
+ * variable compartida en cada elemento. Los elementos se construyen en su
+ * lugar: `reservar` + `publicar` para producir, `frente` + `liberar` para
+ * consumir, sin copias intermedias.
+ * @tparam T Tipo de los elementos.
+ * @tparam N Capacidad; debe ser potencia de 2.
+ */
+template <typename T, size_t N>
+class ColaSPSC {
+    static_assert(N >= 2 && (N & (N - 1)) == 0, "La capacidad de ColaSPSC debe ser potencia de 2");
+    
+private:
+    static const size_t LINEA_CACHE = 64;
+    
+    T* ranuras;                                    ///< Almacenamiento de los elementos.
+    char relleno0[LINEA_CACHE];
+    
+    // Lado del productor
+    std::atomic<size_t> escritura;                      ///< Próxima posición a publicar.
+    size_t lecturaVista;                           ///< Última `lectura` observada por el productor.
+    size_t profundidadMaxima;                      ///< Mayor cantidad de elementos en la cola.
+    long esperasLlena;                             ///< Veces que el productor esperó espacio.
+    char relleno1[LINEA_CACHE];
+    
+    // Lado del consumidor
+    std::atomic<size_t> lectura;                        ///< Próxima posición a consumir.
+    size_t escrituraVista;                         ///< Última `escritura` observada por el consumidor.
+    long esperasVacia;                             ///< Veces que el consumidor esperó datos.
+    char relleno2[LINEA_CACHE];
+    
+    std::atomic<bool> cerrada;                          ///< El productor no publicará más elementos.
+    
+public:
+    /**
+     * @brief Constructor. Reserva las N ranuras.
+     */
+    ColaSPSC() : ranuras(new T[N]), escritura(0), lecturaVista(0), profundidadMaxima(0),
+                 esperasLlena(0), lectura(0), escrituraVista(0), esperasVacia(0), cerrada(false) {}
+    
+    /**
+     * @brief Destructor. Libera las ranuras.
+     */
+    ~ColaSPSC() {
+        delete[] ranuras;
+    }
+    
+    ColaSPSC(const ColaSPSC&) = delete;
+    ColaSPSC& operator=(const ColaSPSC&) = delete;
+    
+    /**
+     * @brief (Productor) Obtiene la próxima ranura libre sin publicarla.
+     * @return La ranura, o nullptr si la cola está llena.
+     */
+    T* reservar() {
+        size_t posicion = escritura.load(std::memory_order_relaxed);
+        if (posicion - lecturaVista == N) {
+            lecturaVista = lectura.load(std::memory_order_acquire);
+            if (posicion - lecturaVista == N) return nullptr;
+        }
+        return &ranuras[posicion & (N - 1)];
+    }
+    
+    /**
+     * @brief (Productor) Espera hasta obtener una ranura libre (contrapresión).
+     * @return La ranura reservada.
+     */
+    T* reservarEsperando() {
+        T* ranura = reservar();
+        if (ranura != nullptr) return ranura;
+        
+        esperasLlena++;
+        EsperaEscalonada espera;
+        while ((ranura = reservar()) == nullptr) {
+            espera.esperar();
+        }
+        return ranura;
+    }
+    
+    /**
+     * @brief (Productor) Hace visible al consumidor la ranura obtenida con `reservar`.
+     */
+    void publicar() {
+        size_t posicion = escritura.load(std::memory_order_relaxed) + 1;
+        escritura.store(posicion, std::memory_order_release);
+        
+        lecturaVista = lectura.load(std::memory_order_acquire);
+        size_t profundidad = posicion - lecturaVista;
+        if (profundidad > profundidadMaxima) profundidadMaxima = profundidad;
+    }
+    
+    /**
+     * @brief (Productor) Indica que no se publicarán más elementos.
+     */
+    void cerrar() {
+        cerrada.store(true, std::memory_order_release);
+    }
+    
+    /**
+     * @brief (Consumidor) Obtiene el elemento más antiguo sin quitarlo.
+     * @return El elemento, o nullptr si la cola está vacía.
+     */
+    T* frente() {
+        size_t posicion = lectura.load(std::memory_order_relaxed);
+        if (posicion == escrituraVista) {
+            escrituraVista = escritura.load(std::memory_order_acquire);
+            if (posicion == escrituraVista) return nullptr;
+        }
+        return &ranuras[posicion & (N - 1)];
+    }
+    
+    /**
+     * @brief (Consumidor) Espera el próximo elemento.
+     * @return El elemento, o nullptr si la cola quedó vacía y cerrada.
+     */
+    T* frenteEsperando() {
+        T* elemento = frente();
+        if (elemento != nullptr) return elemento;
+        
+        esperasVacia++;
+        EsperaEscalonada espera;
+        while ((elemento = frente()) == nullptr) {
+            // Lo publicado antes de cerrar es visible al ver la cola cerrada
+            if (cerrada.load(std::memory_order_acquire)) {
+                return frente();
+            }
+            espera.esperar();
+        }
+        return elemento;
+    }
+    
+    /**
+     * @brief (Consumidor) Quita el elemento obtenido con `frente`.
+     */
+    void liberar() {
+        lectura.store(lectura.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+    
+    /**
+     * @brief Obtiene la capacidad de la cola.
+     * @return N.
+     */
+    size_t getCapacidad() const {
+        return N;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad aproximada de elementos en la cola.
+     * @return Elementos publicados y aún no liberados.
+     */
+    size_t getProfundidad() const {
+        return escritura.load(std::memory_order_acquire) - lectura.load(std::memory_order_acquire);
+    }
+    
+    /**
+     * @brief Obtiene la mayor profundidad observada por el productor.
+     * @return Máximo de elementos en cola (leer después de detener al productor).
+     */
+    size_t getProfundidadMaxima() const {
+        return profundidadMaxima;
+    }
+    
+    /**
+     * @brief Obtiene cuántas veces el productor esperó por falta de espacio.
+     * @return Esperas por cola llena.
+     */
+    long getEsperasLlena() const {
+        return esperasLlena;
+    }
+    
+    /**
+     * @brief Obtiene cuántas veces el consumidor esperó por falta de datos.
+     * @return Esperas por cola vacía.
+     */
+    long getEsperasVacia() const {
+        return esperasVacia;
+    }
+};
+
+#endif // PRT7_COLA_SPSC_H
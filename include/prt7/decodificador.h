@@ -0,0 +1,691 @@
+/**
+ * @file prt7/decodificador.h
+ * @brief Decodificador de tramas: por línea, en lote y en paralelo.
+ */
+
+#ifndef PRT7_DECODIFICADOR_H
+#define PRT7_DECODIFICADOR_H
+
+#include <cstddef>      // Para size_t
+#include <cstring>      // Para memcpy()
+#include <thread>       // Para std::thread
+
+#include "prt7/cascada.h"
+#include "prt7/instantanea.h"
+#include "prt7/lista_de_carga.h"
+#include "prt7/parser.h"
+#include "prt7/rotor.h"
+#include "prt7/salida.h"
+#include "prt7/tramas.h"
+
+/**
+ * @class Decodificador
+ * @brief Aplica los registros de trama sobre una lista de carga y un rotor.
+ *
+ * Es el paso común de todas las fuentes (línea por línea o en lote): coloca
+ * cada trama en su ranura reutilizable, llama a `procesar` de forma
+ * polimórfica, lleva la cuenta de tramas y escribe la traza si está activa.
+ * Opcionalmente avisa cada tramo de caracteres decodificados a una función
+ * (ver `setAlDecodificar`); en ese caso la lista de carga puede ser nullptr.
+ *
+ * Con una cascada de rotores (ver `setCascada`) las cargas se descifran con
+ * la cascada y las tramas MAP rotan uno de sus rotores ("Mk,N") o la
+ * avanzan ("MP,N"). Sin cascada esas variantes cuentan como mal formadas,
+ * igual que una "Mk,N" con k fuera de la cascada.
+ *
+ * Con una instantánea (ver `setInstantanea`) el estado se publica para otros
+ * hilos después de cada trama, lote o corrida.
+ */
+class Decodificador {
+private:
+    /**
+     * @struct TramoParalelo
+     * @brief Parte del texto asignada a un hilo en `procesarEnParalelo`, con sus resultados.
+     */
+    struct TramoParalelo {
+        const char* datos;           ///< Inicio del tramo.
+        size_t tamano;               ///< Bytes del tramo.
+        int neta;                    ///< Rotación neta de los MAP del tramo (módulo 26).
+        bool llegoAlFin;             ///< true si el tramo contiene "FIN".
+        bool llegoABinario;          ///< true si el tramo contiene "BIN" (el tramo termina ahí).
+        int desplazamientoInicial;   ///< Posición del rotor al comenzar el tramo.
+        ListaDeCarga carga;          ///< Mensaje decodificado del tramo.
+        long tramasCarga;            ///< Tramas LOAD del tramo.
+        long tramasMapeo;            ///< Tramas MAP del tramo.
+        long tramasMalFormadas;      ///< Líneas mal formadas del tramo.
+        long tramasDescartadas;      ///< Tramas descartadas del tramo.
+        long tramasReparadas;        ///< Tramas reparadas del tramo.
+        long long rotacionMaxima;    ///< Mayor |N| de las tramas MAP del tramo.
+        
+        /**
+         * @brief Constructor. Crea un tramo vacío.
+         */
+        TramoParalelo() : datos(nullptr), tamano(0), neta(0), llegoAlFin(false), llegoABinario(false),
+                          desplazamientoInicial(0), tramasCarga(0), tramasMapeo(0),
+                          tramasMalFormadas(0), tramasDescartadas(0), tramasReparadas(0),
+                          rotacionMaxima(0) {}
+    };
+    
+    /**
+     * @brief Primera pasada de un hilo: rotación neta del tramo y si contiene "FIN" o "BIN".
+     *
+     * Si contiene "BIN" el tramo se acorta hasta ese marcador inclusive: lo
+     * que sigue son tramas binarias, que no se tokenizan como texto.
+     * @param tramo Tramo a medir.
+     */
+    static void medirTramo(TramoParalelo* tramo) {
+        const size_t TAM_LOTE = 1024;
+        RegistroTrama lote[TAM_LOTE];
+        size_t posicion = 0;
+        int neta = 0;
+        
+        while (posicion < tramo->tamano && !tramo->llegoAlFin && !tramo->llegoABinario) {
+            size_t consumidos;
+            size_t cantidad = tokenizarBloque(tramo->datos + posicion, tramo->tamano - posicion,
+                                              true, lote, TAM_LOTE, &consumidos);
+            if (cantidad == 0) break;
+            
+            for (size_t i = 0; i < cantidad; i++) {
+                if (lote[i].tipo == TRAMA_MAP && lote[i].rotor == 0) {
+                    neta = (neta + lote[i].rotacion % RotorDeMapeo::LONGITUD) % RotorDeMapeo::LONGITUD;
+                } else if (lote[i].tipo == TRAMA_FIN) {
+                    tramo->llegoAlFin = true;
+                } else if (lote[i].tipo == TRAMA_BINARIO) {
+                    tramo->llegoABinario = true;
+                }
+            }
+            posicion += consumidos;
+        }
+        if (tramo->llegoABinario) tramo->tamano = posicion;
+        tramo->neta = (neta + RotorDeMapeo::LONGITUD) % RotorDeMapeo::LONGITUD;
+    }
+    
+    /**
+     * @brief Segunda pasada de un hilo: decodifica el tramo desde su rotación inicial.
+     * @param tramo Tramo a decodificar.
+     */
+    static void decodificarTramo(TramoParalelo* tramo) {
+        RotorDeMapeo rotor;
+        rotor.rotar(tramo->desplazamientoInicial);
+        Decodificador parcial(&tramo->carga, &rotor);
+        
+        size_t posicion = 0;
+        bool continuar = true;
+        while (continuar && posicion < tramo->tamano) {
+            size_t consumidos;
+            continuar = parcial.procesarTexto(tramo->datos + posicion, tramo->tamano - posicion, &consumidos);
+            if (consumidos == 0) break;
+            posicion += consumidos;
+        }
+        
+        tramo->tramasCarga = parcial.tramasCarga;
+        tramo->tramasMapeo = parcial.tramasMapeo;
+        tramo->tramasMalFormadas = parcial.tramasMalFormadas;
+        tramo->tramasDescartadas = parcial.tramasDescartadas;
+        tramo->tramasReparadas = parcial.tramasReparadas;
+        tramo->rotacionMaxima = parcial.rotacionMaxima;
+    }
+    
+    /**
+     * @brief Ejecuta una función sobre cada tramo, un hilo por tramo (el primero en el hilo actual).
+     * @param funcion Función a ejecutar.
+     * @param tramos Arreglo de tramos.
+     * @param cantidad Cantidad de tramos.
+     */
+    static void ejecutarEnHilos(void (*funcion)(TramoParalelo*), TramoParalelo* tramos, int cantidad) {
+        std::thread* trabajadores = new std::thread[cantidad > 1 ? cantidad - 1 : 1];
+        for (int k = 1; k < cantidad; k++) {
+            trabajadores[k - 1] = std::thread(funcion, &tramos[k]);
+        }
+        if (cantidad > 0) {
+            funcion(&tramos[0]);
+        }
+        for (int k = 1; k < cantidad; k++) {
+            trabajadores[k - 1].join();
+        }
+        delete[] trabajadores;
+    }
+    
+    ListaDeCarga* carga;     ///< Lista donde se acumula el mensaje.
+    RotorDeMapeo* rotor;     ///< Rotor con el que se decodifica.
+    CascadaDeRotores* cascada; ///< Cascada que reemplaza al rotor (o nullptr).
+    RanurasDeTrama ranuras;  ///< Objetos de trama reutilizables.
+    long tramasCarga;        ///< Tramas LOAD procesadas.
+    long tramasMapeo;        ///< Tramas MAP procesadas.
+    long tramasMalFormadas;  ///< Líneas descartadas por estar mal formadas.
+    long tramasDescartadas;  ///< Tramas descartadas por el entramado (checksum, longitud, binarias inválidas).
+    long tramasReparadas;    ///< Tramas aceptadas después de quitarles ruido.
+    long long rotacionMaxima; ///< Mayor |N| de las tramas MAP aplicadas.
+    bool finRecibido;        ///< Se procesó el marcador "FIN".
+    void (*alDecodificar)(void*, const char*, size_t); ///< Aviso de caracteres decodificados (o nullptr).
+    void* contextoDecodificado;                         ///< Argumento para `alDecodificar`.
+    InstantaneaDeEstado* instantanea;                   ///< Estado publicado para otros hilos (o nullptr).
+    
+    /**
+     * @brief Entrega caracteres decodificados a `alDecodificar` y a la instantánea.
+     * @param datos Caracteres decodificados.
+     * @param largo Cantidad de caracteres.
+     */
+    void avisarDecodificados(const char* datos, size_t largo) {
+        if (alDecodificar != nullptr) alDecodificar(contextoDecodificado, datos, largo);
+        if (instantanea != nullptr) instantanea->agregar(datos, largo);
+    }
+    
+    /**
+     * @brief Registra la magnitud de una rotación aplicada, para `getRotacionMaxima`.
+     * @param rotacion Valor N de la trama MAP.
+     */
+    void registrarRotacion(int rotacion) {
+        long long magnitud = rotacion < 0 ? -(long long)rotacion : (long long)rotacion;
+        if (magnitud > rotacionMaxima) rotacionMaxima = magnitud;
+    }
+    
+    /**
+     * @brief Publica el rotor y los conteos en la instantánea, si hay una.
+     */
+    void publicarInstantanea() {
+        if (instantanea == nullptr) return;
+        int desplazamiento = cascada != nullptr ? cascada->getPosicion(0) : rotor->getDesplazamiento();
+        instantanea->publicar(desplazamiento, tramasCarga, tramasMapeo, tramasMalFormadas, tramasDescartadas);
+    }
+    
+    /**
+     * @brief Decodifica en el lugar una corrida de caracteres cifrados y la entrega.
+     * @param corrida Caracteres cifrados; al volver contienen los decodificados.
+     * @param largo Cantidad de caracteres.
+     */
+    void entregarCorrida(char* corrida, size_t largo) {
+        if (cascada != nullptr) {
+            cascada->descifrarCorrida(corrida, corrida, largo);
+        } else {
+            decodificarCorrida(corrida, corrida, largo, *rotor);
+        }
+        if (carga != nullptr) carga->insertarBloque(corrida, largo);
+        avisarDecodificados(corrida, largo);
+        PRT7_LATENCIA_RECEPCION();
+    }
+    
+    /**
+     * @brief Indica si una trama MAP se puede aplicar: "M,N" siempre, sus variantes solo con una cascada que las admita.
+     * @param registro Trama MAP.
+     * @return false si la trama cuenta como mal formada.
+     */
+    bool esMapeoAplicable(const RegistroTrama& registro) const {
+        if (cascada == nullptr) return registro.rotor == 0;
+        return registro.rotor == TramaMap::ROTOR_PASOS || registro.rotor < cascada->getCantidad();
+    }
+    
+    /**
+     * @brief Aplica una trama MAP aplicable a la cascada.
+     * @param registro Trama MAP.
+     */
+    void aplicarEnCascada(const RegistroTrama& registro) {
+        if (registro.rotor == TramaMap::ROTOR_PASOS) {
+            cascada->avanzar(registro.rotacion);
+        } else {
+            cascada->rotar(registro.rotor, registro.rotacion);
+        }
+    }
+    
+public:
+    /**
+     * @brief Constructor.
+     * @param c Lista de carga de destino (nullptr para no acumular el mensaje, sin traza).
+     * @param r Rotor de mapeo.
+     */
+    Decodificador(ListaDeCarga* c, RotorDeMapeo* r)
+        : carga(c), rotor(r), cascada(nullptr), tramasCarga(0), tramasMapeo(0), tramasMalFormadas(0),
+          tramasDescartadas(0), tramasReparadas(0), rotacionMaxima(0), finRecibido(false),
+          alDecodificar(nullptr), contextoDecodificado(nullptr), instantanea(nullptr) {}
+    
+    /**
+     * @brief Registra una función que recibe los caracteres a medida que se decodifican.
+     *
+     * Se llama una vez por trama LOAD en `procesar` y una vez por corrida de
+     * LOAD en `procesarLote`, en el orden del mensaje. `procesarEnParalelo` no
+     * la usa.
+     * @param funcion Recibe el contexto, los caracteres decodificados y su cantidad (nullptr para ninguna).
+     * @param contexto Argumento que se pasa a `funcion`.
+     */
+    void setAlDecodificar(void (*funcion)(void*, const char*, size_t), void* contexto) {
+        alDecodificar = funcion;
+        contextoDecodificado = contexto;
+    }
+    
+    /**
+     * @brief Publica el estado en una instantánea que otros hilos leen sin bloqueos.
+     *
+     * Se publica después de cada trama en `procesar`, de cada lote en
+     * `procesarLote`, de cada corrida o rotación y al reemplazar los conteos.
+     * En `procesarEnParalelo` se publica al final y solo los conteos y el
+     * rotor (los caracteres recientes no cambian).
+     * @param i Instantánea (nullptr para dejar de publicar).
+     */
+    void setInstantanea(InstantaneaDeEstado* i) {
+        instantanea = i;
+        publicarInstantanea();
+    }
+    
+    /**
+     * @brief Descifra con una cascada de rotores en lugar del rotor.
+     *
+     * El rotor dado al constructor deja de usarse. `procesarEnParalelo`
+     * decodifica entonces en un solo hilo: el avance de la cascada depende de
+     * todas las cargas anteriores, no de una suma de rotaciones.
+     * @param c Cascada configurada (nullptr para volver al rotor).
+     */
+    void setCascada(CascadaDeRotores* c) {
+        cascada = c;
+    }
+    
+    /**
+     * @brief Procesa un registro de trama.
+     * @param registro La trama clasificada.
+     * @param linea Texto original de la línea, para la traza (puede ser nullptr si no hay traza).
+     * @param longitud Cantidad de caracteres de `linea`.
+     * @return false si el registro es el marcador "FIN", true en caso contrario.
+     */
+    bool procesar(const RegistroTrama& registro, const char* linea, int longitud) {
+        PRT7_CRONOMETRAR(procesado);
+        SalidaBufferizada* traza = linea != nullptr ? salidaTraza : nullptr;
+        
+        // Señales especiales (I para Inicio, FIN para Final)
+        if (registro.tipo == TRAMA_INICIO) {
+            if (traza) traza->escribir("--- Inicio de transmision ---\n\n");
+            return true;
+        }
+        if (registro.tipo == TRAMA_FIN) {
+            if (traza) traza->escribir("\n--- Fin de transmision ---\n");
+            finRecibido = true;
+            return false;
+        }
+        if (registro.tipo == TRAMA_BINARIO) {
+            if (traza) traza->escribir("--- Modo binario: el resto se decodifica sin traza por trama ---\n");
+            return true;
+        }
+        
+        // Mostrar trama recibida
+        if (traza) {
+            traza->escribir("Trama: [");
+            traza->escribir(linea, longitud);
+            traza->escribir("] -> ");
+        }
+        
+        if (registro.tipo == TRAMA_MAL_FORMADA ||
+            (registro.tipo == TRAMA_MAP && !esMapeoAplicable(registro))) {
+            tramasMalFormadas++;
+            if (traza) traza->escribir("ERROR: Trama mal formada\n");
+            publicarInstantanea();
+            return true;
+        }
+        if (registro.tipo == TRAMA_DESCARTADA) {
+            tramasDescartadas++;
+            if (traza) traza->escribir("ERROR: Trama descartada (checksum incorrecto o linea demasiado larga)\n");
+            publicarInstantanea();
+            return true;
+        }
+        
+        if (registro.tipo == TRAMA_LOAD) {
+            tramasCarga++;
+        } else {
+            tramasMapeo++;
+            registrarRotacion(registro.rotacion);
+        }
+        if (registro.reparada) {
+            tramasReparadas++;
+            if (traza) traza->escribir("(reparada) ");
+        }
+        
+        if (cascada != nullptr) {
+            // La cascada puede avanzar al descifrar: el carácter se descifra una sola vez
+            ranuras.asignar(registro)->procesar(carga, cascada);
+            if (registro.tipo == TRAMA_LOAD) {
+                char decodificado = ranuras.getDecodificado();
+                avisarDecodificados(&decodificado, 1);
+            }
+            if (traza) traza->escribirCaracter('\n');
+            publicarInstantanea();
+            return true;
+        }
+        
+        if ((alDecodificar != nullptr || instantanea != nullptr) && registro.tipo == TRAMA_LOAD) {
+            char decodificado = rotor->getMapeo(registro.caracter);
+            avisarDecodificados(&decodificado, 1);
+        }
+        
+        // Procesar (polimorfismo)
+        if (carga != nullptr || registro.tipo == TRAMA_MAP) {
+            ranuras.asignar(registro)->procesar(carga, rotor);
+        }
+        
+        if (traza) traza->escribirCaracter('\n');
+        publicarInstantanea();
+        return true;
+    }
+    
+    /**
+     * @brief Procesa en lote un arreglo de registros, sin traza.
+     *
+     * Las corridas de tramas MAP consecutivas se pliegan en una sola rotación
+     * neta (módulo 26) y las corridas de tramas LOAD se decodifican juntas con
+     * `decodificarCorrida` y se agregan con `insertarBloque`. El mensaje, el
+     * estado del rotor y los conteos quedan iguales que procesando trama por
+     * trama.
+     * @param registros Tramas clasificadas.
+     * @param cantidad Cantidad de registros.
+     * @return false si se encontró el marcador "FIN" (los registros posteriores no se procesan).
+     */
+    bool procesarLote(const RegistroTrama* registros, size_t cantidad) {
+        const size_t TAM_CORRIDA = 1024;
+        char corrida[TAM_CORRIDA];
+        size_t i = 0;
+        
+        while (i < cantidad) {
+            TipoTrama tipo = registros[i].tipo;
+            
+            if (tipo == TRAMA_MAP && esMapeoAplicable(registros[i])) {
+                if (cascada != nullptr) {
+                    // La cascada recalcula sus tramos recién en la carga siguiente
+                    for (; i < cantidad && registros[i].tipo == TRAMA_MAP && esMapeoAplicable(registros[i]);
+                         i++) {
+                        aplicarEnCascada(registros[i]);
+                        registrarRotacion(registros[i].rotacion);
+                        tramasMapeo++;
+                        tramasReparadas += registros[i].reparada;
+                    }
+                    continue;
+                }
+                int neta = 0;
+                for (; i < cantidad && registros[i].tipo == TRAMA_MAP && registros[i].rotor == 0; i++) {
+                    neta = (neta + registros[i].rotacion % RotorDeMapeo::LONGITUD) %
+                           RotorDeMapeo::LONGITUD;
+                    registrarRotacion(registros[i].rotacion);
+                    tramasMapeo++;
+                    tramasReparadas += registros[i].reparada;
+                }
+                rotor->rotar(neta);
+            } else if (tipo == TRAMA_LOAD) {
+                size_t largo = 0;
+                for (; i < cantidad && registros[i].tipo == TRAMA_LOAD && largo < TAM_CORRIDA; i++) {
+                    corrida[largo++] = registros[i].caracter;
+                    tramasReparadas += registros[i].reparada;
+                }
+                tramasCarga += (long)largo;
+                entregarCorrida(corrida, largo);
+            } else if (tipo == TRAMA_FIN) {
+                finRecibido = true;
+                publicarInstantanea();
+                return false;
+            } else {
+                if (tipo == TRAMA_MAL_FORMADA || tipo == TRAMA_MAP) {
+                    tramasMalFormadas++;
+                } else if (tipo == TRAMA_DESCARTADA) {
+                    tramasDescartadas++;
+                }
+                i++;
+            }
+        }
+        publicarInstantanea();
+        return true;
+    }
+    
+    /**
+     * @brief Procesa una corrida de caracteres cifrados (e.g., una trama binaria de carga).
+     *
+     * Equivale a una trama LOAD por carácter: cada uno cuenta en `getTramasCarga`.
+     * @param cifrados Caracteres cifrados.
+     * @param largo Cantidad de caracteres.
+     */
+    void procesarCorrida(const char* cifrados, size_t largo) {
+        const size_t TAM_CORRIDA = 1024;
+        char corrida[TAM_CORRIDA];
+        
+        while (largo > 0) {
+            size_t parte = largo < TAM_CORRIDA ? largo : TAM_CORRIDA;
+            memcpy(corrida, cifrados, parte);
+            tramasCarga += (long)parte;
+            entregarCorrida(corrida, parte);
+            cifrados += parte;
+            largo -= parte;
+        }
+        publicarInstantanea();
+    }
+    
+    /**
+     * @brief Procesa una rotación (e.g., una trama binaria de mapeo); equivale a una trama MAP.
+     *
+     * Con una cascada rota su rotor 0, como "M,N".
+     * @param rotacion Valor de rotación.
+     */
+    void procesarRotacion(int rotacion) {
+        tramasMapeo++;
+        registrarRotacion(rotacion);
+        if (cascada != nullptr) {
+            cascada->rotar(0, rotacion);
+        } else {
+            rotor->rotar(rotacion);
+        }
+        publicarInstantanea();
+    }
+    
+    /**
+     * @brief Cuenta una trama descartada que no llegó como línea (e.g., una trama binaria inválida).
+     */
+    void contarDescartada() {
+        tramasDescartadas++;
+        publicarInstantanea();
+    }
+    
+    /**
+     * @brief Reemplaza los conteos de tramas (e.g., al reanudar una sesión desde una bitácora).
+     * @param carga Tramas LOAD.
+     * @param mapeo Tramas MAP.
+     * @param malFormadas Líneas mal formadas.
+     * @param descartadas Tramas descartadas por el entramado.
+     * @param reparadas Tramas reparadas.
+     */
+    void setConteos(long carga, long mapeo, long malFormadas, long descartadas, long reparadas) {
+        tramasCarga = carga;
+        tramasMapeo = mapeo;
+        tramasMalFormadas = malFormadas;
+        tramasDescartadas = descartadas;
+        tramasReparadas = reparadas;
+        publicarInstantanea();
+    }
+    
+    /**
+     * @brief Tokeniza y procesa en lote el siguiente tramo de un texto de tramas.
+     * @param datos Inicio del texto.
+     * @param tamano Cantidad de bytes del texto (se considera que termina los datos).
+     * @param consumidos Recibe cuántos bytes se procesaron (0 si ya no queda nada).
+     * @param binario Recibe true si el tramo terminó en el marcador "BIN": lo que
+     *                sigue son tramas binarias (ver DecodificadorContinuo). Puede ser nullptr.
+     * @return false si se encontró el marcador "FIN".
+     */
+    bool procesarTexto(const char* datos, size_t tamano, size_t* consumidos, bool* binario = nullptr) {
+        const size_t TAM_LOTE = 1024;
+        RegistroTrama lote[TAM_LOTE];
+        
+        size_t cantidad = tokenizarBloque(datos, tamano, true, lote, TAM_LOTE, consumidos);
+        if (binario != nullptr) *binario = cantidad > 0 && lote[cantidad - 1].tipo == TRAMA_BINARIO;
+        return procesarLote(lote, cantidad);
+    }
+    
+    /**
+     * @brief Decodifica en paralelo un texto de tramas completo (e.g., una captura mapeada).
+     *
+     * El valor de cada LOAD depende solo de la suma módulo 26 de los MAP
+     * anteriores. Por eso el texto se divide en tramos en límites de línea y:
+     * 1. cada hilo tokeniza su tramo y calcula su rotación neta;
+     * 2. un recorrido de prefijos (exclusivo) da la rotación inicial de cada
+     *    tramo y descarta los tramos posteriores al primer "FIN";
+     * 3. cada hilo decodifica su tramo en su propia ListaDeCarga con un rotor
+     *    ya rotado a esa posición;
+     * 4. los segmentos se concatenan en orden en tiempo constante.
+     * El mensaje, el rotor y los conteos quedan iguales que con el camino secuencial.
+     * Con una cascada (ver `setCascada`) el texto se decodifica en este hilo.
+     *
+     * El texto termina en el primer "BIN": lo que sigue son tramas binarias,
+     * que quien llama debe seguir con DecodificadorContinuo::iniciarModoBinario.
+     * @param datos Inicio del texto.
+     * @param tamano Cantidad de bytes.
+     * @param hilos Cantidad de hilos (y de tramos) a usar.
+     * @param consumidos Recibe los bytes procesados: hasta "BIN" inclusive si lo hay. Puede ser nullptr.
+     * @param binario Recibe true si el texto terminó en "BIN". Puede ser nullptr.
+     * @return false si se encontró el marcador "FIN".
+     */
+    bool procesarEnParalelo(const char* datos, size_t tamano, int hilos,
+                            size_t* consumidos = nullptr, bool* binario = nullptr) {
+        if (cascada != nullptr) {
+            // Sin rotación neta por tramo: se decodifica en este hilo
+            size_t posicion = 0;
+            bool continuar = true;
+            bool llegoABinario = false;
+            while (continuar && !llegoABinario && posicion < tamano) {
+                size_t parte;
+                continuar = procesarTexto(datos + posicion, tamano - posicion, &parte, &llegoABinario);
+                if (parte == 0) break;
+                posicion += parte;
+            }
+            if (consumidos != nullptr) *consumidos = continuar ? posicion : tamano;
+            if (binario != nullptr) *binario = continuar && llegoABinario;
+            return continuar;
+        }
+        if (hilos < 1) hilos = 1;
+        TramoParalelo* tramos = new TramoParalelo[hilos];
+        
+        // Cortar en tramos de tamaño parecido, justo después de un terminador
+        size_t inicio = 0;
+        for (int k = 0; k < hilos; k++) {
+            size_t fin = (k == hilos - 1) ? tamano : tamano / hilos * (k + 1);
+            if (fin < inicio) fin = inicio;
+            while (fin < tamano && fin > 0 && datos[fin - 1] != '\n' && datos[fin - 1] != '\r') {
+                fin++;
+            }
+            tramos[k].datos = datos + inicio;
+            tramos[k].tamano = fin - inicio;
+            inicio = fin;
+        }
+        
+        ejecutarEnHilos(medirTramo, tramos, hilos);
+        
+        // Recorrido de prefijos sobre las rotaciones netas
+        int acumulada = rotor->getDesplazamiento();
+        int activos = hilos;
+        for (int k = 0; k < hilos; k++) {
+            tramos[k].desplazamientoInicial = acumulada;
+            acumulada = (acumulada + tramos[k].neta) % RotorDeMapeo::LONGITUD;
+            if (tramos[k].llegoAlFin || tramos[k].llegoABinario) {
+                activos = k + 1;
+                break;
+            }
+        }
+        
+        ejecutarEnHilos(decodificarTramo, tramos, activos);
+        
+        bool llegoAlFin = false;
+        size_t procesados = 0;
+        for (int k = 0; k < activos; k++) {
+            procesados += tramos[k].tamano;
+            if (carga != nullptr) carga->concatenar(tramos[k].carga);
+            tramasCarga += tramos[k].tramasCarga;
+            tramasMapeo += tramos[k].tramasMapeo;
+            tramasMalFormadas += tramos[k].tramasMalFormadas;
+            tramasDescartadas += tramos[k].tramasDescartadas;
+            tramasReparadas += tramos[k].tramasReparadas;
+            if (tramos[k].rotacionMaxima > rotacionMaxima) rotacionMaxima = tramos[k].rotacionMaxima;
+            llegoAlFin = llegoAlFin || tramos[k].llegoAlFin;
+        }
+        finRecibido = finRecibido || llegoAlFin;
+        rotor->rotar(acumulada - rotor->getDesplazamiento());
+        publicarInstantanea();
+        
+        if (consumidos != nullptr) *consumidos = llegoAlFin ? tamano : procesados;
+        if (binario != nullptr) *binario = !llegoAlFin && tramos[activos - 1].llegoABinario;
+        
+        delete[] tramos;
+        return !llegoAlFin;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de tramas LOAD procesadas.
+     * @return Número de tramas de carga.
+     */
+    long getTramasCarga() const {
+        return tramasCarga;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de tramas MAP procesadas.
+     * @return Número de tramas de mapeo.
+     */
+    long getTramasMapeo() const {
+        return tramasMapeo;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de líneas mal formadas.
+     * @return Número de tramas descartadas.
+     */
+    long getTramasMalFormadas() const {
+        return tramasMalFormadas;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de tramas descartadas por el entramado.
+     * @return Tramas con checksum incorrecto, líneas demasiado largas y tramas binarias inválidas.
+     */
+    long getTramasDescartadas() const {
+        return tramasDescartadas;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de tramas aceptadas después de quitar ruido de sus extremos.
+     * @return Número de tramas reparadas (ya incluidas en las de carga o de mapeo).
+     */
+    long getTramasReparadas() const {
+        return tramasReparadas;
+    }
+    
+    /**
+     * @brief Obtiene la mayor magnitud de rotación recibida.
+     * @return El mayor |N| de las tramas MAP aplicadas (hasta 2147483648).
+     */
+    long long getRotacionMaxima() const {
+        return rotacionMaxima;
+    }
+    
+    /**
+     * @brief Indica si se procesó el marcador "FIN".
+     * @return true si la transmisión terminó con "FIN" (y no por fin de los datos).
+     */
+    bool getFinRecibido() const {
+        return finRecibido;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de tramas recibidas, que es el número de secuencia de la próxima.
+     * @return Tramas de carga, de mapeo, mal formadas y descartadas (las reparadas ya están incluidas).
+     */
+    long getSecuencia() const {
+        return tramasCarga + tramasMapeo + tramasMalFormadas + tramasDescartadas;
+    }
+    
+    /**
+     * @brief Obtiene el rotor con el que se decodifica.
+     * @return El rotor dado al constructor.
+     */
+    RotorDeMapeo* getRotor() const {
+        return rotor;
+    }
+    
+    /**
+     * @brief Obtiene la cascada con la que se descifra.
+     * @return La cascada de `setCascada`, o nullptr si se usa el rotor.
+     */
+    CascadaDeRotores* getCascada() const {
+        return cascada;
+    }
+};
+
+#endif // PRT7_DECODIFICADOR_H
@@ -0,0 +1,207 @@
+/**
+ * @file prt7/decodificador_continuo.h
+ * @brief API de flujo continuo: se entregan bytes a medida que llegan y se reciben los caracteres decodificados.
+ */
+
+#ifndef PRT7_DECODIFICADOR_CONTINUO_H
+#define PRT7_DECODIFICADOR_CONTINUO_H
+
+#include <cstddef>      // Para size_t
+
+#include "prt7/binario.h"
+#include "prt7/decodificador.h"
+#include "prt7/fuentes.h"
+
+/**
+ * @struct EstadoContinuo
+ * @brief Lo que un DecodificadorContinuo guarda entre trozos, para retomarlo en otro proceso.
+ *
+ * Fuera del modo binario solo puede haber una línea incompleta y en modo
+ * binario solo una trama incompleta, así que alcanza con un buffer.
+ */
+struct EstadoContinuo {
+    char pendiente[MAX_TRAMA_BINARIA]; ///< Línea o trama binaria incompleta.
+    size_t largo;                      ///< Bytes usados en `pendiente`.
+    bool binario;                      ///< Se está en modo binario.
+    bool descartando;                  ///< Se está saltando una línea demasiado larga.
+    bool resincronizando;              ///< Se busca la próxima sincronía binaria.
+    bool terminado;                    ///< Ya se procesó "FIN".
+};
+
+/**
+ * @class DecodificadorContinuo
+ * @brief Adapta un Decodificador para recibir bytes en trozos arbitrarios (`alimentar`).
+ *
+ * Los trozos no necesitan coincidir con las líneas: la línea incompleta al
+ * final de un trozo se guarda y se completa con el siguiente. Las líneas
+ * completas se tokenizan en lote directamente sobre los bytes recibidos, sin
+ * copiarlas, y se procesan con `Decodificador::procesarLote`. Las reglas son
+ * las de FuenteDeLineas (se saltan las líneas vacías y las de más de
+ * MAX_LINEA caracteres se descartan), así que el resultado es el mismo que
+ * leyendo línea por línea, sin importar cómo se corten los trozos.
+ *
+ * Después de la línea "BIN" los bytes se interpretan como tramas binarias
+ * (ver prt7/binario.h) hasta el primer byte que no sea de sincronía; una
+ * trama binaria cortada entre dos trozos también se guarda y se completa.
+ * Tras una trama binaria inválida se busca la siguiente sincronía que
+ * empiece una trama válida (o un '\n', que vuelve a modo texto), sin
+ * volver a mirar los bytes ya descartados.
+ *
+ * Uso típico desde otro programa:
+ * @code
+ *   RotorDeMapeo rotor;
+ *   Decodificador decodificador(nullptr, &rotor);          // sin acumular el mensaje
+ *   decodificador.setAlDecodificar(alRecibir, &servicio);  // caracteres decodificados
+ *   DecodificadorContinuo continuo(&decodificador);
+ *   while (recibir(&bytes, &cantidad) && continuo.alimentar(bytes, cantidad)) {}
+ *   continuo.finalizar();
+ * @endcode
+ */
+class DecodificadorContinuo {
+public:
+    static const size_t TAM_LOTE = 1024;  ///< Registros tokenizados por llamada a procesarLote.
+    
+private:
+    Decodificador* decodificador;                 ///< Decodificador que aplica las tramas.
+    char pendiente[FuenteDeLineas::MAX_LINEA + 1]; ///< Línea incompleta del final del último trozo.
+    size_t largoPendiente;                        ///< Bytes usados en `pendiente`.
+    bool descartando;                             ///< Se está saltando el resto de una línea demasiado larga.
+    bool terminado;                               ///< Ya se procesó "FIN".
+    bool binario;                                 ///< Se está en modo binario (después de "BIN").
+    bool resincronizando;                         ///< Tras una trama binaria inválida, se busca la próxima sincronía.
+    char pendienteBinario[MAX_TRAMA_BINARIA];     ///< Trama binaria incompleta del final del último trozo.
+    size_t largoBinario;                          ///< Bytes usados en `pendienteBinario`.
+    void (*alTerminar)(void*);                    ///< Aviso al procesar "FIN" (o nullptr).
+    void* contextoTerminar;                       ///< Argumento para `alTerminar`.
+    
+    /**
+     * @brief Procesa un arreglo de registros y registra si llegó "FIN".
+     * @param registros Tramas clasificadas.
+     * @param cantidad Cantidad de registros.
+     */
+    void procesarRegistros(const RegistroTrama* registros, size_t cantidad);
+    
+    /**
+     * @brief Clasifica y procesa una sola línea (ya separada de su terminador).
+     * @param linea Inicio de la línea.
+     * @param longitud Cantidad de caracteres (1 a MAX_LINEA, o MAX_LINEA + 1 si es demasiado larga).
+     */
+    void procesarLinea(const char* linea, size_t longitud);
+    
+    /**
+     * @brief Salta los bytes del resto de una línea demasiado larga, hasta su terminador inclusive.
+     * @param datos Bytes recibidos.
+     * @param cantidad Cantidad de bytes.
+     * @param posicion Posición actual (se avanza).
+     * @return true si se encontró el terminador (se dejó de descartar).
+     */
+    bool saltarLineaDescartada(const char* datos, size_t cantidad, size_t* posicion);
+    
+    /**
+     * @brief Procesa bytes en modo texto hasta su final o hasta la línea "BIN".
+     * @param datos Bytes recibidos.
+     * @param cantidad Cantidad de bytes.
+     * @return Bytes consumidos (menos que `cantidad` solo si se pasó a modo binario).
+     */
+    size_t alimentarTexto(const char* datos, size_t cantidad);
+    
+    /**
+     * @brief Procesa las tramas binarias completas al comienzo de un bloque.
+     * @param datos Bytes recibidos.
+     * @param cantidad Cantidad de bytes.
+     * @return Bytes consumidos; se detiene en una trama incompleta o al volver a modo texto.
+     */
+    size_t procesarTramasBinarias(const char* datos, size_t cantidad);
+    
+    /**
+     * @brief Procesa bytes en modo binario, guardando la trama incompleta del final.
+     * @param datos Bytes recibidos.
+     * @param cantidad Cantidad de bytes.
+     * @return Bytes consumidos (menos que `cantidad` solo si se volvió a modo texto).
+     */
+    size_t alimentarBinario(const char* datos, size_t cantidad);
+    
+public:
+    /**
+     * @brief Constructor.
+     * @param destino Decodificador que recibe las tramas (conserva el rotor, la carga y los conteos).
+     */
+    explicit DecodificadorContinuo(Decodificador* destino)
+        : decodificador(destino), largoPendiente(0), descartando(false), terminado(false), binario(false),
+          resincronizando(false), largoBinario(0), alTerminar(nullptr), contextoTerminar(nullptr) {}
+    
+    /**
+     * @brief Registra una función que se llama una vez al procesar el marcador "FIN".
+     * @param funcion Función a llamar (nullptr para ninguna).
+     * @param contexto Argumento que recibe la función.
+     */
+    void setAlTerminar(void (*funcion)(void*), void* contexto) {
+        alTerminar = funcion;
+        contextoTerminar = contexto;
+    }
+    
+    /**
+     * @brief Procesa un trozo de bytes recibidos.
+     * @param datos Bytes recibidos; basta con que sean válidos durante la llamada.
+     * @param cantidad Cantidad de bytes.
+     * @return false si ya se procesó "FIN" (los bytes posteriores se ignoran).
+     */
+    bool alimentar(const char* datos, size_t cantidad);
+    
+    /**
+     * @brief Indica el fin de los datos: procesa la última línea aunque no tenga terminador.
+     *
+     * Una trama binaria incompleta se cuenta como descartada.
+     * @return false si se procesó "FIN".
+     */
+    bool finalizar();
+    
+    /**
+     * @brief Indica si ya se procesó el marcador "FIN".
+     * @return true después de "FIN".
+     */
+    bool estaTerminado() const {
+        return terminado;
+    }
+    
+    /**
+     * @brief Pasa a modo binario, como si se hubiera recibido la línea "BIN".
+     *
+     * Sirve para continuar con esta API un flujo cuya parte de texto se leyó
+     * línea por línea (e.g., con traza) hasta encontrar "BIN".
+     */
+    void iniciarModoBinario() {
+        binario = true;
+    }
+    
+    /**
+     * @brief Indica si los próximos bytes se interpretan como tramas binarias.
+     * @return true entre "BIN" y el primer byte que no sea de sincronía.
+     */
+    bool enModoBinario() const {
+        return binario;
+    }
+    
+    /**
+     * @brief Copia el estado entre trozos (línea o trama incompleta y modo actual).
+     * @param estado Recibe el estado.
+     */
+    void guardarEstado(EstadoContinuo* estado) const;
+    
+    /**
+     * @brief Retoma un estado guardado con `guardarEstado`; los próximos bytes lo continúan.
+     * @param estado Estado a retomar.
+     * @return false si el estado no es coherente (e.g., una línea incompleta más larga que MAX_LINEA).
+     */
+    bool restaurarEstado(const EstadoContinuo& estado);
+    
+    /**
+     * @brief Obtiene el decodificador subyacente (rotor, carga y conteos).
+     * @return El decodificador dado al constructor.
+     */
+    Decodificador* getDecodificador() const {
+        return decodificador;
+    }
+};
+
+#endif // PRT7_DECODIFICADOR_CONTINUO_H
@@ -0,0 +1,42 @@
+/**
+ * @file prt7/escritura.h
+ * @brief Escritura completa (con reintentos) a un descriptor.
+ */
+
+#ifndef PRT7_ESCRITURA_H
+#define PRT7_ESCRITURA_H
+
+#include <cstddef>      // Para size_t
+#include <sys/uio.h>    // Para struct iovec
+
+/**
+ * @brief Escribe todos los bytes al descriptor, reintentando escrituras parciales.
+ * @param fd Descriptor de destino.
+ * @param datos Bytes a escribir.
+ * @param cantidad Cantidad de bytes.
+ * @return true si se escribió todo, false si hubo un error.
+ */
+bool escribirTodo(int fd, const char* datos, size_t cantidad);
+
+/**
+ * @brief Escribe todos los segmentos al descriptor con `writev()`, reintentando escrituras parciales.
+ * @param fd Descriptor de destino.
+ * @param segmentos Segmentos a escribir (se modifican si la escritura es parcial).
+ * @param cantidad Cantidad de segmentos.
+ * @return true si se escribió todo, false si hubo un error.
+ */
+bool escribirSegmentos(int fd, struct iovec* segmentos, int cantidad);
+
+/**
+ * @brief Como `escribirSegmentos`, pero para un socket: usa `sendmsg()` con MSG_NOSIGNAL.
+ *
+ * Si el otro extremo cerró la conexión se devuelve false (EPIPE) en lugar
+ * de terminar el programa con SIGPIPE.
+ * @param fd Socket de destino.
+ * @param segmentos Segmentos a enviar (se modifican si el envío es parcial).
+ * @param cantidad Cantidad de segmentos.
+ * @return true si se envió todo, false si hubo un error.
+ */
+bool enviarSegmentos(int fd, struct iovec* segmentos, int cantidad);
+
+#endif // PRT7_ESCRITURA_H
@@ -0,0 +1,577 @@
+/**
+ * @file prt7/fuentes.h
+ * @brief Fuentes de líneas: lector con buffer sobre un descriptor y captura mapeada en memoria.
+ */
+
+#ifndef PRT7_FUENTES_H
+#define PRT7_FUENTES_H
+
+#include <cerrno>       // Para errno
+#include <cstring>      // Para memmove()
+#include <poll.h>       // Para poll()
+#include <sys/mman.h>   // Para mmap(), madvise()
+#include <sys/stat.h>   // Para fstat()
+#include <unistd.h>     // Para read()
+
+#include "prt7/instrumentacion.h"
+#include "prt7/plataforma.h"
+
+// FUNCIONES: BÚSQUEDA VECTORIZADA DE TERMINADORES
+
+/**
+ * @brief Calcula qué bytes de un bloque de 16 son terminadores de línea ('\n' o '\r').
+ *
+ * Usa SSE2 en x86 y NEON en AArch64; con PRT7_SIN_SIMD (o sin esas
+ * instrucciones) se usa un recorrido escalar con el mismo resultado.
+ * @param datos Inicio del bloque; deben poder leerse 16 bytes.
+ * @return Máscara con el bit i encendido si datos[i] es un terminador.
+ */
+inline unsigned int mascaraTerminadores16(const char* datos) {
+#if defined(PRT7_SIMD_SSE2)
+    __m128i bloque = _mm_loadu_si128(reinterpret_cast<const __m128i*>(datos));
+    __m128i lf = _mm_cmpeq_epi8(bloque, _mm_set1_epi8('\n'));
+    __m128i cr = _mm_cmpeq_epi8(bloque, _mm_set1_epi8('\r'));
+    return (unsigned int)_mm_movemask_epi8(_mm_or_si128(lf, cr));
+#elif defined(PRT7_SIMD_NEON)
+    static const uint8_t pesos[16] = {1, 2, 4, 8, 16, 32, 64, 128, 1, 2, 4, 8, 16, 32, 64, 128};
+    uint8x16_t bloque = vld1q_u8(reinterpret_cast<const uint8_t*>(datos));
+    uint8x16_t coincide = vorrq_u8(vceqq_u8(bloque, vdupq_n_u8('\n')),
+                                   vceqq_u8(bloque, vdupq_n_u8('\r')));
+    uint8x16_t bits = vandq_u8(coincide, vld1q_u8(pesos));
+    return (unsigned int)vaddv_u8(vget_low_u8(bits)) |
+           ((unsigned int)vaddv_u8(vget_high_u8(bits)) << 8);
+#else
+    unsigned int mascara = 0;
+    for (int i = 0; i < 16; i++) {
+        if (datos[i] == '\n' || datos[i] == '\r') {
+            mascara |= 1u << i;
+        }
+    }
+    return mascara;
+#endif
+}
+
+/**
+ * @brief Calcula qué bytes de un bloque de 64 son terminadores de línea.
+ *
+ * Con AVX2 se procesan 32 bytes por instrucción; en los demás casos se
+ * combinan cuatro bloques de 16.
+ * @param datos Inicio del bloque; deben poder leerse 64 bytes.
+ * @return Máscara con el bit i encendido si datos[i] es un terminador.
+ */
+inline unsigned long long mascaraTerminadores64(const char* datos) {
+#if defined(PRT7_SIMD_AVX2)
+    __m256i lf = _mm256_set1_epi8('\n');
+    __m256i cr = _mm256_set1_epi8('\r');
+    __m256i bajo = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos));
+    __m256i alto = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(datos + 32));
+    unsigned int mascaraBaja = (unsigned int)_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(bajo, lf), _mm256_cmpeq_epi8(bajo, cr)));
+    unsigned int mascaraAlta = (unsigned int)_mm256_movemask_epi8(
+        _mm256_or_si256(_mm256_cmpeq_epi8(alto, lf), _mm256_cmpeq_epi8(alto, cr)));
+    return (unsigned long long)mascaraBaja | ((unsigned long long)mascaraAlta << 32);
+#else
+    return (unsigned long long)mascaraTerminadores16(datos) |
+           ((unsigned long long)mascaraTerminadores16(datos + 16) << 16) |
+           ((unsigned long long)mascaraTerminadores16(datos + 32) << 32) |
+           ((unsigned long long)mascaraTerminadores16(datos + 48) << 48);
+#endif
+}
+
+// CLASE BASE: FUENTE DE LÍNEAS
+
+/**
+ * @class FuenteDeLineas
+ * @brief Interfaz común para todo lo que entrega tramas de texto línea por línea.
+ *
+ * Las líneas se entregan como puntero + longitud (sin '\0') y se saltan las
+ * líneas vacías. De una línea de más de MAX_LINEA caracteres se entregan solo
+ * sus primeros MAX_LINEA + 1 (que clasificarTrama descarta) y el resto se
+ * salta hasta el siguiente terminador, en vez de partirla en pedazos que se
+ * interpretarían como tramas sueltas.
+ */
+class FuenteDeLineas {
+public:
+    static const int MAX_LINEA = 99;    ///< Longitud máxima de una línea; las más largas se descartan.
+    
+    /**
+     * @brief Entrega la siguiente línea no vacía terminada por '\n' o '\r'.
+     * @param linea Recibe el puntero al primer carácter de la línea.
+     * @param longitud Recibe la cantidad de caracteres de la línea.
+     * @return true si se entregó una línea, false si se acabaron los datos.
+     */
+    virtual bool leerLinea(const char** linea, int* longitud) = 0;
+    
+    /**
+     * @brief Destructor virtual.
+     */
+    virtual ~FuenteDeLineas() {}
+    
+protected:
+    /**
+     * @brief Busca el primer terminador de línea ('\n' o '\r').
+     * @param datos Inicio de la búsqueda.
+     * @param limite Cantidad de bytes a revisar.
+     * @return Posición del terminador, o -1 si no aparece en los primeros `limite` bytes.
+     */
+    static int buscarTerminador(const char* datos, int limite) {
+        int i = 0;
+        for (; i + 16 <= limite; i += 16) {
+            unsigned int mascara = mascaraTerminadores16(datos + i);
+            if (mascara != 0) {
+                return i + __builtin_ctz(mascara);
+            }
+        }
+        for (; i < limite; i++) {
+            if (datos[i] == '\n' || datos[i] == '\r') {
+                return i;
+            }
+        }
+        return -1;
+    }
+};
+
+// CLASE: LECTOR DE LÍNEAS
+
+/**
+ * @class LectorDeLineas
+ * @brief Lector de líneas con buffer para el puerto serial.
+ *
+ * Cada llamada a `read()` trae todos los bytes disponibles (hasta llenar el
+ * buffer) y las líneas se entregan como puntero + longitud dentro del propio
+ * buffer, sin copiarlas. Cuando no hay datos, `read()` bloquea (VMIN = 1 en
+ * configurarSerial) o se espera con `poll()` si el descriptor es no bloqueante,
+ * de modo que el programa no consume CPU mientras el Arduino está inactivo.
+ */
+class LectorDeLineas : public FuenteDeLineas {
+public:
+    static const int CAPACIDAD = 65536; ///< Tamaño del buffer de lectura.
+    
+private:
+    int fd;                    ///< Descriptor del que se lee.
+    char buffer[CAPACIDAD];    ///< Bytes leídos y aún no entregados en [inicio, fin).
+    int inicio;                ///< Primer byte pendiente de entregar.
+    int fin;                   ///< Una posición después del último byte leído.
+    bool finDeDatos;           ///< true cuando `read()` reportó fin de archivo o un error.
+    bool descartando;          ///< Se entregó el comienzo de una línea demasiado larga; saltar el resto.
+    long lecturas;             ///< Cantidad de llamadas a `read()` realizadas.
+    unsigned long long bytesLeidos; ///< Bytes recibidos del descriptor.
+    void (*antesDeEsperar)(void*);  ///< Aviso opcional antes de bloquearse esperando datos.
+    void* contextoEspera;           ///< Argumento para `antesDeEsperar`.
+    HistogramaLatencia* latencias;  ///< Latencia de cada bloque leído (nullptr = sin medir).
+    unsigned long long recibido;    ///< Momento en que llegó el último bloque aún no procesado (0 = ninguno).
+    unsigned long long nanosEnLectura; ///< Tiempo dentro de `read()` y `poll()` esperando datos (al medir).
+    
+    /**
+     * @brief Acumula el tiempo de una espera de datos, si se está midiendo.
+     * @param inicio Momento en que empezó la espera.
+     * @param recibio true si la espera terminó con bytes nuevos.
+     */
+    void terminarEspera(unsigned long long inicio, bool recibio) {
+        if (latencias == nullptr) return;
+        unsigned long long ahora = relojInstrumentacion();
+        nanosEnLectura += ahora - inicio;
+        if (recibio) recibido = ahora;
+    }
+    
+    /**
+     * @brief Lee del descriptor todos los bytes que quepan al final del buffer.
+     * @param esperar Si es false y el descriptor no bloqueante no tiene datos, vuelve sin esperar.
+     * @return true si se agregaron bytes, false si se llegó al fin de los datos (o no había datos).
+     */
+    bool llenar(bool esperar = true) {
+        // Pedir más datos significa que el bloque anterior ya se procesó
+        marcarProcesado();
+        
+        // Compactar: mover lo pendiente al inicio para dejar espacio libre
+        if (inicio > 0) {
+            memmove(buffer, buffer + inicio, fin - inicio);
+            fin -= inicio;
+            inicio = 0;
+        }
+        
+        if (antesDeEsperar != nullptr) {
+            // Avisar solo si read() va a bloquearse (no hay bytes listos)
+            struct pollfd consulta;
+            consulta.fd = fd;
+            consulta.events = POLLIN;
+            if (poll(&consulta, 1, 0) == 0) {
+                antesDeEsperar(contextoEspera);
+            }
+        }
+        
+        unsigned long long inicioEspera = latencias != nullptr ? relojInstrumentacion() : 0;
+        while (true) {
+            lecturas++;
+            ssize_t n = read(fd, buffer + fin, CAPACIDAD - fin);
+            
+            if (n > 0) {
+                terminarEspera(inicioEspera, true);
+                fin += (int)n;
+                bytesLeidos += (unsigned long long)n;
+                PRT7_CONTAR(bytesLeidos, n);
+                PRT7_CONTAR(lecturas, 1);
+                PRT7_MARCAR_RECEPCION();
+                return true;
+            }
+            if (n < 0 && errno == EINTR) {
+                continue;
+            }
+            if (n < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                if (!esperar) {
+                    terminarEspera(inicioEspera, false);
+                    return false;
+                }
+                
+                // Descriptor no bloqueante: esperar a que lleguen datos
+                struct pollfd espera;
+                espera.fd = fd;
+                espera.events = POLLIN;
+                poll(&espera, 1, -1);
+                continue;
+            }
+            
+            terminarEspera(inicioEspera, false);
+            finDeDatos = true;
+            return false;
+        }
+    }
+    
+public:
+    /**
+     * @brief Constructor.
+     * @param descriptor Descriptor de archivo del puerto serial (o de cualquier flujo de bytes).
+     */
+    explicit LectorDeLineas(int descriptor)
+        : fd(descriptor), inicio(0), fin(0), finDeDatos(false), descartando(false), lecturas(0),
+          bytesLeidos(0), antesDeEsperar(nullptr), contextoEspera(nullptr), latencias(nullptr), recibido(0),
+          nanosEnLectura(0) {}
+    
+    /**
+     * @brief Registra una función que se llama justo antes de bloquearse esperando datos.
+     *
+     * Sirve, por ejemplo, para volcar la salida pendiente mientras el puerto está inactivo.
+     * @param funcion Función a llamar (nullptr para ninguna).
+     * @param contexto Argumento que recibe la función.
+     */
+    void setAntesDeEsperar(void (*funcion)(void*), void* contexto) {
+        antesDeEsperar = funcion;
+        contextoEspera = contexto;
+    }
+    
+    /**
+     * @brief Mide la latencia de cada bloque leído y el tiempo esperando datos.
+     *
+     * La latencia de un bloque va desde que `read()` lo entrega hasta que se
+     * piden más datos (ya se procesaron sus líneas completas) o hasta
+     * `marcarProcesado`. Medir cuesta dos lecturas del reloj por `read()`.
+     * @param histograma Destino de las latencias (nullptr para dejar de medir).
+     */
+    void setMedicion(HistogramaLatencia* histograma) {
+        latencias = histograma;
+        recibido = 0;
+    }
+    
+    /**
+     * @brief Registra la latencia del último bloque leído, si no se registró todavía.
+     *
+     * Se llama sola antes de cada lectura; hace falta llamarla al terminar,
+     * para el último bloque (el que trae "FIN").
+     */
+    void marcarProcesado() {
+        if (latencias != nullptr && recibido != 0) {
+            latencias->registrar(relojInstrumentacion() - recibido);
+            recibido = 0;
+        }
+    }
+    
+    /**
+     * @brief Entrega la siguiente línea no vacía terminada por '\n' o '\r'.
+     *
+     * La línea queda dentro del buffer interno y es válida solo hasta la
+     * siguiente llamada. No termina en '\0'.
+     * @param linea Recibe el puntero al primer carácter de la línea.
+     * @param longitud Recibe la cantidad de caracteres de la línea.
+     * @return true si se entregó una línea, false si se acabaron los datos.
+     */
+    bool leerLinea(const char** linea, int* longitud) {
+        return siguienteLinea(linea, longitud, true);
+    }
+    
+    /**
+     * @brief Como `leerLinea`, pero sin esperar: para descriptores no bloqueantes vigilados con epoll.
+     *
+     * Hace a lo sumo las lecturas que no bloquean; una línea incompleta queda
+     * en el buffer hasta que lleguen sus bytes restantes.
+     * @param linea Recibe el puntero al primer carácter de la línea.
+     * @param longitud Recibe la cantidad de caracteres de la línea.
+     * @return true si se entregó una línea; false si no hay una línea completa
+     *         por ahora o se acabaron los datos (ver `getFinDeDatos`).
+     */
+    bool leerLineaDisponible(const char** linea, int* longitud) {
+        return siguienteLinea(linea, longitud, false);
+    }
+    
+    /**
+     * @brief Indica si el descriptor llegó al fin de los datos (o falló).
+     * @return true si `read()` reportó fin de archivo o un error.
+     */
+    bool getFinDeDatos() const {
+        return finDeDatos;
+    }
+    
+    /**
+     * @brief Entrega todos los bytes recibidos y aún no entregados, sin separarlos en líneas.
+     *
+     * Si no hay ninguno, espera a que llegue al menos un byte. Sirve para
+     * alimentar a DecodificadorContinuo sin copiar. No debe mezclarse con
+     * `leerLinea` a mitad de una línea.
+     * @param datos Recibe el inicio de los bytes (válidos hasta la siguiente lectura).
+     * @param cantidad Recibe la cantidad de bytes.
+     * @param esperar false para no esperar en un descriptor no bloqueante (como `leerLineaDisponible`).
+     * @return true si se entregaron bytes; false si se acabaron los datos o,
+     *         sin esperar, si por ahora no hay bytes (ver `getFinDeDatos`).
+     */
+    bool leerBloque(const char** datos, size_t* cantidad, bool esperar = true) {
+        if (inicio == fin && (finDeDatos || !llenar(esperar))) {
+            return false;
+        }
+        *datos = buffer + inicio;
+        *cantidad = (size_t)(fin - inicio);
+        inicio = fin;
+        return true;
+    }
+    
+private:
+    /**
+     * @brief Implementación común de `leerLinea` y `leerLineaDisponible`.
+     * @param linea Recibe el puntero al primer carácter de la línea.
+     * @param longitud Recibe la cantidad de caracteres de la línea.
+     * @param esperar true para esperar datos si el buffer no tiene una línea completa.
+     * @return true si se entregó una línea.
+     */
+    bool siguienteLinea(const char** linea, int* longitud, bool esperar) {
+        while (true) {
+            // Saltar el resto de una línea demasiado larga: cada byte se mira una sola vez
+            if (descartando) {
+                int terminador = buscarTerminador(buffer + inicio, fin - inicio);
+                if (terminador < 0) {
+                    inicio = fin;
+                    if (finDeDatos || !llenar(esperar)) return false;
+                    continue;
+                }
+                inicio += terminador + 1;
+                descartando = false;
+            }
+            
+            // Saltar terminadores de líneas vacías
+            while (inicio < fin && (buffer[inicio] == '\n' || buffer[inicio] == '\r')) {
+                inicio++;
+            }
+            
+            int disponibles = fin - inicio;
+            int limite = disponibles < MAX_LINEA + 1 ? disponibles : MAX_LINEA + 1;
+            
+            int terminador = buscarTerminador(buffer + inicio, limite);
+            if (terminador >= 0) {
+                *linea = buffer + inicio;
+                *longitud = terminador;
+                inicio += terminador + 1;
+                return true;
+            }
+            
+            // Línea demasiado larga: se entrega su comienzo y el resto se salta en la próxima llamada
+            if (disponibles > MAX_LINEA) {
+                *linea = buffer + inicio;
+                *longitud = MAX_LINEA + 1;
+                inicio += MAX_LINEA + 1;
+                descartando = true;
+                return true;
+            }
+            
+            if (finDeDatos || !llenar(esperar)) {
+                if (!finDeDatos) return false;
+                
+                // Entregar la última línea aunque no tenga terminador
+                if (fin > inicio) {
+                    *linea = buffer + inicio;
+                    *longitud = fin - inicio;
+                    inicio = fin;
+                    return true;
+                }
+                return false;
+            }
+        }
+    }
+    
+public:
+    /**
+     * @brief Obtiene la cantidad de llamadas a `read()` hechas hasta ahora.
+     * @return Número de lecturas al sistema.
+     */
+    long getLecturas() const {
+        return lecturas;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de bytes recibidos.
+     * @return Bytes leídos del descriptor.
+     */
+    unsigned long long getBytesLeidos() const {
+        return bytesLeidos;
+    }
+    
+    /**
+     * @brief Obtiene el tiempo pasado esperando datos en `read()` (o en `poll()`), si se mide.
+     * @return Nanosegundos esperando (0 sin `setMedicion`).
+     */
+    unsigned long long getNanosEnLectura() const {
+        return nanosEnLectura;
+    }
+};
+
+// CLASE: FUENTE MAPEADA EN MEMORIA
+
+/**
+ * @class FuenteMapeada
+ * @brief Entrega las líneas de una captura grabada directamente desde un `mmap()` del archivo.
+ *
+ * Las líneas se buscan en el propio mapeo y se entregan como vistas
+ * puntero + longitud, sin copiarlas a un buffer intermedio. El mapeo se
+ * marca MADV_SEQUENTIAL y las páginas ya procesadas se descartan con
+ * MADV_DONTNEED cada VENTANA_DESCARTE bytes, de modo que capturas más grandes
+ * que la RAM no acumulan memoria residente.
+ */
+class FuenteMapeada : public FuenteDeLineas {
+public:
+    static const size_t VENTANA_DESCARTE = 64 * 1024 * 1024; ///< Bytes procesados entre descartes de páginas.
+    
+private:
+    char* datos;        ///< Inicio del mapeo (nullptr si no está abierto).
+    size_t tamano;      ///< Tamaño del archivo mapeado.
+    size_t posicion;    ///< Primer byte aún no entregado.
+    size_t descartado;  ///< Bytes iniciales cuyas páginas ya se liberaron.
+    
+    /**
+     * @brief Libera las páginas ya procesadas cuando se avanzó una ventana completa.
+     */
+    void descartarProcesado() {
+        if (posicion - descartado < VENTANA_DESCARTE) return;
+        
+        size_t pagina = (size_t)sysconf(_SC_PAGESIZE);
+        size_t limite = posicion / pagina * pagina;
+        madvise(datos + descartado, limite - descartado, MADV_DONTNEED);
+        descartado = limite;
+    }
+    
+public:
+    /**
+     * @brief Constructor. Crea una fuente sin archivo asociado.
+     */
+    FuenteMapeada() : datos(nullptr), tamano(0), posicion(0), descartado(0) {}
+    
+    /**
+     * @brief Destructor. Libera el mapeo.
+     */
+    ~FuenteMapeada() {
+        if (datos != nullptr) {
+            munmap(datos, tamano);
+        }
+    }
+    
+    /**
+     * @brief Mapea en memoria el archivo asociado al descriptor.
+     * @param fd Descriptor de un archivo regular abierto para lectura.
+     * @return true si se mapeó; false si no es un archivo regular, está vacío o falló `mmap()`.
+     */
+    bool abrir(int fd) {
+        struct stat informacion;
+        if (fstat(fd, &informacion) != 0 || !S_ISREG(informacion.st_mode) || informacion.st_size <= 0) {
+            return false;
+        }
+        
+        void* mapeo = mmap(nullptr, (size_t)informacion.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (mapeo == MAP_FAILED) {
+            return false;
+        }
+        
+        datos = static_cast<char*>(mapeo);
+        tamano = (size_t)informacion.st_size;
+        posicion = 0;
+        descartado = 0;
+        madvise(datos, tamano, MADV_SEQUENTIAL);
+        PRT7_CONTAR(bytesLeidos, tamano);
+        PRT7_CONTAR(lecturas, 1);
+        PRT7_MARCAR_RECEPCION();
+        return true;
+    }
+    
+    /**
+     * @brief Obtiene la parte del mapeo que aún no se ha entregado.
+     * @param pendiente Recibe el puntero al primer byte pendiente.
+     * @param restante Recibe la cantidad de bytes pendientes.
+     */
+    void getPendiente(const char** pendiente, size_t* restante) const {
+        *pendiente = datos + posicion;
+        *restante = tamano - posicion;
+    }
+    
+    /**
+     * @brief Obtiene cuántos bytes del mapeo ya se entregaron.
+     * @return Bytes desde el inicio del archivo hasta el primero pendiente.
+     */
+    size_t getEntregados() const {
+        return posicion;
+    }
+    
+    /**
+     * @brief Marca como entregados los siguientes bytes del mapeo (e.g., tras tokenizarlos en lote).
+     * @param bytes Cantidad de bytes consumidos.
+     */
+    void avanzar(size_t bytes) {
+        posicion += bytes;
+        descartarProcesado();
+    }
+    
+    /**
+     * @brief Entrega la siguiente línea como vista dentro del mapeo.
+     * @param linea Recibe el puntero al primer carácter de la línea.
+     * @param longitud Recibe la cantidad de caracteres de la línea.
+     * @return true si se entregó una línea, false al llegar al final del archivo.
+     */
+    bool leerLinea(const char** linea, int* longitud) {
+        // Saltar terminadores de líneas vacías
+        while (posicion < tamano && (datos[posicion] == '\n' || datos[posicion] == '\r')) {
+            posicion++;
+        }
+        if (posicion >= tamano) {
+            return false;
+        }
+        
+        descartarProcesado();
+        
+        size_t disponibles = tamano - posicion;
+        int limite = disponibles < (size_t)MAX_LINEA + 1 ? (int)disponibles : MAX_LINEA + 1;
+        int terminador = buscarTerminador(datos + posicion, limite);
+        
+        *linea = datos + posicion;
+        if (terminador >= 0) {
+            *longitud = terminador;
+            posicion += terminador + 1;
+        } else if (limite <= MAX_LINEA) {
+            // Última línea sin terminador
+            *longitud = limite;
+            posicion += limite;
+        } else {
+            // Línea demasiado larga: se entrega su comienzo y se salta hasta el siguiente terminador
+            *longitud = MAX_LINEA + 1;
+            posicion += MAX_LINEA + 1;
+            while (posicion < tamano && datos[posicion] != '\n' && datos[posicion] != '\r') {
+                posicion++;
+            }
+        }
+        return true;
+    }
+};
+
+#endif // PRT7_FUENTES_H
@@ -0,0 +1,245 @@
+/**
+ * @file prt7/generador.h
+ * @brief Generador determinista de flujos PRT-7 sintéticos, con el mensaje y los conteos que se esperan.
+ */
+
+#ifndef PRT7_GENERADOR_H
+#define PRT7_GENERADOR_H
+
+#include <cstddef>      // Para size_t
+
+#include "prt7/binario.h"
+
+/**
+ * @struct PerfilDeCarga
+ * @brief Proporciones y límites del flujo que produce un GeneradorDeTramas.
+ *
+ * Las proporciones van en milésimas de los sorteos: una corrida de LOAD se
+ * sortea una sola vez, salvo el ruido, que se sortea en cada trama. Las mal
+ * formadas, el ruido y los reinicios solo se usan en modo texto.
+ */
+struct PerfilDeCarga {
+    unsigned long long semilla;  ///< Semilla: la misma semilla y el mismo perfil dan el mismo flujo.
+    long mapeoPorMil;            ///< Tramas MAP (entre las válidas).
+    long malFormadasPorMil;      ///< Líneas mal formadas o descartadas (checksum incorrecto, demasiado largas).
+    long ruidoPorMil;            ///< Tramas válidas con bytes de ruido en los extremos (quedan reparadas).
+    long reiniciosPorMil;        ///< Marcadores "I" en medio del flujo (el decodificador los ignora).
+    int corridaMaxima;           ///< Largo máximo de una corrida de LOAD seguidos (1 = sin corridas).
+    int rotacionMaxima;          ///< |N| máximo de los MAP (hasta 2147483647).
+    bool binario;                ///< Negociar "BIN" después de "I" y enviar tramas binarias.
+    
+    /**
+     * @brief Constructor. Perfil parecido al del Arduino: 20% de MAP pequeños, sin errores.
+     */
+    PerfilDeCarga() : semilla(1), mapeoPorMil(200), malFormadasPorMil(0), ruidoPorMil(0), reiniciosPorMil(0),
+                      corridaMaxima(1), rotacionMaxima(30), binario(false) {}
+};
+
+/**
+ * @class GeneradorDeTramas
+ * @brief Produce un flujo PRT-7 determinista y calcula lo que el decodificador debe obtener de él.
+ *
+ * El flujo empieza con "I" (y "BIN" en modo binario), sigue con las tramas
+ * que se pidan a `generar` y termina con "FIN" (`finalizar`). Cada trama
+ * se sortea con un xorshift de 64 bits, así que el flujo no depende de cómo
+ * se pidan los trozos. Una "trama" es una línea de texto o una trama
+ * binaria (en binario una corrida de LOAD va en una sola trama de carga).
+ *
+ * El generador lleva su propio desplazamiento del rotor para calcular el
+ * mensaje esperado, que entrega con `setAlGenerar`, y cuenta las tramas
+ * como las cuenta el Decodificador, para compararlas con su resumen.
+ */
+class GeneradorDeTramas {
+public:
+    static const size_t MAX_TRAMA = MAX_TRAMA_BINARIA;  ///< Bytes que `generar` necesita libres para una trama más.
+    
+private:
+    static const int LONGITUD = 26;  ///< Letras del alfabeto del rotor.
+    
+    PerfilDeCarga perfil;               ///< Proporciones del flujo.
+    unsigned long long estado;          ///< Estado del xorshift.
+    int desplazamiento;                 ///< Posición esperada del rotor.
+    bool iniciado;                      ///< Ya se escribió el encabezado ("I" y "BIN").
+    int corridaPendiente;               ///< LOAD que faltan de la corrida actual.
+    unsigned long long generadas;       ///< Tramas escritas (líneas o tramas binarias).
+    long tramasCarga;                   ///< LOAD que el decodificador debe contar.
+    long tramasMapeo;                   ///< MAP que debe contar.
+    long tramasMalFormadas;             ///< Mal formadas que debe contar.
+    long tramasDescartadas;             ///< Descartadas que debe contar.
+    long tramasReparadas;               ///< Reparadas que debe contar.
+    void (*alGenerar)(void*, const char*, size_t); ///< Recibe el mensaje esperado (o nullptr).
+    void* contextoGenerado;                        ///< Argumento para `alGenerar`.
+    char esperados[1024];               ///< Caracteres esperados aún no entregados a `alGenerar`.
+    size_t largoEsperados;              ///< Caracteres en `esperados`.
+    
+    /**
+     * @brief Obtiene el siguiente número del xorshift.
+     * @return 64 bits pseudoaleatorios.
+     */
+    unsigned long long sortear() {
+        unsigned long long x = estado;
+        x ^= x << 13;
+        x ^= x >> 7;
+        x ^= x << 17;
+        estado = x;
+        return x;
+    }
+    
+    /**
+     * @brief Registra un carácter cifrado: lo descifra con el rotor esperado y lo agrega al mensaje.
+     * @param cifrado Carácter enviado en la trama LOAD.
+     */
+    void esperar(char cifrado) {
+        char claro = cifrado;
+        if (cifrado >= 'A' && cifrado <= 'Z') {
+            claro = (char)('A' + (cifrado - 'A' + desplazamiento) % LONGITUD);
+        }
+        if (largoEsperados == sizeof(esperados)) entregarEsperados();
+        esperados[largoEsperados++] = claro;
+        tramasCarga++;
+    }
+    
+    /**
+     * @brief Entrega a `alGenerar` los caracteres esperados acumulados.
+     */
+    void entregarEsperados() {
+        if (alGenerar != nullptr && largoEsperados > 0) alGenerar(contextoGenerado, esperados, largoEsperados);
+        largoEsperados = 0;
+    }
+    
+    /**
+     * @brief Sortea el carácter de un LOAD (A-Z, o un espacio una de cada 32 veces en texto).
+     * @param valor Número sorteado.
+     * @return El carácter cifrado.
+     */
+    char sortearCaracter(unsigned long long valor) {
+        if (!perfil.binario && (valor >> 40) % 32 == 0) return ' ';
+        return (char)('A' + (valor >> 20) % LONGITUD);
+    }
+    
+    /**
+     * @brief Sortea una rotación en [-rotacionMaxima, rotacionMaxima] y la aplica al rotor esperado.
+     * @param valor Número sorteado.
+     * @return La rotación.
+     */
+    int sortearRotacion(unsigned long long valor);
+    
+    /**
+     * @brief Escribe una línea mal formada o descartada, elegida entre variantes fijas.
+     * @param destino Buffer de salida.
+     * @param valor Número sorteado.
+     * @return Bytes escritos.
+     */
+    size_t escribirError(char* destino, unsigned long long valor);
+    
+    /**
+     * @brief Escribe una trama de texto (LOAD, MAP, "I", o una línea con errores).
+     * @param destino Buffer de salida.
+     * @return Bytes escritos.
+     */
+    size_t escribirTexto(char* destino);
+    
+    /**
+     * @brief Escribe una trama binaria (una corrida de LOAD o un MAP).
+     * @param destino Buffer de salida.
+     * @return Bytes escritos.
+     */
+    size_t escribirBinaria(char* destino);
+    
+public:
+    /**
+     * @brief Constructor.
+     * @param p Perfil del flujo.
+     */
+    explicit GeneradorDeTramas(const PerfilDeCarga& p);
+    
+    /**
+     * @brief Registra una función que recibe el mensaje que el decodificador debe obtener.
+     *
+     * Los caracteres se entregan en bloques, a más tardar al final de cada
+     * `generar` y en `finalizar`.
+     * @param funcion Recibe el contexto, los caracteres y su cantidad; nullptr para no recibir nada.
+     * @param contexto Argumento que se pasa a `funcion`.
+     */
+    void setAlGenerar(void (*funcion)(void*, const char*, size_t), void* contexto) {
+        alGenerar = funcion;
+        contextoGenerado = contexto;
+    }
+    
+    /**
+     * @brief Escribe tramas hasta llenar el destino o completar la cantidad pedida.
+     *
+     * La primera llamada escribe antes el encabezado ("I", y "BIN" en modo binario).
+     * @param destino Buffer de salida.
+     * @param capacidad Bytes del buffer (al menos MAX_TRAMA + 8).
+     * @param maxTramas Tramas a escribir como máximo.
+     * @param escritas Recibe cuántas tramas se escribieron.
+     * @return Bytes escritos.
+     */
+    size_t generar(char* destino, size_t capacidad, unsigned long long maxTramas, unsigned long long* escritas);
+    
+    /**
+     * @brief Escribe el marcador "FIN" (precedido de '\n' en modo binario) y entrega lo esperado pendiente.
+     * @param destino Buffer de al menos 16 bytes.
+     * @return Bytes escritos.
+     */
+    size_t finalizar(char* destino);
+    
+    /**
+     * @brief Obtiene cuántas tramas se generaron.
+     * @return Líneas o tramas binarias escritas, sin contar el encabezado ni "FIN".
+     */
+    unsigned long long getGeneradas() const {
+        return generadas;
+    }
+    
+    /**
+     * @brief Obtiene la posición que debe tener el rotor después de lo generado.
+     * @return Desplazamiento de 0 a 25.
+     */
+    int getDesplazamiento() const {
+        return desplazamiento;
+    }
+    
+    /**
+     * @brief Obtiene las tramas LOAD que el decodificador debe contar.
+     * @return Caracteres del mensaje esperado.
+     */
+    long getTramasCarga() const {
+        return tramasCarga;
+    }
+    
+    /**
+     * @brief Obtiene las tramas MAP que el decodificador debe contar.
+     * @return Tramas MAP válidas generadas.
+     */
+    long getTramasMapeo() const {
+        return tramasMapeo;
+    }
+    
+    /**
+     * @brief Obtiene las líneas mal formadas que el decodificador debe contar.
+     * @return Líneas mal formadas generadas.
+     */
+    long getTramasMalFormadas() const {
+        return tramasMalFormadas;
+    }
+    
+    /**
+     * @brief Obtiene las tramas descartadas que el decodificador debe contar.
+     * @return Líneas con checksum incorrecto o demasiado largas generadas.
+     */
+    long getTramasDescartadas() const {
+        return tramasDescartadas;
+    }
+    
+    /**
+     * @brief Obtiene las tramas reparadas que el decodificador debe contar.
+     * @return Tramas válidas generadas con ruido en los extremos.
+     */
+    long getTramasReparadas() const {
+        return tramasReparadas;
+    }
+};
+
+#endif // PRT7_GENERADOR_H
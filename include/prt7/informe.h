@@ -0,0 +1,115 @@
+/**
+ * @file prt7/informe.h
+ * @brief Informe JSON de fin de sesión: ritmo, latencia de decodificación, espera en la lectura y memoria.
+ */
+
+#ifndef PRT7_INFORME_H
+#define PRT7_INFORME_H
+
+#include <cstddef>      // Para size_t
+
+#include "prt7/decodificador.h"
+#include "prt7/instrumentacion.h"
+#include "prt7/lista_de_carga.h"
+
+/**
+ * @class InformeDeSesion
+ * @brief Junta las métricas de una sesión y las escribe como un objeto JSON de una línea.
+ *
+ * La duración se mide desde la construcción hasta `terminar`. La latencia
+ * de decodificación se registra en el histograma de `getLatencias`, que se
+ * le pasa al lector (ver LectorDeLineas::setMedicion): cada muestra va
+ * desde que `read()` entrega un bloque hasta que sus líneas ya se
+ * procesaron. Con una captura mapeada en memoria no hay lecturas, así que
+ * el histograma queda vacío.
+ *
+ * Las claves del objeto son estables ("formato" cambia si dejan de serlo),
+ * para que lo lea un script de integración continua.
+ */
+class InformeDeSesion {
+public:
+    static const size_t MAX_INFORME = 1024;  ///< Bytes que ocupa el informe como máximo.
+
+private:
+    unsigned long long inicio;            ///< Momento de la construcción.
+    unsigned long long duracion;          ///< Nanosegundos de la sesión (al llamar a `terminar`).
+    HistogramaLatencia latencias;         ///< Latencia de decodificación de cada bloque leído.
+    long tramasCarga;                     ///< Tramas LOAD.
+    long tramasMapeo;                     ///< Tramas MAP.
+    long tramasMalFormadas;               ///< Líneas mal formadas.
+    long tramasDescartadas;               ///< Tramas descartadas por el entramado.
+    long tramasReparadas;                 ///< Tramas reparadas.
+    long long rotacionMaxima;             ///< Mayor |N| de las rotaciones aplicadas.
+    bool finRecibido;                     ///< La sesión terminó con "FIN".
+    unsigned long long bytes;             ///< Bytes de la entrada entregados al decodificador.
+    long lecturas;                        ///< Llamadas a `read()`.
+    unsigned long long nanosEnLectura;    ///< Tiempo bloqueado esperando datos.
+    size_t memoriaMaxima;                 ///< Mayor memoria de la ListaDeCarga.
+
+public:
+    /**
+     * @brief Constructor. La sesión empieza a medirse ahora.
+     */
+    InformeDeSesion();
+    
+    // El histograma es grande y el informe mide una sola sesión: no se copia
+    InformeDeSesion(const InformeDeSesion&) = delete;
+    InformeDeSesion& operator=(const InformeDeSesion&) = delete;
+    
+    /**
+     * @brief Obtiene el histograma donde se registra la latencia de decodificación.
+     * @return Histograma del informe.
+     */
+    HistogramaLatencia* getLatencias() {
+        return &latencias;
+    }
+    
+    /**
+     * @brief Toma los conteos, la mayor rotación y si llegó "FIN" de un decodificador.
+     * @param decodificador Decodificador de la sesión.
+     */
+    void registrarDecodificador(const Decodificador& decodificador);
+    
+    /**
+     * @brief Toma la mayor memoria que ocupó una lista.
+     * @param lista Lista del mensaje.
+     */
+    void registrarLista(const ListaDeCarga& lista);
+    
+    /**
+     * @brief Registra lo leído de la entrada.
+     * @param cantidadBytes Bytes entregados al decodificador.
+     * @param cantidadLecturas Llamadas a `read()` (0 con una captura mapeada).
+     * @param nanosEsperando Nanosegundos bloqueado esperando datos.
+     */
+    void registrarLectura(unsigned long long cantidadBytes, long cantidadLecturas,
+                          unsigned long long nanosEsperando) {
+        bytes = cantidadBytes;
+        lecturas = cantidadLecturas;
+        nanosEnLectura = nanosEsperando;
+    }
+    
+    /**
+     * @brief Fija la duración de la sesión en el momento actual.
+     */
+    void terminar() {
+        duracion = relojInstrumentacion() - inicio;
+    }
+    
+    /**
+     * @brief Escribe el informe como JSON de una línea, terminado en '\n'.
+     * @param destino Buffer de al menos MAX_INFORME bytes.
+     * @param capacidad Bytes del buffer.
+     * @return Bytes escritos (sin el '\0' final).
+     */
+    size_t formatear(char* destino, size_t capacidad) const;
+    
+    /**
+     * @brief Escribe el informe en un archivo, que se crea o se vacía, o en la salida estándar.
+     * @param destino Ruta del archivo, o "-" para la salida estándar.
+     * @return false si no se pudo abrir o escribir.
+     */
+    bool escribir(const char* destino) const;
+};
+
+#endif // PRT7_INFORME_H
@@ -0,0 +1,192 @@
+/**
+ * @file prt7/instantanea.h
+ * @brief Instantánea del estado del decodificador, legible desde otros hilos sin bloqueos (seqlock).
+ */
+
+#ifndef PRT7_INSTANTANEA_H
+#define PRT7_INSTANTANEA_H
+
+#include <atomic>       // Para std::atomic, std::atomic_thread_fence
+#include <cstddef>      // Para size_t
+#include <cstring>      // Para memcpy()
+#include <thread>       // Para std::this_thread::yield()
+
+/**
+ * @struct EstadoDecodificador
+ * @brief Copia consistente del estado publicado por el decodificador.
+ */
+struct EstadoDecodificador {
+    static const size_t MAX_RECIENTES = 64; ///< Caracteres recientes que se publican.
+    
+    unsigned long long publicaciones;    ///< Publicaciones hechas hasta esta copia.
+    int desplazamiento;                  ///< Posición del rotor (o del rotor 0 de la cascada).
+    long tramasCarga;                    ///< Tramas LOAD procesadas (= caracteres del mensaje).
+    long tramasMapeo;                    ///< Tramas MAP procesadas.
+    long tramasMalFormadas;              ///< Líneas mal formadas.
+    long tramasDescartadas;              ///< Tramas descartadas por el entramado.
+    size_t cantidadRecientes;            ///< Caracteres válidos en `recientes`.
+    char recientes[MAX_RECIENTES + 1];   ///< Últimos caracteres decodificados, del más viejo al más nuevo ('\0' al final).
+    
+    /**
+     * @brief Obtiene el número de secuencia de la próxima trama.
+     * @return Tramas recibidas hasta esta copia.
+     */
+    long getSecuencia() const {
+        return tramasCarga + tramasMapeo + tramasMalFormadas + tramasDescartadas;
+    }
+};
+
+/**
+ * @class InstantaneaDeEstado
+ * @brief Estado del decodificador publicado con un seqlock: un escritor, cualquier cantidad de lectores.
+ *
+ * El hilo que decodifica llama a `agregar` con los caracteres decodificados
+ * y a `publicar` al terminar cada lote (ver `Decodificador::setInstantanea`).
+ * `publicar` deja `secuencia` impar mientras escribe los campos y la vuelve
+ * par al terminar. Un lector (`leer`) copia los campos entre dos lecturas de
+ * `secuencia` y repite si cambió o era impar. El escritor nunca espera a un
+ * lector: publicar son unas quince escrituras atómicas relajadas, sin
+ * bloqueos ni operaciones de lectura-modificación-escritura.
+ *
+ * Todos los campos compartidos son atómicos (relajados) para que las
+ * lecturas concurrentes no sean una carrera de datos. Los caracteres
+ * recientes se publican de a 8 por palabra de 64 bits.
+ */
+class InstantaneaDeEstado {
+public:
+    static const size_t MAX_RECIENTES = EstadoDecodificador::MAX_RECIENTES; ///< Caracteres recientes.
+    
+private:
+    static const size_t LINEA_CACHE = 64;
+    static const size_t PALABRAS = MAX_RECIENTES / 8;
+    
+    // Lado del escritor (solo lo toca el hilo que decodifica)
+    char anillo[MAX_RECIENTES];      ///< Últimos caracteres, en orden circular.
+    unsigned long long agregados;    ///< Caracteres agregados en total.
+    char relleno0[LINEA_CACHE];
+    
+    // Campos publicados
+    std::atomic<unsigned long long> secuencia;          ///< Impar mientras se publica.
+    std::atomic<int> desplazamiento;                    ///< Posición del rotor.
+    std::atomic<long> tramasCarga;                      ///< Tramas LOAD.
+    std::atomic<long> tramasMapeo;                      ///< Tramas MAP.
+    std::atomic<long> tramasMalFormadas;                ///< Líneas mal formadas.
+    std::atomic<long> tramasDescartadas;                ///< Tramas descartadas.
+    std::atomic<unsigned long long> cantidadRecientes;  ///< Caracteres válidos en `palabras`.
+    std::atomic<unsigned long long> palabras[PALABRAS]; ///< Caracteres recientes, 8 por palabra.
+    char relleno1[LINEA_CACHE];
+    
+    std::atomic<unsigned long long> reintentos;         ///< Lecturas repetidas por coincidir con una publicación.
+    
+public:
+    /**
+     * @brief Constructor. Publica un estado vacío.
+     */
+    InstantaneaDeEstado() : agregados(0), secuencia(0), desplazamiento(0), tramasCarga(0), tramasMapeo(0),
+                            tramasMalFormadas(0), tramasDescartadas(0), cantidadRecientes(0), reintentos(0) {
+        for (size_t i = 0; i < PALABRAS; i++) {
+            palabras[i].store(0, std::memory_order_relaxed);
+        }
+    }
+    
+    InstantaneaDeEstado(const InstantaneaDeEstado&) = delete;
+    InstantaneaDeEstado& operator=(const InstantaneaDeEstado&) = delete;
+    
+    /**
+     * @brief (Escritor) Agrega caracteres decodificados; se ven en la próxima publicación.
+     * @param datos Caracteres decodificados.
+     * @param cantidad Cantidad de caracteres (solo se conservan los últimos MAX_RECIENTES).
+     */
+    void agregar(const char* datos, size_t cantidad) {
+        if (cantidad > MAX_RECIENTES) {
+            agregados += cantidad - MAX_RECIENTES;
+            datos += cantidad - MAX_RECIENTES;
+            cantidad = MAX_RECIENTES;
+        }
+        for (size_t i = 0; i < cantidad; i++) {
+            anillo[(agregados + i) % MAX_RECIENTES] = datos[i];
+        }
+        agregados += cantidad;
+    }
+    
+    /**
+     * @brief (Escritor) Publica el estado para los lectores.
+     * @param rotor Posición del rotor.
+     * @param carga Tramas LOAD.
+     * @param mapeo Tramas MAP.
+     * @param malFormadas Líneas mal formadas.
+     * @param descartadas Tramas descartadas.
+     */
+    void publicar(int rotor, long carga, long mapeo, long malFormadas, long descartadas) {
+        // Los recientes en orden, del más viejo al más nuevo
+        char ordenados[MAX_RECIENTES] = {};
+        size_t cantidad = agregados < MAX_RECIENTES ? (size_t)agregados : MAX_RECIENTES;
+        for (size_t i = 0; i < cantidad; i++) {
+            ordenados[i] = anillo[(agregados - cantidad + i) % MAX_RECIENTES];
+        }
+        
+        unsigned long long s = secuencia.load(std::memory_order_relaxed);
+        secuencia.store(s + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        
+        desplazamiento.store(rotor, std::memory_order_relaxed);
+        tramasCarga.store(carga, std::memory_order_relaxed);
+        tramasMapeo.store(mapeo, std::memory_order_relaxed);
+        tramasMalFormadas.store(malFormadas, std::memory_order_relaxed);
+        tramasDescartadas.store(descartadas, std::memory_order_relaxed);
+        cantidadRecientes.store(cantidad, std::memory_order_relaxed);
+        for (size_t i = 0; i < PALABRAS; i++) {
+            unsigned long long palabra;
+            memcpy(&palabra, ordenados + i * 8, 8);
+            palabras[i].store(palabra, std::memory_order_relaxed);
+        }
+        
+        secuencia.store(s + 2, std::memory_order_release);
+    }
+    
+    /**
+     * @brief (Lector) Copia el último estado publicado, sin bloquear al escritor.
+     *
+     * Si la copia coincide con una publicación se repite. Como el escritor
+     * publica en unas decenas de nanosegundos, casi nunca hace falta
+     * más de un reintento.
+     * @param estado Recibe la copia.
+     */
+    void leer(EstadoDecodificador* estado) {
+        while (true) {
+            unsigned long long antes = secuencia.load(std::memory_order_acquire);
+            if ((antes & 1) == 0) {
+                estado->desplazamiento = desplazamiento.load(std::memory_order_relaxed);
+                estado->tramasCarga = tramasCarga.load(std::memory_order_relaxed);
+                estado->tramasMapeo = tramasMapeo.load(std::memory_order_relaxed);
+                estado->tramasMalFormadas = tramasMalFormadas.load(std::memory_order_relaxed);
+                estado->tramasDescartadas = tramasDescartadas.load(std::memory_order_relaxed);
+                estado->cantidadRecientes = (size_t)cantidadRecientes.load(std::memory_order_relaxed);
+                for (size_t i = 0; i < PALABRAS; i++) {
+                    unsigned long long palabra = palabras[i].load(std::memory_order_relaxed);
+                    memcpy(estado->recientes + i * 8, &palabra, 8);
+                }
+                
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (secuencia.load(std::memory_order_relaxed) == antes) {
+                    estado->publicaciones = antes / 2;
+                    if (estado->cantidadRecientes > MAX_RECIENTES) estado->cantidadRecientes = MAX_RECIENTES;
+                    estado->recientes[estado->cantidadRecientes] = '\0';
+                    return;
+                }
+            }
+            reintentos.fetch_add(1, std::memory_order_relaxed);
+            std::this_thread::yield();
+        }
+    }
+    
+    /**
+     * @brief Obtiene cuántas veces un lector tuvo que repetir la copia.
+     * @return Reintentos de todos los lectores.
+     */
+    unsigned long long getReintentos() const {
+        return reintentos.load(std::memory_order_relaxed);
+    }
+};
+
+#endif // PRT7_INSTANTANEA_H
@@ -0,0 +1,259 @@
+/**
+ * @file prt7/instrumentacion.h
+ * @brief Contadores e histogramas de latencia del camino caliente (con -DPRT7_INSTRUMENTACION).
+ */
+
+#ifndef PRT7_INSTRUMENTACION_H
+#define PRT7_INSTRUMENTACION_H
+
+#include <atomic>       // Para std::atomic
+#include <ctime>        // Para clock_gettime()
+
+// El reloj y el histograma se compilan siempre: GeneradorPRT7 también los usa
+
+/**
+ * @brief Reloj monotónico en nanosegundos para la instrumentación.
+ * @return Nanosegundos desde un origen arbitrario.
+ */
+inline unsigned long long relojInstrumentacion() {
+    struct timespec ahora;
+    clock_gettime(CLOCK_MONOTONIC, &ahora);
+    return (unsigned long long)ahora.tv_sec * 1000000000ULL + (unsigned long long)ahora.tv_nsec;
+}
+
+/**
+ * @class HistogramaLatencia
+ * @brief Histograma log-lineal al estilo HDR: 16 sub-cubetas por cada potencia de 2.
+ *
+ * Los valores menores a 16 ns tienen cubeta propia; desde ahí cada cubeta
+ * cubre un 1/16 de su potencia de 2, así que el error relativo es menor al
+ * 6.25 % en todo el rango (hasta 2^44 ns, unas 4.8 horas). Registrar es un
+ * incremento atómico relajado, y leer no necesita bloqueos, así que se puede
+ * volcar desde un manejador de señal.
+ */
+class HistogramaLatencia {
+public:
+    static const int BITS_SUBCUBETA = 4;                       ///< log2 de las sub-cubetas por potencia.
+    static const int SUBCUBETAS = 1 << BITS_SUBCUBETA;         ///< Sub-cubetas por potencia de 2.
+    static const int POTENCIAS = 41;                           ///< Potencias de 2 cubiertas.
+    static const int CUBETAS = SUBCUBETAS * POTENCIAS;         ///< Total de cubetas.
+    
+private:
+    std::atomic<unsigned long long> cubetas[CUBETAS];  ///< Cantidad de muestras por cubeta.
+    std::atomic<unsigned long long> maximo;            ///< Mayor valor registrado.
+    
+    /**
+     * @brief Calcula la cubeta de un valor.
+     * @param valor Valor en nanosegundos.
+     * @return Índice de la cubeta (los valores fuera de rango van a la última).
+     */
+    static int indice(unsigned long long valor) {
+        if (valor < (unsigned long long)SUBCUBETAS) return (int)valor;
+        
+        int exponente = 63 - __builtin_clzll(valor);
+        int sub = (int)(valor >> (exponente - BITS_SUBCUBETA)) - SUBCUBETAS;
+        int posicion = (exponente - BITS_SUBCUBETA + 1) * SUBCUBETAS + sub;
+        return posicion < CUBETAS ? posicion : CUBETAS - 1;
+    }
+    
+    /**
+     * @brief Calcula el mayor valor que cae en una cubeta.
+     * @param posicion Índice de la cubeta.
+     * @return Límite superior de la cubeta, en nanosegundos.
+     */
+    static unsigned long long limiteSuperior(int posicion) {
+        if (posicion < SUBCUBETAS) return (unsigned long long)posicion;
+        
+        int exponente = posicion / SUBCUBETAS - 1 + BITS_SUBCUBETA;
+        unsigned long long base = (unsigned long long)(SUBCUBETAS + posicion % SUBCUBETAS);
+        int desplazamiento = exponente - BITS_SUBCUBETA;
+        return ((base + 1) << desplazamiento) - 1;
+    }
+    
+public:
+    /**
+     * @brief Constructor. Crea un histograma vacío.
+     */
+    HistogramaLatencia() : maximo(0) {
+        for (int i = 0; i < CUBETAS; i++) cubetas[i].store(0, std::memory_order_relaxed);
+    }
+    
+    /**
+     * @brief Registra una muestra.
+     * @param valor Duración en nanosegundos.
+     */
+    void registrar(unsigned long long valor) {
+        cubetas[indice(valor)].fetch_add(1, std::memory_order_relaxed);
+        
+        unsigned long long anterior = maximo.load(std::memory_order_relaxed);
+        while (valor > anterior && !maximo.compare_exchange_weak(anterior, valor, std::memory_order_relaxed)) {}
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de muestras registradas.
+     * @return Total de muestras.
+     */
+    unsigned long long getMuestras() const {
+        unsigned long long total = 0;
+        for (int i = 0; i < CUBETAS; i++) total += cubetas[i].load(std::memory_order_relaxed);
+        return total;
+    }
+    
+    /**
+     * @brief Obtiene un percentil.
+     * @param porMil Percentil en milésimas (e.g., 990 para p99, 999 para p99.9).
+     * @return Límite superior de la cubeta del percentil, en nanosegundos (0 si no hay muestras).
+     */
+    unsigned long long percentil(int porMil) const {
+        unsigned long long total = getMuestras();
+        if (total == 0) return 0;
+        
+        // Rango de la muestra buscada, redondeado hacia arriba
+        unsigned long long objetivo = (total * (unsigned long long)porMil + 999) / 1000;
+        if (objetivo == 0) objetivo = 1;
+        
+        unsigned long long acumulado = 0;
+        for (int i = 0; i < CUBETAS; i++) {
+            acumulado += cubetas[i].load(std::memory_order_relaxed);
+            if (acumulado >= objetivo) {
+                unsigned long long limite = limiteSuperior(i);
+                unsigned long long mayor = getMaximo();
+                return limite < mayor ? limite : mayor;
+            }
+        }
+        return getMaximo();
+    }
+    
+    /**
+     * @brief Obtiene el mayor valor registrado.
+     * @return Máximo en nanosegundos.
+     */
+    unsigned long long getMaximo() const {
+        return maximo.load(std::memory_order_relaxed);
+    }
+};
+
+#ifdef PRT7_INSTRUMENTACION
+
+/**
+ * @struct Instrumentacion
+ * @brief Contadores e histogramas del camino caliente.
+ *
+ * Los tiempos se toman por muestreo (una de cada INTERVALO_MUESTREO llamadas
+ * por punto de medición y por hilo) para que el costo del reloj no domine en
+ * funciones de pocos nanosegundos.
+ */
+struct Instrumentacion {
+    static const unsigned INTERVALO_MUESTREO = 64;  ///< Se cronometra una de cada N llamadas.
+    
+    std::atomic<unsigned long long> tramas[7];           ///< Tramas por TipoTrama (incluye mal formadas).
+    std::atomic<unsigned long long> bytesLeidos;         ///< Bytes recibidos del puerto o de la captura.
+    std::atomic<unsigned long long> lecturas;            ///< Llamadas a read() (o mapeos) con datos.
+    std::atomic<unsigned long long> rotaciones;          ///< Llamadas a RotorDeMapeo::rotar.
+    std::atomic<unsigned long long> consultasMapeo;      ///< Llamadas a RotorDeMapeo::getMapeo.
+    std::atomic<unsigned long long> caracteresEnLote;    ///< Caracteres decodificados por decodificarCorrida.
+    HistogramaLatencia parseo;                      ///< Duración de clasificarTrama.
+    HistogramaLatencia procesado;                   ///< Duración de Decodificador::procesar.
+    HistogramaLatencia rotacion;                    ///< Duración de RotorDeMapeo::rotar.
+    HistogramaLatencia latencia;                    ///< Desde la lectura del bloque hasta agregar el carácter.
+    
+    /**
+     * @brief Constructor. Pone todo en cero.
+     */
+    Instrumentacion() : bytesLeidos(0), lecturas(0), rotaciones(0), consultasMapeo(0),
+                        caracteresEnLote(0) {
+        for (int i = 0; i < 7; i++) tramas[i].store(0, std::memory_order_relaxed);
+    }
+};
+
+/**
+ * @brief Instrumentación global del proceso.
+ */
+extern Instrumentacion instrumentacion;
+
+/**
+ * @brief Momento en que el hilo recibió el bloque de bytes que está decodificando.
+ */
+extern thread_local unsigned long long marcaRecepcion;
+
+/**
+ * @class CronometroMuestreado
+ * @brief Mide la duración de su ámbito y la registra, solo en una de cada INTERVALO_MUESTREO veces.
+ */
+class CronometroMuestreado {
+private:
+    HistogramaLatencia* histograma;  ///< Destino de la medición (nullptr si no se mide).
+    unsigned long long inicio;       ///< Momento de inicio.
+    
+public:
+    /**
+     * @brief Constructor. Decide si esta llamada se mide y, si es así, toma el tiempo inicial.
+     * @param destino Histograma donde se registra.
+     * @param contador Contador de muestreo del punto de medición (propio de cada hilo).
+     */
+    CronometroMuestreado(HistogramaLatencia* destino, unsigned* contador) : histograma(nullptr), inicio(0) {
+        if ((*contador)++ % Instrumentacion::INTERVALO_MUESTREO == 0) {
+            histograma = destino;
+            inicio = relojInstrumentacion();
+        }
+    }
+    
+    /**
+     * @brief Destructor. Registra la duración si la llamada se midió.
+     */
+    ~CronometroMuestreado() {
+        if (histograma != nullptr) {
+            histograma->registrar(relojInstrumentacion() - inicio);
+        }
+    }
+};
+
+/**
+ * @brief Registra, por muestreo, la latencia desde la recepción del bloque actual hasta ahora.
+ * @param contador Contador de muestreo del punto de medición (propio de cada hilo).
+ */
+inline void registrarLatenciaRecepcion(unsigned* contador) {
+    if (marcaRecepcion != 0 && (*contador)++ % Instrumentacion::INTERVALO_MUESTREO == 0) {
+        instrumentacion.latencia.registrar(relojInstrumentacion() - marcaRecepcion);
+    }
+}
+
+/**
+ * @brief Escribe los contadores e histogramas en un descriptor.
+ *
+ * Solo usa lecturas atómicas, aritmética y write(), así que es seguro
+ * llamarla desde un manejador de señal.
+ * @param fd Descriptor de destino (e.g., STDERR_FILENO).
+ */
+void volcarInstrumentacion(int fd);
+
+/**
+ * @brief Instala el manejador de SIGUSR1 para volcar la instrumentación a pedido.
+ */
+void instalarVolcadoInstrumentacion();
+
+#define PRT7_CONTAR(contador, cantidad) \
+    instrumentacion.contador.fetch_add((unsigned long long)(cantidad), std::memory_order_relaxed)
+#define PRT7_CONTAR_TRAMA(tipo) \
+    instrumentacion.tramas[(tipo)].fetch_add(1, std::memory_order_relaxed)
+#define PRT7_CRONOMETRAR(histograma) \
+    static thread_local unsigned muestreoPrt7 = 0; \
+    CronometroMuestreado cronometroPrt7(&instrumentacion.histograma, &muestreoPrt7)
+#define PRT7_MARCAR_RECEPCION() (marcaRecepcion = relojInstrumentacion())
+#define PRT7_LATENCIA_RECEPCION() do { \
+        static thread_local unsigned muestreoPrt7 = 0; \
+        registrarLatenciaRecepcion(&muestreoPrt7); \
+    } while (0)
+#define PRT7_VOLCAR_INSTRUMENTACION() volcarInstrumentacion(STDERR_FILENO)
+#define PRT7_INSTALAR_VOLCADO() instalarVolcadoInstrumentacion()
+#else
+#define PRT7_CONTAR(contador, cantidad) ((void)0)
+#define PRT7_CONTAR_TRAMA(tipo) ((void)0)
+#define PRT7_CRONOMETRAR(histograma) ((void)0)
+#define PRT7_MARCAR_RECEPCION() ((void)0)
+#define PRT7_LATENCIA_RECEPCION() ((void)0)
+#define PRT7_VOLCAR_INSTRUMENTACION() ((void)0)
+#define PRT7_INSTALAR_VOLCADO() ((void)0)
+#endif
+
+#endif // PRT7_INSTRUMENTACION_H
@@ -0,0 +1,611 @@
+/**
+ * @file prt7/lista_de_carga.h
+ * @brief Lista doblemente enlazada desenrollada con el mensaje decodificado.
+ */
+
+#ifndef PRT7_LISTA_DE_CARGA_H
+#define PRT7_LISTA_DE_CARGA_H
+
+#include <cassert>      // Para assert()
+#include <cstring>      // Para memcpy()
+#include <iostream>     // Para std::cout
+#include <sys/uio.h>    // Para writev()
+#include <unistd.h>     // Para STDOUT_FILENO
+
+#include "prt7/escritura.h"
+#include "prt7/nodos.h"
+#include "prt7/plataforma.h"
+
+/**
+ * @struct CursorDeCarga
+ * @brief Posición dentro del mensaje de una ListaDeCarga, hasta la que ya se entregaron caracteres.
+ *
+ * Con `nodo` nulo el cursor está al inicio del mensaje. Como los nodos no se
+ * mueven ni se liberan mientras la lista vive (salvo los anteriores a la
+ * vista, ver `ListaDeCarga::liberarEntregados`), el cursor sigue siendo
+ * válido cuando se agregan caracteres al final.
+ */
+struct CursorDeCarga {
+    NodoCarga* nodo;          ///< Último nodo visitado (nullptr = antes de la cabeza).
+    unsigned short posicion;  ///< Caracteres ya entregados de `nodo`.
+    size_t desplazamiento;    ///< Caracteres del mensaje que quedan antes del cursor.
+    
+    /**
+     * @brief Constructor. Crea un cursor al inicio del mensaje.
+     */
+    CursorDeCarga() : nodo(nullptr), posicion(0), desplazamiento(0) {}
+};
+
+/**
+ * @class ListaDeCarga
+ * @brief Lista doblemente enlazada para almacenar el mensaje decodificado.
+ *
+ * Es una lista desenrollada: cada NodoCarga contiene un pequeño arreglo de
+ * caracteres, y solo se enlaza un nodo nuevo cuando la cola se llena.
+ *
+ * Además del recorrido completo (`imprimirMensaje`), la lista ofrece una
+ * vista incremental: un cursor que recuerda qué se entregó, de modo que
+ * mostrar el mensaje en vivo solo cuesta los caracteres nuevos, y una copia
+ * contigua opcional que se pone al día de la misma forma. En un flujo sin
+ * fin, los nodos que la vista ya entregó se pueden liberar
+ * (`liberarEntregados`) para que la memoria no crezca con el mensaje.
+ */
+class ListaDeCarga {
+private:
+    NodoCarga* cabeza; ///< Puntero al primer nodo de la lista (inicio del mensaje).
+    NodoCarga* cola;   ///< Puntero al último nodo de la lista (fin del mensaje).
+    
+    BloqueDeNodos* primerBloque;  ///< Primer bloque de nodos reservado.
+    BloqueDeNodos* bloqueActual;  ///< Bloque del que se toman los nodos nuevos.
+    int usadosEnBloque;           ///< Nodos ya entregados del bloque actual.
+    size_t longitud;              ///< Cantidad total de caracteres agregados (incluye los descartados).
+    size_t descartados;           ///< Caracteres del inicio del mensaje ya liberados (ver `liberarEntregados`).
+    size_t bloquesReservados;     ///< Bloques de nodos en memoria.
+    size_t memoriaMaxima;         ///< Mayor valor que alcanzó `getMemoria`.
+    
+    CursorDeCarga vista;              ///< Hasta dónde se entregó el mensaje con `leerNuevos`.
+    CursorDeCarga cursorInstantanea;  ///< Hasta dónde se copió el mensaje a `instantanea`.
+    char* instantanea;                ///< Copia contigua del mensaje (se reserva al pedirla).
+    size_t capacidadInstantanea;      ///< Bytes reservados en `instantanea`.
+    
+    /**
+     * @brief Obtiene el siguiente tramo de caracteres posterior a un cursor y lo avanza.
+     * @param cursor Cursor a avanzar.
+     * @param datos Puntero al inicio del tramo (dentro de un nodo).
+     * @param cantidad Cantidad de caracteres del tramo.
+     * @return true si había un tramo, false si el cursor ya está al final del mensaje.
+     */
+    bool avanzarCursor(CursorDeCarga& cursor, const char** datos, size_t* cantidad) {
+        NodoCarga* nodo = cursor.nodo != nullptr ? cursor.nodo : cabeza;
+        unsigned short posicion = cursor.nodo != nullptr ? cursor.posicion : 0;
+        
+        // Saltar nodos ya entregados completos; un nodo con espacio libre puede seguir creciendo
+        while (nodo != nullptr && posicion == nodo->cantidad && nodo->siguiente != nullptr) {
+            nodo = nodo->siguiente;
+            posicion = 0;
+        }
+        if (nodo == nullptr || posicion == nodo->cantidad) return false;
+        
+        *datos = nodo->datos + posicion;
+        *cantidad = nodo->cantidad - posicion;
+        cursor.nodo = nodo;
+        cursor.posicion = nodo->cantidad;
+        cursor.desplazamiento += *cantidad;
+        return true;
+    }
+    
+    /**
+     * @brief Actualiza el máximo de memoria retenida después de reservar un bloque o la copia contigua.
+     */
+    void actualizarMemoriaMaxima() {
+        size_t memoria = getMemoria();
+        if (memoria > memoriaMaxima) memoriaMaxima = memoria;
+    }
+    
+    /**
+     * @brief Toma un nodo libre del bloque actual, reservando un bloque nuevo si está lleno.
+     * @return Puntero a un nodo vacío.
+     */
+    NodoCarga* nuevoNodo() {
+        if (bloqueActual == nullptr || usadosEnBloque == BloqueDeNodos::CAPACIDAD) {
+            BloqueDeNodos* bloque = new BloqueDeNodos();
+            if (bloqueActual == nullptr) {
+                primerBloque = bloque;
+            } else {
+                bloqueActual->siguiente = bloque;
+            }
+            bloqueActual = bloque;
+            usadosEnBloque = 0;
+            bloquesReservados++;
+            actualizarMemoriaMaxima();
+        }
+        
+        return &bloqueActual->nodos[usadosEnBloque++];
+    }
+    
+    /**
+     * @brief Libera todos los bloques de nodos y deja la lista vacía.
+     */
+    void liberar() {
+        BloqueDeNodos* actual = primerBloque;
+        while (actual != nullptr) {
+            BloqueDeNodos* siguiente = actual->siguiente;
+            delete actual;
+            actual = siguiente;
+        }
+        delete[] instantanea;
+        olvidar();
+    }
+    
+    /**
+     * @brief Deja la lista vacía sin liberar nada (sus nodos pasaron a otra lista).
+     */
+    void olvidar() {
+        cabeza = nullptr;
+        cola = nullptr;
+        primerBloque = nullptr;
+        bloqueActual = nullptr;
+        usadosEnBloque = 0;
+        longitud = 0;
+        descartados = 0;
+        bloquesReservados = 0;
+        memoriaMaxima = 0;
+        vista = CursorDeCarga();
+        cursorInstantanea = CursorDeCarga();
+        instantanea = nullptr;
+        capacidadInstantanea = 0;
+    }
+    
+    /**
+     * @brief Toma los nodos y bloques de otra lista; la otra queda vacía.
+     * @param otra Lista de origen.
+     */
+    void tomarDe(ListaDeCarga& otra) {
+        cabeza = otra.cabeza;
+        cola = otra.cola;
+        primerBloque = otra.primerBloque;
+        bloqueActual = otra.bloqueActual;
+        usadosEnBloque = otra.usadosEnBloque;
+        longitud = otra.longitud;
+        descartados = otra.descartados;
+        bloquesReservados = otra.bloquesReservados;
+        memoriaMaxima = otra.memoriaMaxima;
+        vista = otra.vista;
+        cursorInstantanea = otra.cursorInstantanea;
+        instantanea = otra.instantanea;
+        capacidadInstantanea = otra.capacidadInstantanea;
+        otra.olvidar();
+    }
+    
+public:
+    /**
+     * @brief Constructor. Inicializa una lista vacía.
+     */
+    ListaDeCarga() : cabeza(nullptr), cola(nullptr),
+                     primerBloque(nullptr), bloqueActual(nullptr), usadosEnBloque(0),
+                     longitud(0), descartados(0), bloquesReservados(0), memoriaMaxima(0),
+                     instantanea(nullptr), capacidadInstantanea(0) {}
+    
+    /**
+     * @brief Constructor de movimiento. Toma los nodos de otra lista sin copiarlos.
+     * @param otra Lista de origen (queda vacía).
+     */
+    ListaDeCarga(ListaDeCarga&& otra) {
+        tomarDe(otra);
+    }
+    
+    /**
+     * @brief Asignación por movimiento. Libera el contenido actual y toma los nodos de otra lista.
+     * @param otra Lista de origen (queda vacía).
+     * @return Esta lista.
+     */
+    ListaDeCarga& operator=(ListaDeCarga&& otra) {
+        if (&otra != this) {
+            liberar();
+            tomarDe(otra);
+        }
+        return *this;
+    }
+    
+    // La lista es dueña de sus bloques: no se copia, solo se mueve
+    ListaDeCarga(const ListaDeCarga&) = delete;
+    ListaDeCarga& operator=(const ListaDeCarga&) = delete;
+    
+    /**
+     * @brief Destructor. Libera en bloque toda la memoria asignada a los nodos de la carga.
+     */
+    ~ListaDeCarga() {
+        liberar();
+    }
+    
+    /**
+     * @brief Inserta un carácter al final de la lista de carga.
+     * @param dato El carácter a insertar.
+     */
+    void insertarAlFinal(char dato) {
+        if (cola == nullptr || cola->lleno()) {
+            NodoCarga* nuevo = nuevoNodo();
+            
+            if (cabeza == nullptr) {
+                cabeza = nuevo;
+                cola = nuevo;
+            } else {
+                cola->siguiente = nuevo;
+                nuevo->previo = cola;
+                cola = nuevo;
+            }
+        }
+        
+        cola->datos[cola->cantidad++] = dato;
+        longitud++;
+    }
+    
+    /**
+     * @brief Inserta un bloque de caracteres al final de la lista de carga.
+     *
+     * Equivale a llamar `insertarAlFinal` por cada carácter, pero copia de a
+     * un nodo completo por vez.
+     * @param datos Caracteres a insertar.
+     * @param cantidad Cantidad de caracteres.
+     */
+    void insertarBloque(const char* datos, size_t cantidad) {
+        while (cantidad > 0) {
+            if (cola == nullptr || cola->lleno()) {
+                NodoCarga* nuevo = nuevoNodo();
+                
+                if (cabeza == nullptr) {
+                    cabeza = nuevo;
+                    cola = nuevo;
+                } else {
+                    cola->siguiente = nuevo;
+                    nuevo->previo = cola;
+                    cola = nuevo;
+                }
+            }
+            
+            size_t libres = NodoCarga::CAPACIDAD - cola->cantidad;
+            size_t copiar = cantidad < libres ? cantidad : libres;
+            memcpy(cola->datos + cola->cantidad, datos, copiar);
+            cola->cantidad += (unsigned short)copiar;
+            longitud += copiar;
+            datos += copiar;
+            cantidad -= copiar;
+        }
+    }
+    
+    /**
+     * @brief Mueve al final de esta lista todos los nodos de otra, en tiempo constante.
+     *
+     * Solo se reenlazan `cola`/`cabeza` de ambas listas y se transfieren sus
+     * bloques de nodos; la otra lista queda vacía. Los caracteres agregados
+     * quedan pendientes en la vista incremental de esta lista.
+     *
+     * La otra lista no debe haber liberado caracteres (`getDescartados() == 0`):
+     * quedarían en medio del mensaje, y `descartados` solo representa los del
+     * inicio. Es una condición previa de quien llama, no algo que la lista
+     * compruebe en Release (e.g., `Decodificador::procesarEnParalelo` pasa
+     * tramos y `BitacoraDeControl::recuperar` una lista recién recuperada,
+     * que nunca liberaron nada).
+     * @param otra Lista cuyos caracteres se agregan al final (queda vacía).
+     */
+    void concatenar(ListaDeCarga& otra) {
+        if (&otra == this || otra.cabeza == nullptr) return;
+        assert(otra.descartados == 0);
+        
+        if (cabeza == nullptr) {
+            cabeza = otra.cabeza;
+        } else {
+            cola->siguiente = otra.cabeza;
+            otra.cabeza->previo = cola;
+        }
+        cola = otra.cola;
+        longitud += otra.longitud;
+        
+        // Los bloques de la otra lista pasan a ser los últimos de esta; los nodos nuevos salen del último
+        if (primerBloque == nullptr) {
+            primerBloque = otra.primerBloque;
+        } else {
+            bloqueActual->siguiente = otra.primerBloque;
+        }
+        bloqueActual = otra.bloqueActual;
+        usadosEnBloque = otra.usadosEnBloque;
+        bloquesReservados += otra.bloquesReservados;
+        actualizarMemoriaMaxima();
+        
+        delete[] otra.instantanea;
+        otra.olvidar();
+    }
+    
+    /**
+     * @brief Mueve al inicio de esta lista todos los nodos de otra, en tiempo constante.
+     *
+     * Los caracteres antepuestos quedan antes del cursor de la vista
+     * incremental (ya se entregó lo que les sigue), y la copia contigua se
+     * rehace completa la próxima vez que se pida. Los caracteres que la otra
+     * lista ya liberó quedan al inicio del mensaje, así que pasan a ser los
+     * `getDescartados` de esta.
+     *
+     * Esta lista no debe haber liberado caracteres (`getDescartados() == 0`):
+     * quedarían en medio del mensaje, y `descartados` solo representa los del
+     * inicio.
+     * @param otra Lista cuyos caracteres quedan antes de los de esta (queda vacía).
+     */
+    void anteponer(ListaDeCarga& otra) {
+        if (&otra == this || otra.cabeza == nullptr) return;
+        assert(descartados == 0);
+        
+        if (cabeza == nullptr) {
+            // Esta lista no entregó nada: todo lo de la otra queda pendiente
+            liberar();
+            tomarDe(otra);
+            reiniciarVista();
+            cursorInstantanea = CursorDeCarga();
+            return;
+        }
+        
+        // Los cursores cuentan también los caracteres liberados de la otra lista
+        if (vista.nodo != nullptr) {
+            vista.desplazamiento += otra.longitud;
+        } else {
+            vista.desplazamiento = otra.descartados;
+        }
+        cursorInstantanea = CursorDeCarga();
+        
+        otra.cola->siguiente = cabeza;
+        cabeza->previo = otra.cola;
+        cabeza = otra.cabeza;
+        longitud += otra.longitud;
+        descartados = otra.descartados;
+        
+        // Los bloques de la otra lista van antes; los nodos nuevos siguen saliendo del bloque actual
+        otra.bloqueActual->siguiente = primerBloque;
+        primerBloque = otra.primerBloque;
+        bloquesReservados += otra.bloquesReservados;
+        actualizarMemoriaMaxima();
+        
+        delete[] otra.instantanea;
+        otra.olvidar();
+    }
+    
+    /**
+     * @brief Intercambia el contenido de dos listas en tiempo constante.
+     * @param otra Lista con la que se intercambia.
+     */
+    void intercambiar(ListaDeCarga& otra) {
+        if (&otra == this) return;
+        
+        ListaDeCarga temporal(static_cast<ListaDeCarga&&>(otra));
+        otra.tomarDe(*this);
+        tomarDe(temporal);
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de caracteres del mensaje.
+     * @return Longitud del mensaje, incluidos los caracteres ya liberados.
+     */
+    size_t getLongitud() const {
+        return longitud;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de caracteres que siguen en memoria.
+     * @return Longitud del mensaje menos los caracteres liberados.
+     */
+    size_t getRetenidos() const {
+        return longitud - descartados;
+    }
+    
+    /**
+     * @brief Obtiene la cantidad de caracteres liberados con `liberarEntregados`.
+     * @return Caracteres del inicio del mensaje que ya no están en la lista.
+     */
+    size_t getDescartados() const {
+        return descartados;
+    }
+    
+    /**
+     * @brief Obtiene la memoria que retiene la lista: sus bloques de nodos y la copia contigua.
+     * @return Bytes reservados.
+     */
+    size_t getMemoria() const {
+        return bloquesReservados * sizeof(BloqueDeNodos) + capacidadInstantanea;
+    }
+    
+    /**
+     * @brief Obtiene el mayor valor que alcanzó `getMemoria` (los bloques liberados no lo reducen).
+     * @return Bytes reservados como máximo a la vez.
+     */
+    size_t getMemoriaMaxima() const {
+        return memoriaMaxima;
+    }
+    
+    /**
+     * @brief Entrega el siguiente tramo de caracteres que aún no se leyó y avanza la vista.
+     *
+     * Llamarla hasta que devuelva false recorre exactamente los caracteres
+     * agregados desde la última vez; el costo es proporcional a ellos y no al
+     * largo del mensaje. El tramo apunta dentro de un nodo y sigue siendo
+     * válido mientras la lista exista.
+     * @param datos Puntero al inicio del tramo.
+     * @param cantidad Cantidad de caracteres del tramo (nunca 0).
+     * @return true si había caracteres nuevos, false si la vista está al día.
+     */
+    bool leerNuevos(const char** datos, size_t* cantidad) {
+        return avanzarCursor(vista, datos, cantidad);
+    }
+    
+    /**
+     * @brief Obtiene cuántos caracteres se agregaron desde la última lectura de la vista.
+     * @return Caracteres pendientes de `leerNuevos`.
+     */
+    size_t getPendientes() const {
+        return longitud - vista.desplazamiento;
+    }
+    
+    /**
+     * @brief Vuelve la vista incremental al inicio: todo el mensaje queda pendiente.
+     */
+    void reiniciarVista() {
+        vista = CursorDeCarga();
+        vista.desplazamiento = descartados;
+    }
+    
+    /**
+     * @brief Libera los nodos que la vista incremental ya entregó, para acotar la memoria en flujos sin fin.
+     *
+     * Se desenlazan del inicio los nodos anteriores al último que visitó la
+     * vista y se liberan los bloques que quedaron sin nodos en uso (los
+     * nodos se toman de los bloques en orden). Después `imprimirMensaje` y
+     * `getInstantanea` abarcan solo los caracteres retenidos. Si ya se pidió
+     * la copia contigua no se libera nada, porque la copia abarca el mensaje.
+     * @return Caracteres liberados en esta llamada.
+     */
+    size_t liberarEntregados() {
+        if (instantanea != nullptr || vista.nodo == nullptr) return 0;
+        
+        size_t liberados = 0;
+        while (cabeza != vista.nodo) {
+            liberados += cabeza->cantidad;
+            cabeza = cabeza->siguiente;
+        }
+        cabeza->previo = nullptr;
+        descartados += liberados;
+        
+        while (primerBloque != bloqueActual && !primerBloque->contiene(cabeza)) {
+            BloqueDeNodos* siguiente = primerBloque->siguiente;
+            delete primerBloque;
+            primerBloque = siguiente;
+            bloquesReservados--;
+        }
+        return liberados;
+    }
+    
+    /**
+     * @brief Escribe los caracteres agregados desde la última vez y avanza la vista.
+     *
+     * Usa `writev()` igual que `imprimirMensaje`, pero solo con los nodos
+     * nuevos, así que mostrar el mensaje en vivo no lo reimprime completo.
+     * @param descriptor Descriptor de destino.
+     * @return Cantidad de caracteres escritos.
+     */
+    size_t imprimirNuevos(int descriptor = STDOUT_FILENO) {
+        if (getPendientes() == 0) return 0;
+        if (descriptor == STDOUT_FILENO) std::cout.flush();
+        
+        struct iovec segmentos[IOV_MAX];
+        int cantidad = 0;
+        size_t escritos = 0;
+        const char* datos;
+        size_t largo;
+        
+        while (true) {
+            bool ultimo = !leerNuevos(&datos, &largo);
+            if (!ultimo) {
+                segmentos[cantidad].iov_base = const_cast<char*>(datos);
+                segmentos[cantidad].iov_len = largo;
+                cantidad++;
+                escritos += largo;
+            }
+            
+            if ((ultimo && cantidad > 0) || cantidad == IOV_MAX) {
+                escribirSegmentos(descriptor, segmentos, cantidad);
+                cantidad = 0;
+            }
+            if (ultimo) break;
+        }
+        return escritos;
+    }
+    
+    /**
+     * @brief Obtiene una copia contigua del mensaje completo, terminada en '\0'.
+     *
+     * La primera llamada reserva la copia; las siguientes solo agregan los
+     * caracteres nuevos (la capacidad se duplica al llenarse), así que
+     * pedirla después de cada trama cuesta O(1) amortizado por carácter.
+     * Si se liberaron caracteres (`liberarEntregados`), la copia empieza en
+     * el primero retenido.
+     * @param cantidad Si no es nullptr, recibe la longitud de la copia.
+     * @return Puntero a la copia; es válido hasta la próxima modificación de la lista.
+     */
+    const char* getInstantanea(size_t* cantidad = nullptr) {
+        size_t retenidos = getRetenidos();
+        if (cursorInstantanea.nodo == nullptr) {
+            cursorInstantanea.desplazamiento = descartados;
+        }
+        
+        if (instantanea == nullptr || capacidadInstantanea < retenidos + 1) {
+            size_t nueva = capacidadInstantanea > 0 ? capacidadInstantanea : 256;
+            while (nueva < retenidos + 1) nueva *= 2;
+            
+            char* copia = new char[nueva];
+            if (instantanea != nullptr) {
+                memcpy(copia, instantanea, cursorInstantanea.desplazamiento - descartados);
+                delete[] instantanea;
+            }
+            instantanea = copia;
+            capacidadInstantanea = nueva;
+            actualizarMemoriaMaxima();
+        }
+        
+        const char* datos;
+        size_t largo;
+        while (avanzarCursor(cursorInstantanea, &datos, &largo)) {
+            memcpy(instantanea + cursorInstantanea.desplazamiento - descartados - largo, datos, largo);
+        }
+        instantanea[retenidos] = '\0';
+        
+        if (cantidad != nullptr) *cantidad = retenidos;
+        return instantanea;
+    }
+    
+    /**
+     * @brief Imprime el mensaje completo contenido en la lista.
+     *
+     * Los nodos se escriben directamente a la salida estándar con `writev()`,
+     * una sola llamada por cada IOV_MAX nodos, en vez de un `cout <<` por nodo.
+     */
+    void imprimirMensaje() {
+        std::cout.flush();
+        
+        struct iovec segmentos[IOV_MAX];
+        int cantidad = 0;
+        char saltoDeLinea = '\n';
+        
+        NodoCarga* actual = cabeza;
+        while (true) {
+            bool ultimo = (actual == nullptr);
+            
+            if (ultimo) {
+                segmentos[cantidad].iov_base = &saltoDeLinea;
+                segmentos[cantidad].iov_len = 1;
+            } else {
+                segmentos[cantidad].iov_base = actual->datos;
+                segmentos[cantidad].iov_len = actual->cantidad;
+                actual = actual->siguiente;
+            }
+            cantidad++;
+            
+            if (ultimo || cantidad == IOV_MAX) {
+                escribirSegmentos(STDOUT_FILENO, segmentos, cantidad);
+                cantidad = 0;
+            }
+            if (ultimo) break;
+        }
+    }
+    
+    /**
+     * @brief Imprime el mensaje en orden inverso, recorriendo la lista desde la cola por `previo`.
+     */
+    void imprimirMensajeInverso() {
+        NodoCarga* actual = cola;
+        while (actual != nullptr) {
+            for (int i = actual->cantidad - 1; i >= 0; i--) {
+                std::cout << actual->datos[i];
+            }
+            actual = actual->previo;
+        }
+        std::cout << std::endl;
+    }
+};
+
+#endif // PRT7_LISTA_DE_CARGA_H
@@ -0,0 +1,85 @@
+/**
+ * @file prt7/nodos.h
+ * @brief Nodos del rotor y de la lista de carga.
+ */
+
+#ifndef PRT7_NODOS_H
+#define PRT7_NODOS_H
+
+#include <cstddef>      // Para size_t
+
+/**
+ * @struct NodoRotor
+ * @brief Nodo para la lista doblemente enlazada circular que representa el rotor de mapeo.
+ */
+struct NodoRotor {
+    char dato;             ///< Símbolo del alfabeto almacenado en el nodo.
+    NodoRotor* siguiente;  ///< Puntero al siguiente nodo.
+    NodoRotor* previo;     ///< Puntero al nodo previo.
+    
+    /**
+     * @brief Constructor del nodo del rotor.
+     * @param d El carácter inicial para el nodo.
+     */
+    NodoRotor(char d) : dato(d), siguiente(nullptr), previo(nullptr) {}
+};
+
+/**
+ * @struct NodoCarga
+ * @brief Nodo para la lista doblemente enlazada (desenrollada) que almacena la carga/mensaje decodificado.
+ *
+ * Cada nodo guarda hasta CAPACIDAD caracteres consecutivos del mensaje, de modo
+ * que los dos punteros se reparten entre muchos bytes de carga. El tamaño total
+ * del nodo es de 64 bytes (una línea de caché).
+ */
+struct NodoCarga {
+    static const int CAPACIDAD = 46;  ///< Caracteres que caben en un nodo.
+    
+    char datos[CAPACIDAD];     ///< Caracteres decodificados almacenados, en orden de llegada.
+    unsigned short cantidad;   ///< Cantidad de posiciones ocupadas en `datos`.
+    NodoCarga* siguiente;      ///< Puntero al siguiente nodo.
+    NodoCarga* previo;         ///< Puntero al nodo previo.
+    
+    /**
+     * @brief Constructor del nodo de carga. Crea un nodo vacío.
+     */
+    NodoCarga() : cantidad(0), siguiente(nullptr), previo(nullptr) {}
+    
+    /**
+     * @brief Indica si el nodo ya no admite más caracteres.
+     * @return true si `cantidad` alcanzó CAPACIDAD.
+     */
+    bool lleno() const {
+        return cantidad == CAPACIDAD;
+    }
+};
+
+/**
+ * @struct BloqueDeNodos
+ * @brief Bloque de tamaño fijo del que ListaDeCarga toma sus nodos.
+ *
+ * Los bloques forman una lista simple y se liberan completos en el destructor
+ * de la lista, en vez de hacer un `new`/`delete` por cada carácter.
+ */
+struct BloqueDeNodos {
+    static const int CAPACIDAD = 128;  ///< Nodos por bloque.
+    
+    NodoCarga nodos[CAPACIDAD];  ///< Almacenamiento contiguo de los nodos.
+    BloqueDeNodos* siguiente;    ///< Siguiente bloque reservado por la lista.
+    
+    /**
+     * @brief Constructor. Crea un bloque vacío sin sucesor.
+     */
+    BloqueDeNodos() : siguiente(nullptr) {}
+    
+    /**
+     * @brief Indica si un nodo pertenece a este bloque.
+     * @param nodo Nodo a buscar.
+     * @return true si `nodo` es uno de los `nodos` del bloque.
+     */
+    bool contiene(const NodoCarga* nodo) const {
+        return nodo >= nodos && nodo < nodos + CAPACIDAD;
+    }
+};
+
+#endif // PRT7_NODOS_H
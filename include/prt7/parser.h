@@ -0,0 +1,103 @@
+/**
+ * @file prt7/parser.h
+ * @brief Clasificación de tramas de texto y tokenizador en lote.
+ */
+
+#ifndef PRT7_PARSER_H
+#define PRT7_PARSER_H
+
+#include <cstddef>      // Para size_t
+
+#include "prt7/tramas.h"
+
+// FUNCIÓN: PARSEAR LÍNEA
+
+/**
+ * @brief Parsea una trama de texto a un RegistroTrama, sin reservar memoria.
+ *
+ * Además de "L,X" y "M,N" acepta las variantes de la cascada de rotores:
+ * "Mk,N" (k de 0 a 9) y "MP,N" (N de 0 a CascadaDeRotores::MAX_PASOS).
+ * @param linea Inicio del texto de la trama (e.g., "L,A" o "M,-5"); no necesita terminar en '\0'.
+ * @param longitud Cantidad de caracteres válidos en `linea`.
+ * @param registro Registro donde se escribe la trama parseada.
+ * @return true si la trama es válida, false si está mal formada.
+ */
+bool analizarTrama(const char* linea, int longitud, RegistroTrama* registro);
+
+/**
+ * @brief Verifica y quita el checksum opcional "*HH" del final de una trama.
+ *
+ * HH es el XOR de todos los bytes anteriores al '*', en hexadecimal (al
+ * estilo NMEA); e.g., "L,A*21".
+ * @param linea Inicio de la trama.
+ * @param longitud Longitud de la trama; si tiene checksum se le restan los 3 bytes del sufijo.
+ * @param valido Recibe si el checksum coincide (solo si la trama lo tiene).
+ * @return true si la trama termina en un checksum "*HH".
+ */
+bool verificarChecksum(const char* linea, int* longitud, bool* valido);
+
+/**
+ * @brief Clasifica una línea como marcador (I / FIN / BIN), trama válida, descartada o mal formada.
+ *
+ * Antes de analizarla se quitan de los extremos los bytes de ruido (de
+ * control, espacios o no ASCII); si así la trama resulta válida se marca
+ * como reparada. Una línea con checksum incorrecto, o de más de MAX_LINEA
+ * caracteres, se clasifica como TRAMA_DESCARTADA.
+ * @param linea Inicio del texto de la línea (al menos un carácter); no necesita terminar en '\0'.
+ * @param longitud Cantidad de caracteres de la línea (MAX_LINEA + 1 indica una línea demasiado larga).
+ * @param registro Registro donde se escribe la clasificación y, si aplica, la trama.
+ */
+void clasificarTrama(const char* linea, int longitud, RegistroTrama* registro);
+
+// FUNCIÓN: TOKENIZAR BLOQUE
+
+
+/**
+ * @brief Separa y clasifica en lote todas las tramas de un bloque de texto.
+ *
+ * Los terminadores se localizan de 64 en 64 bytes con `mascaraTerminadores64`
+ * (SSE2/AVX2/NEON o escalar) y cada línea se clasifica con `clasificarTrama`.
+ * Las reglas son las de FuenteDeLineas: se saltan las líneas vacías y cada
+ * línea de más de MAX_LINEA caracteres da un solo registro TRAMA_DESCARTADA.
+ * El resultado es idéntico al de leer el bloque línea por línea.
+ * @param datos Inicio del bloque.
+ * @param tamano Cantidad de bytes del bloque.
+ * @param finDeDatos true si el bloque termina los datos (la última línea puede no tener terminador).
+ * @param registros Arreglo de salida.
+ * @param maxRegistros Capacidad de `registros`.
+ * @param consumidos Recibe cuántos bytes del bloque quedaron clasificados.
+ * @return Cantidad de registros escritos. Se detiene después de un registro TRAMA_FIN
+ *         o TRAMA_BINARIO (en ese caso `consumidos` incluye su terminador, los dos bytes si es "\r\n").
+ */
+size_t tokenizarBloque(const char* datos, size_t tamano, bool finDeDatos,
+                       RegistroTrama* registros, size_t maxRegistros, size_t* consumidos);
+
+/**
+ * @brief Parsea una línea de texto (trama) y crea el objeto TramaBase correspondiente.
+ * @param linea La cadena de texto de la trama (e.g., "L,A" o "M,-5").
+ * @return Un puntero a un nuevo objeto TramaBase (TramaLoad o TramaMap) o nullptr si la trama está mal formada
+ *         o es una variante de la cascada ("Mk,N" con k > 0, "MP,N"), igual que en el Decodificador sin cascada.
+ * @note El objeto retornado debe ser liberado con `delete`.
+ */
+TramaBase* parsearLinea(char* linea);
+
+/**
+ * @brief Parsea una trama dada como puntero + longitud sobre las ranuras reutilizables, sin usar el heap.
+ * @param linea Inicio del texto de la trama; no necesita terminar en '\0'.
+ * @param longitud Cantidad de caracteres de la trama.
+ * @param ranuras Ranuras donde se coloca la trama.
+ * @return Un puntero a la ranura correspondiente, o nullptr si la trama está mal formada.
+ * @note El objeto retornado pertenece a `ranuras`; no debe liberarse con `delete`.
+ */
+TramaBase* parsearLinea(const char* linea, int longitud, RanurasDeTrama* ranuras);
+
+/**
+ * @brief Parsea una línea de texto (trama) sobre las ranuras reutilizables, sin usar el heap.
+ * @param linea La cadena de texto de la trama (e.g., "L,A" o "M,-5").
+ * @param ranuras Ranuras donde se coloca la trama.
+ * @return Un puntero a la ranura correspondiente, o nullptr si la trama está mal formada.
+ * @note El objeto retornado pertenece a `ranuras`; no debe liberarse con `delete`.
+ */
+TramaBase* parsearLinea(const char* linea, RanurasDeTrama* ranuras);
+
+#endif // PRT7_PARSER_H
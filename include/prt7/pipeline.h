@@ -0,0 +1,213 @@
+/**
+ * @file prt7/pipeline.h
+ * @brief Pipeline lector / decodificador / salida unido por colas SPSC.
+ */
+
+#ifndef PRT7_PIPELINE_H
+#define PRT7_PIPELINE_H
+
+#include <cstring>      // Para memcpy()
+#include <thread>       // Para std::thread
+
+#include "prt7/cola_spsc.h"
+#include "prt7/decodificador.h"
+#include "prt7/fuentes.h"
+#include "prt7/salida.h"
+
+// CLASE: PIPELINE LECTOR / DECODIFICADOR / SALIDA
+
+/**
+ * @struct LineaLeida
+ * @brief Línea clasificada por la etapa de lectura, en espera de ser decodificada.
+ */
+struct LineaLeida {
+    RegistroTrama registro;                     ///< Clasificación de la línea.
+    int longitud;                               ///< Bytes copiados en `texto` (solo con traza).
+    char texto[FuenteDeLineas::MAX_LINEA + 1];  ///< Texto de la línea, para la traza.
+#ifdef PRT7_INSTRUMENTACION
+    unsigned long long marcaRecepcion;          ///< Momento en que el hilo lector recibió la línea.
+#endif
+};
+
+/**
+ * @struct BloqueDeSalida
+ * @brief Bloque de traza volcado por el decodificador, en espera de ser escrito.
+ */
+struct BloqueDeSalida {
+    int cantidad;                               ///< Bytes ocupados en `datos`.
+    char datos[SalidaBufferizada::CAPACIDAD];   ///< Texto a escribir.
+};
+
+/**
+ * @class PipelineDeDecodificacion
+ * @brief Separa la lectura, la decodificación y la escritura de la traza en hilos distintos.
+ *
+ * Un hilo lee y clasifica las líneas, el hilo que llama a `ejecutar` las
+ * decodifica y, si hay traza, un tercer hilo la escribe. Las etapas se unen
+ * con colas SPSC: cuando una cola se llena, la etapa anterior espera
+ * (contrapresión) en lugar de descartar datos, y mientras tanto el kernel
+ * sigue almacenando bytes del puerto. Así, una terminal lenta ya no frena la
+ * lectura del puerto serial.
+ */
+class PipelineDeDecodificacion {
+public:
+    static const size_t CAPACIDAD_LINEAS = 4096; ///< Líneas en espera de ser decodificadas.
+    static const size_t CAPACIDAD_SALIDA = 16;   ///< Bloques de traza en espera de ser escritos.
+    
+private:
+    FuenteDeLineas* fuente;                      ///< Origen de las líneas.
+    Decodificador* decodificador;                ///< Decodificador de la etapa central.
+    SalidaBufferizada* salida;                   ///< Traza (nullptr si no se imprime).
+    ColaSPSC<LineaLeida, CAPACIDAD_LINEAS> lineas;       ///< Lectura -> decodificación.
+    ColaSPSC<BloqueDeSalida, CAPACIDAD_SALIDA> bloques;  ///< Decodificación -> escritura.
+    bool modoBinario;                            ///< Se terminó en la línea "BIN".
+    
+    /**
+     * @brief Etapa de lectura: lee y clasifica líneas hasta "FIN", "BIN" o el cierre de la fuente.
+     */
+    void leer() {
+        const char* linea;
+        int longitud;
+        
+        while (fuente->leerLinea(&linea, &longitud)) {
+            LineaLeida* ranura = lineas.reservarEsperando();
+            clasificarTrama(linea, longitud, &ranura->registro);
+#ifdef PRT7_INSTRUMENTACION
+            ranura->marcaRecepcion = marcaRecepcion;
+#endif
+            
+            // El texto solo hace falta para la traza
+            if (salida != nullptr) {
+                memcpy(ranura->texto, linea, longitud);
+                ranura->longitud = longitud;
+            } else {
+                ranura->longitud = 0;
+            }
+            
+            // Después de "BIN" los bytes ya no son líneas: el resto lo lee quien llamó a ejecutar()
+            bool fin = ranura->registro.tipo == TRAMA_FIN || ranura->registro.tipo == TRAMA_BINARIO;
+            lineas.publicar();
+            if (fin) break;
+        }
+        
+        lineas.cerrar();
+    }
+    
+    /**
+     * @brief Etapa de escritura: escribe los bloques de traza hasta que se cierre la cola.
+     */
+    void escribir() {
+        int fd = salida->getDescriptor();
+        BloqueDeSalida* bloque;
+        
+        while ((bloque = bloques.frenteEsperando()) != nullptr) {
+            escribirTodo(fd, bloque->datos, bloque->cantidad);
+            bloques.liberar();
+        }
+    }
+    
+    /**
+     * @brief Destino de la traza: parte el texto volcado en bloques y los encola.
+     * @param contexto Puntero al PipelineDeDecodificacion.
+     * @param datos Texto volcado.
+     * @param cantidad Cantidad de bytes.
+     * @return Siempre true.
+     */
+    static bool encolarSalida(void* contexto, const char* datos, size_t cantidad) {
+        PipelineDeDecodificacion* pipeline = static_cast<PipelineDeDecodificacion*>(contexto);
+        
+        while (cantidad > 0) {
+            size_t parte = cantidad < (size_t)SalidaBufferizada::CAPACIDAD
+                         ? cantidad : (size_t)SalidaBufferizada::CAPACIDAD;
+            BloqueDeSalida* bloque = pipeline->bloques.reservarEsperando();
+            memcpy(bloque->datos, datos, parte);
+            bloque->cantidad = (int)parte;
+            pipeline->bloques.publicar();
+            
+            datos += parte;
+            cantidad -= parte;
+        }
+        return true;
+    }
+    
+public:
+    /**
+     * @brief Constructor.
+     * @param origen Fuente de líneas (solo la usará el hilo lector).
+     * @param destino Decodificador de las tramas.
+     * @param traza Salida de la traza, o nullptr si no se imprime.
+     */
+    PipelineDeDecodificacion(FuenteDeLineas* origen, Decodificador* destino, SalidaBufferizada* traza)
+        : fuente(origen), decodificador(destino), salida(traza), modoBinario(false) {}
+    
+    /**
+     * @brief Ejecuta las etapas hasta recibir "FIN" o "BIN", o hasta que se cierre la fuente.
+     *
+     * Mientras dura, la salida de traza se entrega a la cola del hilo escritor
+     * en lugar de escribirse directamente.
+     */
+    void ejecutar() {
+        std::thread lector(&PipelineDeDecodificacion::leer, this);
+        std::thread escritor;
+        if (salida != nullptr) {
+            salida->setDestino(encolarSalida, this);
+            escritor = std::thread(&PipelineDeDecodificacion::escribir, this);
+        }
+        
+        while (true) {
+            LineaLeida* linea = lineas.frente();
+            if (linea == nullptr) {
+                // Antes de esperar al lector, no dejar traza retenida en el buffer
+                if (salida != nullptr) salida->volcar();
+                linea = lineas.frenteEsperando();
+                if (linea == nullptr) break;
+            }
+            
+#ifdef PRT7_INSTRUMENTACION
+            marcaRecepcion = linea->marcaRecepcion;
+#endif
+            modoBinario = linea->registro.tipo == TRAMA_BINARIO;
+            bool continuar = decodificador->procesar(linea->registro,
+                                                     salida != nullptr ? linea->texto : nullptr,
+                                                     linea->longitud);
+            lineas.liberar();
+            if (!continuar) break;
+            
+            if (salida != nullptr) salida->volcarSiVencido();
+        }
+        
+        lector.join();
+        if (salida != nullptr) {
+            salida->volcar();
+            bloques.cerrar();
+            escritor.join();
+            salida->setDestino(nullptr, nullptr);
+        }
+    }
+    
+    /**
+     * @brief Indica si la ejecución terminó en la línea "BIN".
+     * @return true si los bytes siguientes de la fuente son tramas binarias.
+     */
+    bool getModoBinario() const {
+        return modoBinario;
+    }
+    
+    /**
+     * @brief Obtiene la cola entre la lectura y la decodificación.
+     * @return La cola (sus contadores son válidos al terminar `ejecutar`).
+     */
+    const ColaSPSC<LineaLeida, CAPACIDAD_LINEAS>& getColaDeLineas() const {
+        return lineas;
+    }
+    
+    /**
+     * @brief Obtiene la cola entre la decodificación y la escritura de la traza.
+     * @return La cola (sus contadores son válidos al terminar `ejecutar`).
+     */
+    const ColaSPSC<BloqueDeSalida, CAPACIDAD_SALIDA>& getColaDeSalida() const {
+        return bloques;
+    }
+};
+
+#endif // PRT7_PIPELINE_H
@@ -0,0 +1,30 @@
+/**
+ * @file prt7/plataforma.h
+ * @brief Detección de instrucciones vectoriales y constantes de la plataforma.
+ */
+
+#ifndef PRT7_PLATAFORMA_H
+#define PRT7_PLATAFORMA_H
+
+#include <climits>      // Para IOV_MAX
+#include <cstddef>      // Para size_t
+
+// Instrucciones vectoriales disponibles (se desactivan con -DPRT7_SIN_SIMD)
+#if !defined(PRT7_SIN_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define PRT7_SIMD_SSE2
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define PRT7_SIMD_AVX2
+#endif
+#elif !defined(PRT7_SIN_SIMD) && defined(__aarch64__) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define PRT7_SIMD_NEON
+#endif
+
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+#endif // PRT7_PLATAFORMA_H
@@ -0,0 +1,37 @@
+/**
+ * @file prt7/prt7.h
+ * @brief Biblioteca del Decodificador PRT-7: incluye todos sus componentes.
+ *
+ * Para integrar el decodificador en otro programa basta con incluir este
+ * archivo y enlazar con la biblioteca `prt7`. La forma más simple de usarlo
+ * es DecodificadorContinuo: se le entregan los bytes a medida que llegan
+ * (`alimentar`) y avisa por funciones de retorno los caracteres decodificados.
+ */
+
+#ifndef PRT7_PRT7_H
+#define PRT7_PRT7_H
+
+#include "prt7/plataforma.h"
+#include "prt7/instrumentacion.h"
+#include "prt7/nodos.h"
+#include "prt7/rotor.h"
+#include "prt7/cascada.h"
+#include "prt7/instantanea.h"
+#include "prt7/escritura.h"
+#include "prt7/lista_de_carga.h"
+#include "prt7/cola_spsc.h"
+#include "prt7/salida.h"
+#include "prt7/sumidero.h"
+#include "prt7/tramas.h"
+#include "prt7/binario.h"
+#include "prt7/generador.h"
+#include "prt7/serial.h"
+#include "prt7/fuentes.h"
+#include "prt7/parser.h"
+#include "prt7/decodificador.h"
+#include "prt7/decodificador_continuo.h"
+#include "prt7/pipeline.h"
+#include "prt7/bitacora.h"
+#include "prt7/informe.h"
+
+#endif // PRT7_PRT7_H
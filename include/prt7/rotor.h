@@ -0,0 +1,354 @@
+/**
+ * @file prt7/rotor.h
+ * @brief Rotor de mapeo (cifrado César rotativo) sobre un alfabeto y su decodificación vectorizada.
+ */
+
+#ifndef PRT7_ROTOR_H
+#define PRT7_ROTOR_H
+
+#include <cstddef>
+#include <cstring>      // Para memcpy()
+
+#include "prt7/instrumentacion.h"
+#include "prt7/nodos.h"
+
+// ALFABETOS DEL ROTOR
+
+/**
+ * @struct AlfabetoLatino
+ * @brief Alfabeto del protocolo PRT-7: las 26 mayúsculas 'A' a 'Z'.
+ *
+ * Un alfabeto es cualquier tipo con la constante LONGITUD (1 a 256) y la
+ * función constexpr `simbolo(i)`, que da el i-ésimo símbolo del anillo sin
+ * repetir ninguno. Los bytes que no están en el alfabeto pasan sin cambios.
+ */
+struct AlfabetoLatino {
+    static const int LONGITUD = 26; ///< Cantidad de símbolos.
+    
+    /**
+     * @brief Obtiene un símbolo del alfabeto.
+     * @param i Posición en el anillo, de 0 a LONGITUD - 1.
+     * @return El símbolo.
+     */
+    static constexpr char simbolo(int i) {
+        return (char)('A' + i);
+    }
+};
+
+/**
+ * @struct AlfabetoAlfanumerico
+ * @brief Mayúsculas seguidas de los dígitos (36 símbolos), para sensores con lecturas numéricas.
+ */
+struct AlfabetoAlfanumerico {
+    static const int LONGITUD = 36; ///< Cantidad de símbolos.
+    
+    /**
+     * @brief Obtiene un símbolo del alfabeto.
+     * @param i Posición en el anillo, de 0 a LONGITUD - 1.
+     * @return 'A' a 'Z' para 0 a 25 y '0' a '9' para 26 a 35.
+     */
+    static constexpr char simbolo(int i) {
+        return i < 26 ? (char)('A' + i) : (char)('0' + (i - 26));
+    }
+};
+
+/**
+ * @struct AlfabetoDeBytes
+ * @brief Los 256 valores de un byte: ningún byte pasa sin cifrar.
+ */
+struct AlfabetoDeBytes {
+    static const int LONGITUD = 256; ///< Cantidad de símbolos.
+    
+    /**
+     * @brief Obtiene un símbolo del alfabeto.
+     * @param i Posición en el anillo, de 0 a 255.
+     * @return El byte de valor `i`.
+     */
+    static constexpr char simbolo(int i) {
+        return (char)i;
+    }
+};
+
+// TABLAS DE MAPEO EN TIEMPO DE COMPILACIÓN
+
+/**
+ * @brief Indica si los símbolos de un alfabeto son bytes consecutivos, desde la posición `i`.
+ * @param i Posición desde la que se compara.
+ * @return true si `simbolo(k)` es `simbolo(0) + k` para todo k desde `i`.
+ */
+template <typename Alfabeto>
+constexpr bool esContiguo(int i) {
+    return i == Alfabeto::LONGITUD ? true
+         : (int)(unsigned char)Alfabeto::simbolo(i) == (int)(unsigned char)Alfabeto::simbolo(0) + i &&
+           esContiguo<Alfabeto>(i + 1);
+}
+
+/**
+ * @struct SecuenciaDeIndices
+ * @brief Paquete de enteros 0, 1, ..., N - 1 para expandir inicializadores (std::index_sequence es de C++14).
+ */
+template <int... Indices>
+struct SecuenciaDeIndices {};
+
+/**
+ * @struct GenerarIndices
+ * @brief Construye `SecuenciaDeIndices<0, ..., N - 1>` en `tipo`.
+ */
+template <int N, int... Indices>
+struct GenerarIndices : GenerarIndices<N - 1, N - 1, Indices...> {};
+
+template <int... Indices>
+struct GenerarIndices<0, Indices...> {
+    typedef SecuenciaDeIndices<Indices...> tipo; ///< La secuencia generada.
+};
+
+/**
+ * @brief Busca un byte en un alfabeto, en tiempo de compilación.
+ * @param byte Valor del byte (0 a 255).
+ * @param i Posición desde la que se busca.
+ * @return Posición del byte en el anillo, o -1 si no pertenece al alfabeto.
+ */
+template <typename Alfabeto>
+constexpr short buscarSimbolo(int byte, int i) {
+    return i == Alfabeto::LONGITUD ? (short)-1
+         : (unsigned char)Alfabeto::simbolo(i) == byte ? (short)i
+         : buscarSimbolo<Alfabeto>(byte, i + 1);
+}
+
+/**
+ * @struct TablasDeAlfabeto
+ * @brief Tablas constexpr de un alfabeto: posición de cada byte y anillo duplicado.
+ *
+ * Con el anillo escrito dos veces seguidas, el símbolo que está `d` lugares
+ * después de la posición `p` es `rotados[p + d]` sin calcular el módulo.
+ */
+template <typename Alfabeto,
+          typename Bytes = typename GenerarIndices<256>::tipo,
+          typename Anillo = typename GenerarIndices<2 * Alfabeto::LONGITUD>::tipo>
+struct TablasDeAlfabeto;
+
+template <typename Alfabeto, int... Bytes, int... Anillo>
+struct TablasDeAlfabeto<Alfabeto, SecuenciaDeIndices<Bytes...>, SecuenciaDeIndices<Anillo...> > {
+    static constexpr short posicion[256] = { buscarSimbolo<Alfabeto>(Bytes, 0)... }; ///< -1 fuera del alfabeto.
+    static constexpr char rotados[sizeof...(Anillo)] = { Alfabeto::simbolo(Anillo % Alfabeto::LONGITUD)... }; ///< Anillo duplicado.
+};
+
+template <typename Alfabeto, int... Bytes, int... Anillo>
+constexpr short TablasDeAlfabeto<Alfabeto, SecuenciaDeIndices<Bytes...>, SecuenciaDeIndices<Anillo...> >::posicion[256];
+
+template <typename Alfabeto, int... Bytes, int... Anillo>
+constexpr char TablasDeAlfabeto<Alfabeto, SecuenciaDeIndices<Bytes...>, SecuenciaDeIndices<Anillo...> >::rotados[sizeof...(Anillo)];
+
+// CLASE: ROTOR
+
+/**
+ * @class Rotor
+ * @brief Implementa el mecanismo de cifrado/descifrado mediante un rotor circular.
+ *
+ * Simula el rotor de una máquina de cifrado. Está compuesto por una lista
+ * doblemente enlazada circular con los símbolos del alfabeto (para el
+ * protocolo, 'A' a 'Z'; ver RotorDeMapeo). La rotación cambia el punto de
+ * inicio del mapeo (la 'cabeza').
+ *
+ * Ni rotar ni mapear recorren el anillo. En los alfabetos de hasta
+ * MAX_TABLA_PLANA símbolos cada rotación copia a una tabla plana de 256
+ * bytes los LONGITUD símbolos del anillo duplicado de TablasDeAlfabeto,
+ * desde el desplazamiento (en A-Z, un `memcpy` de 26 bytes), y `getMapeo`
+ * es una sola lectura sin saltos; en los más grandes `getMapeo` combina
+ * esas tablas con el desplazamiento, sin reescribir nada al rotar.
+ * @tparam Alfabeto Símbolos del anillo (e.g., AlfabetoLatino).
+ */
+template <typename Alfabeto>
+class Rotor {
+public:
+    static const int LONGITUD = Alfabeto::LONGITUD; ///< Cantidad de nodos del anillo.
+    static const int MAX_TABLA_PLANA = 64;           ///< Alfabetos más grandes no reescriben la tabla al rotar.
+    static const bool TABLA_PLANA = LONGITUD <= MAX_TABLA_PLANA; ///< Se usa la tabla plana.
+    static const bool CONTIGUO = esContiguo<Alfabeto>(0);        ///< Los símbolos son bytes consecutivos.
+    
+    static_assert(LONGITUD >= 1 && LONGITUD <= 256, "El alfabeto debe tener de 1 a 256 simbolos");
+    
+private:
+    typedef TablasDeAlfabeto<Alfabeto> Tablas;
+    
+    NodoRotor* cabeza;           ///< Puntero al nodo actual que representa el inicio del mapeo.
+    NodoRotor* nodos[LONGITUD];  ///< Índice directo a cada nodo del anillo, en el orden del alfabeto.
+    int desplazamiento;          ///< Posición de la cabeza dentro del anillo (0 = primer símbolo).
+    char tablaMapeo[256];        ///< Mapeo plano para la rotación actual, indexado por el byte de entrada.
+    
+    /**
+     * @brief Reconstruye la tabla de mapeo desde el anillo duplicado, sin recorrer la lista.
+     *
+     * El símbolo i se mapea a `rotados[i + desplazamiento]`; con símbolos
+     * consecutivos es una sola copia. Los bytes fuera del alfabeto (incluido
+     * el espacio en AlfabetoLatino) no se tocan: quedan mapeados a sí mismos.
+     */
+    void reconstruirTabla() {
+        if (CONTIGUO) {
+            memcpy(tablaMapeo + (unsigned char)Alfabeto::simbolo(0), Tablas::rotados + desplazamiento, LONGITUD);
+            return;
+        }
+        for (int i = 0; i < LONGITUD; i++) {
+            tablaMapeo[(unsigned char)Alfabeto::simbolo(i)] = Tablas::rotados[i + desplazamiento];
+        }
+    }
+    
+public:
+    /**
+     * @brief Constructor. Inicializa el rotor con el alfabeto ordenado en forma circular.
+     */
+    Rotor() : desplazamiento(0) {
+        cabeza = new NodoRotor(Alfabeto::simbolo(0));
+        nodos[0] = cabeza;
+        NodoRotor* actual = cabeza;
+        
+        for (int i = 1; i < LONGITUD; i++) {
+            NodoRotor* nuevo = new NodoRotor(Alfabeto::simbolo(i));
+            actual->siguiente = nuevo;
+            nuevo->previo = actual;
+            actual = nuevo;
+            nodos[i] = nuevo;
+        }
+        
+        // Cerrar el círculo
+        actual->siguiente = cabeza;
+        cabeza->previo = actual;
+        
+        for (int i = 0; i < 256; i++) {
+            tablaMapeo[i] = (char)i;
+        }
+        reconstruirTabla();
+    }
+    
+    /**
+     * @brief Destructor. Libera toda la memoria asignada a los nodos del rotor.
+     */
+    ~Rotor() {
+        if (cabeza == nullptr) return;
+        
+        NodoRotor* ultimo = cabeza->previo;
+        ultimo->siguiente = nullptr; // Romper el círculo para la iteración
+        
+        NodoRotor* actual = cabeza;
+        while (actual != nullptr) {
+            NodoRotor* siguiente = actual->siguiente;
+            delete actual;
+            actual = siguiente;
+        }
+    }
+    
+    /**
+     * @brief Rota el rotor N posiciones.
+     *
+     * N se reduce módulo LONGITUD antes de mover la cabeza, y el nuevo nodo se
+     * toma del índice `nodos`, por lo que el costo no depende de |N| (una
+     * trama "M,2000000000" cuesta lo mismo que "M,1").
+     * @param N El número de posiciones a rotar. Positivo para avanzar (siguiente), negativo para retroceder (previo).
+     */
+    void rotar(int N) {
+        PRT7_CRONOMETRAR(rotacion);
+        PRT7_CONTAR(rotaciones, 1);
+        
+        // N % LONGITUD está en (-LONGITUD, LONGITUD), así que no hay desbordamiento ni con INT_MIN
+        int pasos = N % LONGITUD;
+        if (pasos == 0) return;
+        
+        desplazamiento = (desplazamiento + pasos + LONGITUD) % LONGITUD;
+        cabeza = nodos[desplazamiento];
+        if (TABLA_PLANA) {
+            reconstruirTabla();
+        }
+    }
+    
+    /**
+     * @brief Obtiene la posición actual de la cabeza dentro del anillo.
+     * @return Desplazamiento en el rango [0, LONGITUD - 1], donde 0 corresponde al primer símbolo.
+     */
+    int getDesplazamiento() const {
+        return desplazamiento;
+    }
+    
+    /**
+     * @brief Obtiene el carácter de mapeo (decodificado) para el carácter de entrada.
+     *
+     * Con tabla plana es una sola lectura de `tablaMapeo`, que se copia del
+     * anillo duplicado únicamente cuando `rotar` cambia la cabeza; si no, dos
+     * lecturas de las tablas constexpr del alfabeto.
+     * @param in El carácter de entrada (cifrado).
+     * @return El carácter decodificado. Devuelve el mismo carácter si no pertenece al alfabeto.
+     */
+    char getMapeo(char in) const {
+        PRT7_CONTAR(consultasMapeo, 1);
+        if (TABLA_PLANA) {
+            return tablaMapeo[(unsigned char)in];
+        }
+        int posicion = Tablas::posicion[(unsigned char)in];
+        return posicion < 0 ? in : Tablas::rotados[posicion + desplazamiento];
+    }
+    
+    /**
+     * @brief Obtiene el carácter de mapeo recorriendo los nodos del anillo desde la cabeza.
+     *
+     * Produce el mismo resultado que `getMapeo`; se conserva como referencia del
+     * recorrido sobre la lista circular.
+     * @param in El carácter de entrada (cifrado).
+     * @return El carácter decodificado. Devuelve el mismo carácter si no pertenece al alfabeto
+     *         (en AlfabetoLatino, el espacio y todo lo que no sea A-Z).
+     */
+    char getMapeoEnlazado(char in) const {
+        // Solo se cifran los símbolos del alfabeto (el espacio NO está en AlfabetoLatino)
+        int posicionDelCaracter = Tablas::posicion[(unsigned char)in];
+        if (posicionDelCaracter < 0) {
+            return in;
+        }
+        
+        // Desde la cabeza actual (que está rotada), avanzar esa cantidad de posiciones
+        // para obtener el carácter de mapeo.
+        NodoRotor* resultado = cabeza;
+        for (int i = 0; i < posicionDelCaracter; i++) {
+            resultado = resultado->siguiente;
+        }
+        
+        return resultado->dato;
+    }
+};
+
+/**
+ * @brief Rotor del protocolo PRT-7 (alfabeto A-Z), el que usan el decodificador y las tramas.
+ */
+typedef Rotor<AlfabetoLatino> RotorDeMapeo;
+
+// FUNCIÓN: DECODIFICACIÓN VECTORIZADA
+
+/**
+ * @brief Decodifica una corrida de caracteres con el rotor fijo en su posición actual.
+ *
+ * Como cada rotación es un desplazamiento César, decodificar una corrida de
+ * tramas LOAD equivale a sumar el desplazamiento del rotor módulo 26 a
+ * cada letra A-Z (los demás bytes no cambian). Con SSE2/AVX2/NEON se procesan
+ * 16 o 32 caracteres por instrucción; el resto se resuelve con `getMapeo`.
+ * El resultado es idéntico a llamar `getMapeo` carácter por carácter.
+ * @param entrada Caracteres cifrados.
+ * @param salida Destino de los caracteres decodificados (puede ser igual a `entrada`).
+ * @param cantidad Cantidad de caracteres.
+ * @param rotor Rotor con el que se decodifica.
+ */
+void decodificarCorrida(const char* entrada, char* salida, size_t cantidad, const RotorDeMapeo& rotor);
+
+/**
+ * @brief Decodifica una corrida de caracteres con un rotor de cualquier alfabeto.
+ *
+ * Versión escalar de `decodificarCorrida` (la vectorizada es solo para A-Z).
+ * @param entrada Caracteres cifrados.
+ * @param salida Destino de los caracteres decodificados (puede ser igual a `entrada`).
+ * @param cantidad Cantidad de caracteres.
+ * @param rotor Rotor con el que se decodifica.
+ */
+template <typename Alfabeto>
+void decodificarCorrida(const char* entrada, char* salida, size_t cantidad, const Rotor<Alfabeto>& rotor) {
+    for (size_t i = 0; i < cantidad; i++) {
+        salida[i] = rotor.getMapeo(entrada[i]);
+    }
+}
+
+#endif // PRT7_ROTOR_H
@@ -0,0 +1,192 @@
+/**
+ * @file prt7/salida.h
+ * @brief Salida de texto con buffer y volcado por tamaño o por tiempo.
+ */
+
+#ifndef PRT7_SALIDA_H
+#define PRT7_SALIDA_H
+
+#include <cstring>      // Para memcpy(), strlen()
+#include <ctime>        // Para clock_gettime()
+
+#include "prt7/escritura.h"
+
+/**
+ * @enum NivelSalida
+ * @brief Cantidad de información que el programa imprime mientras decodifica.
+ */
+enum NivelSalida {
+    SALIDA_SILENCIOSA, ///< Solo el mensaje decodificado.
+    SALIDA_RESUMEN,    ///< Encabezados, conteo de tramas y mensaje, sin traza por trama.
+    SALIDA_TRAZA       ///< Una línea de traza por cada trama (comportamiento original).
+};
+
+/**
+ * @class SalidaBufferizada
+ * @brief Acumula texto en memoria y lo escribe al descriptor en bloques.
+ *
+ * El buffer se vacía cuando se llena, cuando pasa más de INTERVALO_MS desde el
+ * último volcado (ver `volcarSiVencido`) o al destruirse, en lugar de forzar
+ * un `flush` por cada línea como hace `endl`.
+ */
+class SalidaBufferizada {
+public:
+    static const int CAPACIDAD = 16384;  ///< Tamaño del buffer.
+    static const long INTERVALO_MS = 50; ///< Tiempo máximo que un texto espera en el buffer.
+    
+private:
+    int fd;                   ///< Descriptor de destino.
+    char buffer[CAPACIDAD];   ///< Texto pendiente de escribir.
+    int usados;               ///< Bytes ocupados en `buffer`.
+    long ultimoVolcado;       ///< Momento del último volcado, en milisegundos.
+    bool (*destino)(void*, const char*, size_t); ///< Destino alternativo al descriptor (o nullptr).
+    void* contextoDestino;    ///< Argumento para `destino`.
+    
+    /**
+     * @brief Entrega un bloque de texto al destino configurado.
+     * @param datos Texto a entregar.
+     * @param cantidad Cantidad de bytes.
+     */
+    void entregar(const char* datos, size_t cantidad) {
+        if (destino != nullptr) {
+            destino(contextoDestino, datos, cantidad);
+        } else {
+            escribirTodo(fd, datos, cantidad);
+        }
+    }
+    
+public:
+    /**
+     * @brief Constructor.
+     * @param descriptor Descriptor al que se escribirá (e.g., STDOUT_FILENO).
+     */
+    explicit SalidaBufferizada(int descriptor)
+        : fd(descriptor), usados(0), ultimoVolcado(milisegundos()),
+          destino(nullptr), contextoDestino(nullptr) {}
+    
+    /**
+     * @brief Destructor. Escribe lo que quede pendiente.
+     */
+    ~SalidaBufferizada() {
+        volcar();
+    }
+    
+    /**
+     * @brief Obtiene un reloj monotónico en milisegundos.
+     * @return Milisegundos desde un origen arbitrario.
+     */
+    static long milisegundos() {
+        struct timespec ahora;
+        clock_gettime(CLOCK_MONOTONIC, &ahora);
+        return (long)ahora.tv_sec * 1000 + ahora.tv_nsec / 1000000;
+    }
+    
+    /**
+     * @brief Agrega un bloque de texto.
+     * @param datos Texto a escribir.
+     * @param cantidad Cantidad de bytes.
+     */
+    void escribir(const char* datos, int cantidad) {
+        if (usados + cantidad > CAPACIDAD) {
+            volcar();
+            if (cantidad > CAPACIDAD) {
+                entregar(datos, cantidad);
+                return;
+            }
+        }
+        memcpy(buffer + usados, datos, cantidad);
+        usados += cantidad;
+    }
+    
+    /**
+     * @brief Agrega una cadena terminada en '\0'.
+     * @param texto Texto a escribir.
+     */
+    void escribir(const char* texto) {
+        escribir(texto, (int)strlen(texto));
+    }
+    
+    /**
+     * @brief Agrega un carácter.
+     * @param c El carácter a escribir.
+     */
+    void escribirCaracter(char c) {
+        if (usados == CAPACIDAD) {
+            volcar();
+        }
+        buffer[usados++] = c;
+    }
+    
+    /**
+     * @brief Agrega un entero en base 10.
+     * @param numero El número a escribir.
+     */
+    void escribirEntero(long numero) {
+        char digitos[24];
+        int posicion = sizeof(digitos);
+        unsigned long magnitud = numero < 0 ? 0UL - (unsigned long)numero : (unsigned long)numero;
+        
+        do {
+            digitos[--posicion] = (char)('0' + magnitud % 10);
+            magnitud /= 10;
+        } while (magnitud > 0);
+        
+        if (numero < 0) {
+            digitos[--posicion] = '-';
+        }
+        escribir(digitos + posicion, (int)sizeof(digitos) - posicion);
+    }
+    
+    /**
+     * @brief Escribe al descriptor todo lo pendiente.
+     */
+    void volcar() {
+        if (usados > 0) {
+            entregar(buffer, usados);
+            usados = 0;
+        }
+        ultimoVolcado = milisegundos();
+    }
+    
+    /**
+     * @brief Reemplaza la escritura al descriptor por otra función (e.g., encolar para otro hilo).
+     * @param funcion Recibe el contexto y cada bloque volcado; nullptr vuelve al descriptor.
+     * @param contexto Argumento que se pasa a `funcion`.
+     */
+    void setDestino(bool (*funcion)(void*, const char*, size_t), void* contexto) {
+        destino = funcion;
+        contextoDestino = contexto;
+    }
+    
+    /**
+     * @brief Obtiene el descriptor de destino.
+     * @return El descriptor dado al constructor.
+     */
+    int getDescriptor() const {
+        return fd;
+    }
+    
+    /**
+     * @brief Vuelca el buffer si el texto más antiguo lleva más de INTERVALO_MS esperando.
+     */
+    void volcarSiVencido() {
+        if (usados > 0 && milisegundos() - ultimoVolcado >= INTERVALO_MS) {
+            volcar();
+        }
+    }
+    
+    /**
+     * @brief Adaptador para usar `volcar` como función de aviso (ver LectorDeLineas::setAntesDeEsperar).
+     * @param salida Puntero a una SalidaBufferizada.
+     */
+    static void volcarContexto(void* salida) {
+        static_cast<SalidaBufferizada*>(salida)->volcar();
+    }
+};
+
+/**
+ * @brief Salida de traza por trama. Es nullptr cuando el nivel de salida no es SALIDA_TRAZA.
+ */
+extern SalidaBufferizada* salidaTraza;
+
+#endif // PRT7_SALIDA_H
@@ -0,0 +1,54 @@
+/**
+ * @file prt7/serial.h
+ * @brief Configuración y apertura del puerto serial.
+ */
+
+#ifndef PRT7_SERIAL_H
+#define PRT7_SERIAL_H
+
+#include <termios.h>    // Para speed_t
+
+/**
+ * @struct ConfiguracionSerial
+ * @brief Parámetros de apertura del puerto serial.
+ */
+struct ConfiguracionSerial {
+    char puerto[256];   ///< Path del dispositivo serial (vacío = preguntar al usuario).
+    int baudios;        ///< Velocidad en baudios (9600 por defecto).
+    int vmin;           ///< Mínimo de bytes que espera cada `read()` (termios VMIN).
+    int vtime;          ///< Temporizador entre bytes en décimas de segundo (termios VTIME).
+    bool bajaLatencia;  ///< Solicita ASYNC_LOW_LATENCY al driver (solo Linux).
+    
+    /**
+     * @brief Constructor. Valores por defecto: 9600 8N1, `read()` bloqueante.
+     */
+    ConfiguracionSerial() : baudios(9600), vmin(1), vtime(0), bajaLatencia(false) {
+        puerto[0] = '\0';
+    }
+};
+
+/**
+ * @brief Convierte una velocidad numérica a la constante de termios correspondiente.
+ * @param baudios Velocidad en baudios (e.g., 115200).
+ * @return La constante `Bxxxx`, o B0 si la velocidad no está soportada.
+ */
+speed_t convertirBaudios(int baudios);
+
+/**
+ * @brief Configura y abre el puerto serial según la configuración dada.
+ *
+ * Después de aplicar los parámetros se vuelven a leer; si el puerto ya los
+ * reporta aplicados no se hace la espera de estabilización de 100 ms.
+ * @param config Parámetros del puerto (path, baudios, VMIN/VTIME, baja latencia).
+ * @return El descriptor de archivo del puerto abierto, o -1 en caso de error.
+ */
+int configurarSerial(const ConfiguracionSerial& config);
+
+/**
+ * @brief Configura y abre el puerto serial con los valores por defecto (9600 8N1).
+ * @param puerto El path del dispositivo serial (e.g., "/dev/ttyUSB0").
+ * @return El descriptor de archivo del puerto abierto, o -1 en caso de error.
+ */
+int configurarSerial(const char* puerto);
+
+#endif // PRT7_SERIAL_H
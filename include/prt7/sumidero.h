@@ -0,0 +1,177 @@
+/**
+ * @file prt7/sumidero.h
+ * @brief Sumideros del mensaje: lo entregan a medida que se decodifica (archivo, socket UNIX o TCP).
+ */
+
+#ifndef PRT7_SUMIDERO_H
+#define PRT7_SUMIDERO_H
+
+#include <cstddef>      // Para size_t
+#include <sys/uio.h>    // Para struct iovec
+
+#include "prt7/lista_de_carga.h"
+
+// CLASE BASE: SUMIDERO DE CARGA
+
+/**
+ * @class SumideroDeCarga
+ * @brief Interfaz común para los destinos que reciben el mensaje en forma incremental.
+ *
+ * El sumidero lee de la ListaDeCarga solo los caracteres nuevos (con su
+ * vista incremental), los escribe de a IOV_MAX nodos por llamada a
+ * `escribir` y después libera los nodos ya entregados, así que en un flujo
+ * sin "FIN" la memoria queda acotada por lo que llega entre dos volcados.
+ * `volcarSiHaceFalta` vuelca cuando hay UMBRAL caracteres pendientes o
+ * cuando el más antiguo lleva INTERVALO_MS esperando, al estilo de
+ * SalidaBufferizada; `volcarContexto` sirve de aviso cuando la entrada
+ * queda inactiva (ver LectorDeLineas::setAntesDeEsperar).
+ *
+ * Si una escritura falla el sumidero queda fallido: lo que sigue llegando
+ * se libera sin escribirse, para que la memoria siga acotada.
+ */
+class SumideroDeCarga {
+public:
+    static const size_t UMBRAL = 65536;   ///< Caracteres pendientes que fuerzan un volcado.
+    static const long INTERVALO_MS = 50;  ///< Tiempo máximo que un carácter espera en la lista.
+    
+private:
+    ListaDeCarga* lista;           ///< Lista de la que se toman los caracteres nuevos.
+    unsigned long long enviados;   ///< Caracteres escritos.
+    long escrituras;               ///< Llamadas a `escribir`.
+    long ultimoVolcado;            ///< Momento del último volcado, en milisegundos.
+    bool fallido;                  ///< Una escritura falló; ya no se escribe nada.
+    
+protected:
+    /**
+     * @brief Escribe todos los segmentos al destino.
+     * @param segmentos Segmentos a escribir (pueden modificarse).
+     * @param cantidad Cantidad de segmentos (de 1 a IOV_MAX).
+     * @return true si se escribió todo, false si hubo un error.
+     */
+    virtual bool escribir(struct iovec* segmentos, int cantidad) = 0;
+    
+public:
+    /**
+     * @brief Constructor.
+     * @param origen Lista cuyos caracteres nuevos se entregan.
+     */
+    explicit SumideroDeCarga(ListaDeCarga* origen);
+    
+    /**
+     * @brief Destructor virtual.
+     */
+    virtual ~SumideroDeCarga() {}
+    
+    /**
+     * @brief Escribe todos los caracteres nuevos de la lista y libera los nodos ya entregados.
+     * @return false si el sumidero está fallido.
+     */
+    bool volcar();
+    
+    /**
+     * @brief Vuelca si hay UMBRAL caracteres pendientes o si pasaron INTERVALO_MS desde el último volcado.
+     */
+    void volcarSiHaceFalta();
+    
+    /**
+     * @brief Adaptador para usar `volcar` como función de aviso (ver LectorDeLineas::setAntesDeEsperar).
+     * @param sumidero Puntero a un SumideroDeCarga.
+     */
+    static void volcarContexto(void* sumidero) {
+        static_cast<SumideroDeCarga*>(sumidero)->volcar();
+    }
+    
+    /**
+     * @brief Obtiene cuántos caracteres se escribieron.
+     * @return Caracteres entregados al destino.
+     */
+    unsigned long long getEnviados() const {
+        return enviados;
+    }
+    
+    /**
+     * @brief Obtiene cuántas llamadas a `escribir` se hicieron.
+     * @return Escrituras (cada una de hasta IOV_MAX nodos).
+     */
+    long getEscrituras() const {
+        return escrituras;
+    }
+    
+    /**
+     * @brief Indica si una escritura falló.
+     * @return true si el destino dejó de aceptar datos.
+     */
+    bool getFallido() const {
+        return fallido;
+    }
+};
+
+// CLASE: SUMIDERO SOBRE UN DESCRIPTOR
+
+/**
+ * @class SumideroDeDescriptor
+ * @brief Sumidero que escribe a un archivo, a la salida estándar o a un socket UNIX o TCP.
+ *
+ * A un archivo se escribe con `writev()`; a un socket con `sendmsg()` y
+ * MSG_NOSIGNAL, para que un cliente que se desconecta no termine el
+ * programa con SIGPIPE.
+ */
+class SumideroDeDescriptor : public SumideroDeCarga {
+private:
+    int fd;          ///< Descriptor de destino (-1 si no está abierto).
+    bool esSocket;   ///< El destino es un socket.
+    
+protected:
+    /**
+     * @brief Escribe los segmentos al descriptor.
+     * @param segmentos Segmentos a escribir.
+     * @param cantidad Cantidad de segmentos.
+     * @return true si se escribió todo, false si hubo un error.
+     */
+    bool escribir(struct iovec* segmentos, int cantidad);
+    
+public:
+    /**
+     * @brief Constructor. El sumidero queda cerrado hasta llamar a `abrir`.
+     * @param origen Lista cuyos caracteres nuevos se entregan.
+     */
+    explicit SumideroDeDescriptor(ListaDeCarga* origen)
+        : SumideroDeCarga(origen), fd(-1), esSocket(false) {}
+    
+    /**
+     * @brief Destructor. Cierra el destino (sin volcar lo pendiente).
+     */
+    ~SumideroDeDescriptor() {
+        cerrar();
+    }
+    
+    // El sumidero es dueño de su descriptor: no se copia
+    SumideroDeDescriptor(const SumideroDeDescriptor&) = delete;
+    SumideroDeDescriptor& operator=(const SumideroDeDescriptor&) = delete;
+    
+    /**
+     * @brief Abre el destino indicado por un texto.
+     *
+     * "unix:RUTA" conecta a un socket UNIX de flujo, "tcp:HOST:PUERTO" a un
+     * servidor TCP, "-" usa la salida estándar y cualquier otro texto es la
+     * ruta de un archivo, que se crea o se vacía.
+     * @param destino Texto del destino.
+     * @return false si no se pudo abrir o conectar.
+     */
+    bool abrir(const char* destino);
+    
+    /**
+     * @brief Cierra el destino (la salida estándar no se cierra).
+     */
+    void cerrar();
+    
+    /**
+     * @brief Obtiene el descriptor de destino.
+     * @return El descriptor, o -1 si no está abierto.
+     */
+    int getDescriptor() const {
+        return fd;
+    }
+};
+
+#endif // PRT7_SUMIDERO_H
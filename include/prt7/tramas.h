@@ -0,0 +1,281 @@
+/**
+ * @file prt7/tramas.h
+ * @brief Jerarquía TramaBase / TramaLoad / TramaMap y su representación sin heap.
+ */
+
+#ifndef PRT7_TRAMAS_H
+#define PRT7_TRAMAS_H
+
+#include "prt7/cascada.h"
+#include "prt7/instrumentacion.h"
+#include "prt7/lista_de_carga.h"
+#include "prt7/rotor.h"
+#include "prt7/salida.h"
+
+// CLASE BASE: TRAMA
+
+/**
+ * @class TramaBase
+ * @brief Clase base abstracta para todos los tipos de tramas de comunicación.
+ */
+class TramaBase {
+public:
+    /**
+     * @brief Método virtual puro para procesar la trama. Debe ser implementado por las clases derivadas.
+     * @param carga Puntero a la lista de carga donde se almacena el mensaje.
+     * @param rotor Puntero al rotor de mapeo para realizar operaciones.
+     */
+    virtual void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) = 0;
+    
+    /**
+     * @brief Método virtual puro para procesar la trama con una cascada de rotores en lugar de un rotor.
+     * @param carga Puntero a la lista de carga donde se almacena el mensaje.
+     * @param cascada Puntero a la cascada de rotores.
+     */
+    virtual void procesar(ListaDeCarga* carga, CascadaDeRotores* cascada) = 0;
+    
+    /**
+     * @brief Destructor virtual.
+     */
+    virtual ~TramaBase() {}
+};
+
+// CLASE: TRAMA LOAD
+
+/**
+ * @class TramaLoad
+ * @brief Representa una trama de carga de carácter ('L').
+ *
+ * Contiene un carácter cifrado que debe ser decodificado por el rotor
+ * y añadido a la lista de carga.
+ */
+class TramaLoad : public TramaBase {
+private:
+    char caracter;     ///< El carácter cifrado a decodificar.
+    char decodificado; ///< Resultado del último `procesar` con una cascada.
+    
+public:
+    /**
+     * @brief Constructor.
+     * @param c El carácter cifrado.
+     */
+    TramaLoad(char c) : caracter(c), decodificado('\0') {}
+    
+    /**
+     * @brief Reasigna el carácter cifrado, para reutilizar el objeto en otra trama.
+     * @param c El carácter cifrado.
+     */
+    void setCaracter(char c) {
+        caracter = c;
+    }
+    
+    /**
+     * @brief Procesa la trama: decodifica el carácter y lo añade a la lista de carga.
+     * @param carga Puntero a la lista de carga.
+     * @param rotor Puntero al rotor de mapeo.
+     */
+    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
+        char decodificado = rotor->getMapeo(caracter);
+        carga->insertarAlFinal(decodificado);
+        PRT7_LATENCIA_RECEPCION();
+        
+        if (salidaTraza != nullptr) {
+            salidaTraza->escribir("Fragmento '");
+            salidaTraza->escribirCaracter(caracter);
+            salidaTraza->escribir("' decodificado como '");
+            salidaTraza->escribirCaracter(decodificado);
+            salidaTraza->escribir("'.\n");
+        }
+    }
+    
+    /**
+     * @brief Procesa la trama: descifra el carácter con la cascada y lo añade a la lista de carga.
+     *
+     * La cascada puede avanzar al descifrar, así que el resultado queda
+     * también en `getDecodificado` para no descifrar dos veces.
+     * @param carga Puntero a la lista de carga (nullptr para no acumular el mensaje).
+     * @param cascada Puntero a la cascada de rotores.
+     */
+    void procesar(ListaDeCarga* carga, CascadaDeRotores* cascada) {
+        decodificado = cascada->descifrar(caracter);
+        if (carga != nullptr) carga->insertarAlFinal(decodificado);
+        PRT7_LATENCIA_RECEPCION();
+        
+        if (salidaTraza != nullptr) {
+            salidaTraza->escribir("Fragmento '");
+            salidaTraza->escribirCaracter(caracter);
+            salidaTraza->escribir("' decodificado como '");
+            salidaTraza->escribirCaracter(decodificado);
+            salidaTraza->escribir("'.\n");
+        }
+    }
+    
+    /**
+     * @brief Obtiene el carácter descifrado por el último `procesar` con una cascada.
+     * @return El carácter decodificado.
+     */
+    char getDecodificado() const {
+        return decodificado;
+    }
+};
+
+// CLASE: TRAMA MAP
+
+/**
+ * @class TramaMap
+ * @brief Representa una trama de mapeo/rotación ('M').
+ *
+ * Indica una rotación que debe aplicarse al rotor de mapeo. Con una cascada
+ * de rotores, "Mk,N" rota el rotor k y "MP,N" avanza la cascada N pasos con
+ * sus reglas de avance ("M,N" es "M0,N").
+ */
+class TramaMap : public TramaBase {
+private:
+    int rotacion; ///< El valor de rotación (positivo o negativo) a aplicar, o la cantidad de pasos.
+    int indiceRotor; ///< Rotor de la cascada al que se aplica, o ROTOR_PASOS.
+    
+public:
+    static const int ROTOR_PASOS = -1; ///< Valor de `indiceRotor` para "MP,N": avanzar en lugar de rotar.
+    
+    /**
+     * @brief Constructor.
+     * @param n El valor de rotación.
+     * @param r Rotor de la cascada (0 para "M,N"), o ROTOR_PASOS.
+     */
+    TramaMap(int n, int r = 0) : rotacion(n), indiceRotor(r) {}
+    
+    /**
+     * @brief Reasigna el valor de rotación, para reutilizar el objeto en otra trama.
+     * @param n El valor de rotación.
+     * @param r Rotor de la cascada (0 para "M,N"), o ROTOR_PASOS.
+     */
+    void setRotacion(int n, int r = 0) {
+        rotacion = n;
+        indiceRotor = r;
+    }
+    
+    /**
+     * @brief Procesa la trama: aplica la rotación al rotor.
+     *
+     * Las variantes de la cascada ("Mk,N" con k > 0 y "MP,N") no tienen
+     * sentido con un rotor simple y se ignoran.
+     * @param carga Puntero a la lista de carga (no se utiliza, pero es requerido por la interfaz base).
+     * @param rotor Puntero al rotor de mapeo.
+     */
+    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
+        if (indiceRotor != 0) return;
+        rotor->rotar(rotacion);
+        
+        if (salidaTraza != nullptr) {
+            salidaTraza->escribir(rotacion > 0 ? "ROTANDO ROTOR +" : "ROTANDO ROTOR ");
+            salidaTraza->escribirEntero(rotacion);
+            salidaTraza->escribirCaracter('\n');
+        }
+    }
+    
+    /**
+     * @brief Procesa la trama: rota un rotor de la cascada o la avanza.
+     * @param carga Puntero a la lista de carga (no se utiliza, pero es requerido por la interfaz base).
+     * @param cascada Puntero a la cascada de rotores (con más de `getIndiceRotor()` rotores).
+     */
+    void procesar(ListaDeCarga* /* carga */, CascadaDeRotores* cascada) {
+        if (indiceRotor == ROTOR_PASOS) {
+            cascada->avanzar(rotacion);
+        } else {
+            cascada->rotar(indiceRotor, rotacion);
+        }
+        
+        if (salidaTraza != nullptr) {
+            if (indiceRotor == ROTOR_PASOS) {
+                salidaTraza->escribir("AVANZANDO CASCADA ");
+                salidaTraza->escribirEntero(rotacion);
+                salidaTraza->escribir(" PASOS\n");
+                return;
+            }
+            salidaTraza->escribir("ROTANDO ROTOR ");
+            salidaTraza->escribirEntero(indiceRotor);
+            salidaTraza->escribir(rotacion > 0 ? " +" : " ");
+            salidaTraza->escribirEntero(rotacion);
+            salidaTraza->escribirCaracter('\n');
+        }
+    }
+    
+    /**
+     * @brief Obtiene el rotor de la cascada al que se aplica la trama.
+     * @return 0 para "M,N", k para "Mk,N" o ROTOR_PASOS para "MP,N".
+     */
+    int getIndiceRotor() const {
+        return indiceRotor;
+    }
+};
+
+// REPRESENTACIÓN SIN HEAP DE LAS TRAMAS
+
+/**
+ * @enum TipoTrama
+ * @brief Tipo de una trama ya parseada.
+ */
+enum TipoTrama {
+    TRAMA_LOAD,        ///< Trama de carga "L,X" (o "L,Space" para el espacio).
+    TRAMA_MAP,         ///< Trama de rotación "M,N" (o sus variantes de cascada "Mk,N" y "MP,N").
+    TRAMA_INICIO,      ///< Marcador de inicio de transmisión ("I").
+    TRAMA_FIN,         ///< Marcador de fin de transmisión ("FIN").
+    TRAMA_MAL_FORMADA, ///< Línea que no es una trama válida.
+    TRAMA_BINARIO,     ///< Marcador "BIN": los bytes siguientes son tramas binarias (ver prt7/binario.h).
+    TRAMA_DESCARTADA   ///< Trama descartada por el entramado: checksum incorrecto o línea demasiado larga.
+};
+
+/**
+ * @struct RegistroTrama
+ * @brief Trama parseada como valor etiquetado, sin reservar memoria.
+ */
+struct RegistroTrama {
+    TipoTrama tipo;  ///< Indica cuál de los campos siguientes es válido.
+    char caracter;   ///< Carácter cifrado (solo para TRAMA_LOAD).
+    signed char rotor; ///< Rotor de la cascada: 0 para "M,N", k para "Mk,N", TramaMap::ROTOR_PASOS para "MP,N".
+    int rotacion;    ///< Valor de rotación, o de pasos para "MP,N" (solo para TRAMA_MAP).
+    bool reparada;   ///< La trama se aceptó después de quitar ruido de sus extremos.
+};
+
+/**
+ * @class RanurasDeTrama
+ * @brief Un objeto reutilizable por cada tipo de trama.
+ *
+ * Permite obtener un `TramaBase*` para cada línea sin hacer `new`/`delete`:
+ * la ranura del tipo correspondiente se reasigna con los datos del registro.
+ */
+class RanurasDeTrama {
+private:
+    TramaLoad load; ///< Ranura para las tramas de carga.
+    TramaMap map;   ///< Ranura para las tramas de rotación.
+    
+public:
+    /**
+     * @brief Constructor. Crea las ranuras con valores neutros.
+     */
+    RanurasDeTrama() : load('\0'), map(0) {}
+    
+    /**
+     * @brief Carga un registro en la ranura de su tipo.
+     * @param registro La trama parseada.
+     * @return Puntero a la ranura (no debe liberarse con `delete`).
+     */
+    TramaBase* asignar(const RegistroTrama& registro) {
+        if (registro.tipo == TRAMA_LOAD) {
+            load.setCaracter(registro.caracter);
+            return &load;
+        }
+        map.setRotacion(registro.rotacion, registro.rotor);
+        return &map;
+    }
+    
+    /**
+     * @brief Obtiene el carácter descifrado por la última trama de carga procesada con una cascada.
+     * @return El carácter decodificado.
+     */
+    char getDecodificado() const {
+        return load.getDecodificado();
+    }
+};
+
+#endif // PRT7_TRAMAS_H
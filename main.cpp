@@ -7,452 +7,801 @@
  * las parsea en operaciones de carga de caracteres ('L') o rotación del rotor ('M'),
  * procesa cada trama y acumula el mensaje decodificado.
  *
+ * Este archivo contiene solo el programa de línea de comandos (opciones,
+ * apertura de puertos y capturas, varios puertos con epoll); el decodificador
+ * está en la biblioteca `prt7` (include/prt7, src).
+ *
  * @author Gemini
  * @date 06 de Noviembre de 2025
  */
 
 #include <iostream>
-#include <fcntl.h>      // Para open()
-#include <unistd.h>     // Para read(), write(), close()
-#include <termios.h>    // Para configuración del puerto serial
-#include <cstring>      // Para memset()
-
-using namespace std;
+#include <fcntl.h>      // Para open(), fcntl()
+#include <unistd.h>     // Para close()
+#include <cstring>      // Para strcmp(), strncpy()
+#include <cerrno>       // Para errno
+#include <cstdlib>      // Para strtol()
+#include <cstdio>       // Para fopen(), fgets()
+#include <sys/types.h>  // Para off_t
+#include <thread>       // Para std::thread
+#include <mutex>        // Para std::mutex (informes de varios puertos)
+#include <atomic>       // Para std::atomic (fin del monitor)
+#ifdef __linux__
+#include <sys/epoll.h>  // Para epoll (varios puertos)
+#endif
 
-// ESTRUCTURAS DE NODOS
-
-/**
- * @struct NodoRotor
- * @brief Nodo para la lista doblemente enlazada circular que representa el rotor de mapeo.
- */
-struct NodoRotor {
-    char dato;             ///< Carácter almacenado en el nodo (A-Z).
-    NodoRotor* siguiente;  ///< Puntero al siguiente nodo.
-    NodoRotor* previo;     ///< Puntero al nodo previo.
-    
-    /**
-     * @brief Constructor del nodo del rotor.
-     * @param d El carácter inicial para el nodo.
-     */
-    NodoRotor(char d) : dato(d), siguiente(nullptr), previo(nullptr) {}
-};
+#include "prt7/prt7.h"
 
-/**
- * @struct NodoCarga
- * @brief Nodo para la lista doblemente enlazada que almacena la carga/mensaje decodificado.
- */
-struct NodoCarga {
-    char dato;             ///< Carácter decodificado almacenado.
-    NodoCarga* siguiente;  ///< Puntero al siguiente nodo.
-    NodoCarga* previo;     ///< Puntero al nodo previo.
-    
-    /**
-     * @brief Constructor del nodo de carga.
-     * @param d El carácter inicial para el nodo.
-     */
-    NodoCarga(char d) : dato(d), siguiente(nullptr), previo(nullptr) {}
-};
+using namespace std;
 
-// CLASE: ROTOR DE MAPEO
+// CLASE: FLUJO SERIAL (VARIOS PUERTOS)
 
 /**
- * @class RotorDeMapeo
- * @brief Implementa el mecanismo de cifrado/descifrado mediante un rotor circular.
+ * @class FlujoSerial
+ * @brief Estado de decodificación independiente de un puerto cuando se atienden varios a la vez.
  *
- * Simula el rotor de una máquina de cifrado. Está compuesto por una lista
- * doblemente enlazada circular con los caracteres 'A' a 'Z'. La rotación
- * cambia el punto de inicio del mapeo (la 'cabeza').
+ * Cada puerto tiene su propio rotor, su propia carga y su propio lector con
+ * buffer, y lo atiende siempre el mismo hilo, así que nada de esto se
+ * comparte entre hilos.
  */
-class RotorDeMapeo {
+class FlujoSerial {
 private:
-    NodoRotor* cabeza; ///< Puntero al nodo actual que representa el inicio del mapeo.
+    char puerto[256];               ///< Ruta del puerto (para los informes).
+    int fd;                         ///< Descriptor no bloqueante del puerto.
+    LectorDeLineas lector;          ///< Lector con buffer del puerto.
+    RotorDeMapeo rotor;             ///< Rotor propio del flujo.
+    ListaDeCarga carga;             ///< Mensaje propio del flujo.
+    Decodificador decodificador;    ///< Decodificador sobre `rotor` y `carga`.
+    DecodificadorContinuo continuo; ///< Tramas de texto o binarias, en trozos como lleguen.
+    bool terminado;                 ///< Se recibió "FIN" o se cerró el puerto.
     
 public:
     /**
-     * @brief Constructor. Inicializa el rotor con el alfabeto ordenado (A-Z) en forma circular.
+     * @brief Constructor.
+     * @param ruta Ruta del puerto.
+     * @param descriptor Descriptor abierto (se pasa a modo no bloqueante).
      */
-    RotorDeMapeo() {
-    const char alfabeto[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZ";  // SIN espacio
-    int longitud = 26;  // Solo 26 letras
-    
-    cabeza = new NodoRotor(alfabeto[0]);
-    NodoRotor* actual = cabeza;
-    
-    for (int i = 1; i < longitud; i++) {
-        NodoRotor* nuevo = new NodoRotor(alfabeto[i]);
-        actual->siguiente = nuevo;
-        nuevo->previo = actual;
-        actual = nuevo;
+    FlujoSerial(const char* ruta, int descriptor)
+        : fd(descriptor), lector(descriptor), decodificador(&carga, &rotor), continuo(&decodificador),
+          terminado(false) {
+        strncpy(puerto, ruta, sizeof(puerto) - 1);
+        puerto[sizeof(puerto) - 1] = '\0';
+        fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
     }
     
-    // Cerrar el círculo
-    actual->siguiente = cabeza;
-    cabeza->previo = actual;
-}
-    
     /**
-     * @brief Destructor. Libera toda la memoria asignada a los nodos del rotor.
+     * @brief Destructor. Cierra el puerto.
      */
-    ~RotorDeMapeo() {
-    if (cabeza == nullptr) return;
-    
-    NodoRotor* ultimo = cabeza->previo;
-    ultimo->siguiente = nullptr; // Romper el círculo para la iteración
-    
-    NodoRotor* actual = cabeza;
-    while (actual != nullptr) {
-        NodoRotor* siguiente = actual->siguiente;
-        delete actual;
-        actual = siguiente;
+    ~FlujoSerial() {
+        close(fd);
     }
-}
     
     /**
-     * @brief Rota el rotor N posiciones.
-     * @param N El número de posiciones a rotar. Positivo para avanzar (siguiente), negativo para retroceder (previo).
+     * @brief Decodifica todos los bytes que ya llegaron, sin bloquearse.
+     *
+     * Las líneas o tramas binarias incompletas quedan en el decodificador
+     * continuo hasta que lleguen sus bytes restantes.
+     * @return true si el flujo terminó ("FIN" o puerto cerrado).
      */
-    void rotar(int N) {
-        if (N == 0) return;
+    bool atender() {
+        const char* datos;
+        size_t cantidad;
         
-        if (N > 0) {
-            for (int i = 0; i < N; i++) {
-                cabeza = cabeza->siguiente;
-            }
-        } else {
-            // Rotación negativa (hacia atrás)
-            N = -N;
-            for (int i = 0; i < N; i++) {
-                cabeza = cabeza->previo;
+        while (!terminado && lector.leerBloque(&datos, &cantidad, false)) {
+            if (!continuo.alimentar(datos, cantidad)) {
+                terminado = true;
             }
         }
+        if (!terminado && lector.getFinDeDatos()) {
+            continuo.finalizar();
+            terminado = true;
+        }
+        return terminado;
     }
     
     /**
-     * @brief Obtiene el carácter de mapeo (decodificado) para el carácter de entrada.
-     * @param in El carácter de entrada (cifrado). Se espera un carácter en mayúscula A-Z.
-     * @return El carácter decodificado. Devuelve el mismo carácter si es un espacio o no es A-Z.
+     * @brief Imprime el resultado del flujo, precedido por el nombre del puerto.
+     *
+     * Los informes de hilos distintos no se mezclan: se escriben de a uno.
+     * @param nivel Cantidad de información a imprimir.
      */
-    char getMapeo(char in) {
-    // CASO ESPECIAL: El espacio NO se cifra, se devuelve tal cual
-    if (in == ' ') {
-        return ' ';
+    void informar(NivelSalida nivel) {
+        static mutex cerrojo;
+        lock_guard<mutex> guardia(cerrojo);
+        
+        if (nivel != SALIDA_SILENCIOSA) {
+            long total = decodificador.getTramasCarga() + decodificador.getTramasMapeo() +
+                         decodificador.getTramasMalFormadas() + decodificador.getTramasDescartadas();
+            cout << "[" << puerto << "] Tramas procesadas: " << total
+                 << " (carga: " << decodificador.getTramasCarga()
+                 << ", mapeo: " << decodificador.getTramasMapeo()
+                 << ", mal formadas: " << decodificador.getTramasMalFormadas()
+                 << ", descartadas: " << decodificador.getTramasDescartadas()
+                 << ", reparadas: " << decodificador.getTramasReparadas() << ")" << endl;
+        }
+        cout << "[" << puerto << "] ";
+        carga.imprimirMensaje();
     }
     
-    // Solo procesar letras A-Z
-    if (in < 'A' || in > 'Z') {
-        return in;
+    /**
+     * @brief Obtiene el descriptor del puerto.
+     * @return El descriptor.
+     */
+    int getDescriptor() const {
+        return fd;
+    }
+};
+
+#ifdef __linux__
+/**
+ * @brief Atiende con epoll un grupo de flujos hasta que todos terminen.
+ *
+ * Cada hilo del grupo de trabajo vigila solo sus propios puertos; cuando un
+ * puerto no tiene datos, el hilo queda dormido en `epoll_wait` sin consumir CPU.
+ * @param flujos Flujos a atender.
+ * @param cantidad Cantidad de flujos.
+ * @param nivel Nivel de salida de los informes.
+ */
+void atenderFlujos(FlujoSerial** flujos, int cantidad, NivelSalida nivel) {
+    int epoll = epoll_create1(0);
+    if (epoll == -1) {
+        cout << "ERROR: No se pudo crear la instancia de epoll" << endl;
+        return;
     }
     
-    // La posición del carácter de entrada se calcula desde 'A'
-    int posicionDelCaracter = in - 'A';
-    
-    // Desde la cabeza actual (que está rotada), avanzar esa cantidad de posiciones
-    // para obtener el carácter de mapeo.
-    NodoRotor* resultado = cabeza;
-    for (int i = 0; i < posicionDelCaracter; i++) {
-        resultado = resultado->siguiente;
+    int pendientes = 0;
+    for (int i = 0; i < cantidad; i++) {
+        struct epoll_event evento;
+        evento.events = EPOLLIN;
+        evento.data.ptr = flujos[i];
+        if (epoll_ctl(epoll, EPOLL_CTL_ADD, flujos[i]->getDescriptor(), &evento) == 0) {
+            pendientes++;
+        } else {
+            // Descriptor que epoll no admite: se informa lo que haya y se descarta
+            flujos[i]->informar(nivel);
+        }
     }
     
-    return resultado->dato;
+    const int MAX_EVENTOS = 64;
+    struct epoll_event eventos[MAX_EVENTOS];
     
-    // NOTA: El bucle para encontrar 'A' en la implementación original
-    // ('for (int i = 0; i < 27; i++) { if (nodoA->dato == 'A') { break; } nodoA = nodoA->siguiente; }')
-    // es innecesario y potencialmente incorrecto si la rotación no es un desplazamiento simple
-    // o si el alfabeto no fuera A-Z, pero para el cifrado tipo Caesar/Enigma simple implementado,
-    // el mapeo se define por el *desplazamiento* desde la cabeza del rotor, lo cual se simplifica
-    // a la posición relativa desde 'A'. Se ha dejado la implementación simplificada aquí,
-    // asumiendo que el 'mapeo' es un cifrado César modificado por la rotación.
+    while (pendientes > 0) {
+        int listos = epoll_wait(epoll, eventos, MAX_EVENTOS, -1);
+        if (listos < 0) {
+            if (errno == EINTR) continue;
+            break;
+        }
+        
+        for (int i = 0; i < listos; i++) {
+            FlujoSerial* flujo = static_cast<FlujoSerial*>(eventos[i].data.ptr);
+            if (flujo->atender()) {
+                epoll_ctl(epoll, EPOLL_CTL_DEL, flujo->getDescriptor(), nullptr);
+                flujo->informar(nivel);
+                pendientes--;
+            }
+        }
+    }
+    
+    close(epoll);
 }
+#endif
+
+// FUNCIÓN: ABRIR CAPTURA
+
+/**
+ * @brief Abre una captura grabada de tramas para reproducirla.
+ *
+ * La captura tiene el mismo formato que envía el Arduino (líneas "L,X" / "M,N",
+ * con los marcadores "I" y "FIN") y se procesa por el mismo camino que el
+ * puerto serial, tan rápido como se pueda leer.
+ * @param ruta Path del archivo, o "-" para la entrada estándar (e.g., una tubería).
+ * @return El descriptor abierto, o -1 en caso de error.
+ */
+int abrirCaptura(const char* ruta) {
+    if (strcmp(ruta, "-") == 0) {
+        return STDIN_FILENO;
+    }
+    return open(ruta, O_RDONLY);
+}
+
+// FUNCIÓN: VOLCAR AL ESPERAR DATOS
+
+/**
+ * @struct VolcadosAlEsperar
+ * @brief Lo que se vuelca cuando el puerto queda inactivo: la traza y, si hay, el mensaje en flujo.
+ */
+struct VolcadosAlEsperar {
+    SalidaBufferizada* salida;  ///< Salida de la traza.
+    SumideroDeCarga* sumidero;  ///< Sumidero del mensaje, o nullptr.
 };
 
-// CLASE: LISTA DE CARGA
+/**
+ * @brief Aviso antes de esperar datos (ver LectorDeLineas::setAntesDeEsperar): vuelca lo pendiente.
+ * @param contexto Puntero a un VolcadosAlEsperar.
+ */
+void volcarAlEsperar(void* contexto) {
+    VolcadosAlEsperar* volcados = static_cast<VolcadosAlEsperar*>(contexto);
+    volcados->salida->volcar();
+    if (volcados->sumidero != nullptr) volcados->sumidero->volcar();
+}
+
+// FUNCIÓN: ALIMENTAR EL FLUJO CONTINUO
 
 /**
- * @class ListaDeCarga
- * @brief Lista doblemente enlazada para almacenar el mensaje decodificado.
+ * @brief Entrega a un DecodificadorContinuo el resto de una captura o del puerto, hasta "FIN".
+ *
+ * Con una captura mapeada se entrega de a trozos, para que FuenteMapeada
+ * libere las páginas ya procesadas; si no, se entrega cada bloque leído con
+ * `read()`. Al final procesa la última línea aunque no tenga terminador.
+ * Con una bitácora se escribe un punto de control después de los trozos en
+ * que venció su intervalo y otro al final.
+ * @param continuo Decodificador de flujo continuo.
+ * @param lector Lector del descriptor (se usa si `mapeada` es nullptr).
+ * @param mapeada Captura mapeada en memoria, o nullptr.
+ * @param enVivo Lista cuyos caracteres nuevos se imprimen después de cada trozo, o nullptr.
+ * @param sumidero Sumidero del mensaje, que vuelca después de los trozos en que hace falta, o nullptr.
+ * @param bitacora Bitácora de puntos de control, o nullptr.
+ * @param posicion Bytes de la entrada procesados antes de esta llamada (al reanudar una sesión).
+ * @param saltar Bytes que el lector debe descartar antes de empezar (entradas sin `lseek()`).
  */
-class ListaDeCarga {
-private:
-    NodoCarga* cabeza; ///< Puntero al primer nodo de la lista (inicio del mensaje).
-    NodoCarga* cola;   ///< Puntero al último nodo de la lista (fin del mensaje).
+void alimentarContinuo(DecodificadorContinuo* continuo, LectorDeLineas* lector,
+                       FuenteMapeada* mapeada, ListaDeCarga* enVivo, SumideroDeCarga* sumidero,
+                       BitacoraDeControl* bitacora = nullptr,
+                       unsigned long long posicion = 0, unsigned long long saltar = 0) {
+    const char* datos;
+    size_t cantidad;
     
-public:
-    /**
-     * @brief Constructor. Inicializa una lista vacía.
-     */
-    ListaDeCarga() : cabeza(nullptr), cola(nullptr) {}
-    
-    /**
-     * @brief Destructor. Libera toda la memoria asignada a los nodos de la carga.
-     */
-    ~ListaDeCarga() {
-        NodoCarga* actual = cabeza;
-        while (actual != nullptr) {
-            NodoCarga* siguiente = actual->siguiente;
-            delete actual;
-            actual = siguiente;
+    if (mapeada != nullptr) {
+        const size_t TROZO = 1 << 20;
+        while (true) {
+            mapeada->getPendiente(&datos, &cantidad);
+            if (cantidad == 0) break;
+            if (cantidad > TROZO) cantidad = TROZO;
+            bool continuar = continuo->alimentar(datos, cantidad);
+            mapeada->avanzar(cantidad);
+            posicion += cantidad;
+            if (enVivo != nullptr) enVivo->imprimirNuevos();
+            if (sumidero != nullptr) sumidero->volcarSiHaceFalta();
+            if (bitacora != nullptr) bitacora->registrarSiVencido(*continuo, posicion);
+            if (!continuar) break;
+        }
+    } else {
+        while (lector->leerBloque(&datos, &cantidad)) {
+            if (saltar > 0) {
+                // Bytes ya procesados antes de reanudar
+                size_t saltados = saltar < cantidad ? (size_t)saltar : cantidad;
+                saltar -= saltados;
+                datos += saltados;
+                cantidad -= saltados;
+            }
+            bool continuar = continuo->alimentar(datos, cantidad);
+            posicion += cantidad;
+            if (enVivo != nullptr) enVivo->imprimirNuevos();
+            if (sumidero != nullptr) sumidero->volcarSiHaceFalta();
+            if (bitacora != nullptr) bitacora->registrarSiVencido(*continuo, posicion);
+            if (!continuar) break;
         }
     }
+    continuo->finalizar();
     
-    /**
-     * @brief Inserta un carácter al final de la lista de carga.
-     * @param dato El carácter a insertar.
-     */
-    void insertarAlFinal(char dato) {
-        NodoCarga* nuevo = new NodoCarga(dato);
-        
-        if (cabeza == nullptr) {
-            cabeza = nuevo;
-            cola = nuevo;
-        } else {
-            cola->siguiente = nuevo;
-            nuevo->previo = cola;
-            cola = nuevo;
-        }
+    if (bitacora != nullptr) {
+        bitacora->registrar(*continuo, posicion);
+        bitacora->sincronizar();
     }
+}
+
+// FUNCIÓN: MONITOR
+
+/**
+ * @brief Escribe en stderr una línea con el estado publicado en una instantánea.
+ * @param instantanea Instantánea del decodificador.
+ */
+void informarEstado(InstantaneaDeEstado* instantanea) {
+    EstadoDecodificador estado;
+    instantanea->leer(&estado);
     
-    /**
-     * @brief Imprime el mensaje completo contenido en la lista.
-     */
-    void imprimirMensaje() {
-        NodoCarga* actual = cabeza;
-        while (actual != nullptr) {
-            cout << actual->dato;
-            actual = actual->siguiente;
-        }
-        cout << endl;
+    // Los caracteres de control se muestran como '.' para no romper la línea
+    for (size_t i = 0; i < estado.cantidadRecientes; i++) {
+        if ((unsigned char)estado.recientes[i] < ' ') estado.recientes[i] = '.';
     }
-};
+    
+    char linea[256];
+    int largo = snprintf(linea, sizeof(linea),
+                         "[monitor] trama %ld, rotor %d, mensaje %ld caracteres (mapeo: %ld, mal formadas: %ld, "
+                         "descartadas: %ld), ultimos: \"%s\"\n",
+                         estado.getSecuencia(), estado.desplazamiento, estado.tramasCarga, estado.tramasMapeo,
+                         estado.tramasMalFormadas, estado.tramasDescartadas, estado.recientes);
+    if (largo > (int)sizeof(linea) - 1) largo = (int)sizeof(linea) - 1;
+    escribirTodo(STDERR_FILENO, linea, (size_t)largo);
+}
 
-// CLASE BASE: TRAMA
+/**
+ * @brief Hilo de monitoreo: cada `intervaloMs` informa el estado del decodificador sin detenerlo.
+ *
+ * Lee la instantánea con el seqlock, así que el hilo que decodifica nunca
+ * espera al monitor. Al terminar informa el estado final.
+ * @param instantanea Instantánea del decodificador.
+ * @param intervaloMs Milisegundos entre dos informes.
+ * @param terminar Se pone en true para que el hilo termine.
+ */
+void monitorear(InstantaneaDeEstado* instantanea, int intervaloMs, const atomic<bool>* terminar) {
+    long ultimo = SalidaBufferizada::milisegundos();
+    while (!terminar->load(memory_order_acquire)) {
+        // Dormir de a poco para terminar enseguida cuando termina la decodificación
+        usleep(intervaloMs < 10 ? (unsigned)intervaloMs * 1000u : 10000u);
+        long ahora = SalidaBufferizada::milisegundos();
+        if (ahora - ultimo >= intervaloMs) {
+            informarEstado(instantanea);
+            ultimo = ahora;
+        }
+    }
+    informarEstado(instantanea);
+}
 
 /**
- * @class TramaBase
- * @brief Clase base abstracta para todos los tipos de tramas de comunicación.
+ * @struct HiloMonitor
+ * @brief Hilo del monitor que se detiene y se espera al salir de su ámbito, por cualquier camino.
  */
-class TramaBase {
-public:
+struct HiloMonitor {
+    thread hilo;              ///< Hilo que ejecuta `monitorear` (no joinable si no hay monitor).
+    atomic<bool> terminar;    ///< Aviso de fin para el hilo.
+    
     /**
-     * @brief Método virtual puro para procesar la trama. Debe ser implementado por las clases derivadas.
-     * @param carga Puntero a la lista de carga donde se almacena el mensaje.
-     * @param rotor Puntero al rotor de mapeo para realizar operaciones.
+     * @brief Constructor. No inicia ningún hilo.
      */
-    virtual void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) = 0;
+    HiloMonitor() : terminar(false) {}
     
     /**
-     * @brief Destructor virtual.
+     * @brief Destructor. Detiene el hilo si sigue activo.
      */
-    virtual ~TramaBase() {}
-};
-
-// CLASE: TRAMA LOAD
-
-/**
- * @class TramaLoad
- * @brief Representa una trama de carga de carácter ('L').
- *
- * Contiene un carácter cifrado que debe ser decodificado por el rotor
- * y añadido a la lista de carga.
- */
-class TramaLoad : public TramaBase {
-private:
-    char caracter; ///< El carácter cifrado a decodificar.
+    ~HiloMonitor() {
+        detener();
+    }
     
-public:
     /**
-     * @brief Constructor.
-     * @param c El carácter cifrado.
+     * @brief Inicia el hilo del monitor.
+     * @param instantanea Instantánea del decodificador.
+     * @param intervaloMs Milisegundos entre dos informes.
      */
-    TramaLoad(char c) : caracter(c) {}
+    void iniciar(InstantaneaDeEstado* instantanea, int intervaloMs) {
+        hilo = thread(monitorear, instantanea, intervaloMs, &terminar);
+    }
     
     /**
-     * @brief Procesa la trama: decodifica el carácter y lo añade a la lista de carga.
-     * @param carga Puntero a la lista de carga.
-     * @param rotor Puntero al rotor de mapeo.
+     * @brief Avisa al hilo que termine (informa el estado final) y lo espera.
      */
-    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
-        char decodificado = rotor->getMapeo(caracter);
-        carga->insertarAlFinal(decodificado);
-        cout << "Fragmento '" << caracter << "' decodificado como '" 
-             << decodificado << "'." << endl;
+    void detener() {
+        if (hilo.joinable()) {
+            terminar.store(true, memory_order_release);
+            hilo.join();
+        }
     }
 };
 
-// CLASE: TRAMA MAP
+// FUNCIÓN: OPCIONES DEL PROGRAMA
 
 /**
- * @class TramaMap
- * @brief Representa una trama de mapeo/rotación ('M').
- *
- * Indica una rotación que debe aplicarse al rotor de mapeo.
+ * @struct Opciones
+ * @brief Opciones de ejecución tomadas de la línea de comandos o de un archivo de configuración.
  */
-class TramaMap : public TramaBase {
-private:
-    int rotacion; ///< El valor de rotación (positivo o negativo) a aplicar.
+struct Opciones {
+    static const int MAX_PUERTOS = 64; ///< Puertos que se pueden atender a la vez.
     
-public:
-    /**
-     * @brief Constructor.
-     * @param n El valor de rotación.
-     */
-    TramaMap(int n) : rotacion(n) {}
+    ConfiguracionSerial serial;  ///< Parámetros del puerto serial (`serial.puerto` es el primero).
+    char puertos[MAX_PUERTOS][256]; ///< Todos los puertos indicados con `--puerto`.
+    int cantidadPuertos;         ///< Cantidad de entradas usadas en `puertos`.
+    NivelSalida nivelSalida;     ///< Cantidad de información impresa durante la decodificación.
+    char entrada[256];           ///< Captura a reproducir en lugar del puerto ("-" = entrada estándar).
+    bool usarMmap;               ///< Mapear la captura en memoria cuando es un archivo regular.
+    int hilos;                   ///< Hilos para decodificar una captura mapeada sin traza.
+    bool pipeline;               ///< Leer, decodificar y escribir la traza en hilos separados.
+    bool enVivo;                 ///< Mostrar el mensaje a medida que se decodifica (sin traza).
+    char bitacora[256];          ///< Bitácora de puntos de control para reanudar la sesión ("" = ninguna).
+    int intervaloControl;        ///< Milisegundos mínimos entre dos puntos de control.
+    char cascada[512];           ///< Cascada de rotores (e.g., "III,II,I/B"; "" = rotor simple).
+    bool pasoPorCarga;           ///< La cascada avanza un paso en cada carga.
+    int monitor;                 ///< Milisegundos entre dos informes del monitor (0 = sin monitor).
+    char salida[256];            ///< Destino del mensaje a medida que se decodifica ("" = imprimirlo al final).
+    char informe[256];           ///< Destino del informe JSON de fin de sesión ("" = ninguno).
     
     /**
-     * @brief Procesa la trama: aplica la rotación al rotor.
-     * @param carga Puntero a la lista de carga (no se utiliza, pero es requerido por la interfaz base).
-     * @param rotor Puntero al rotor de mapeo.
+     * @brief Constructor. Por defecto se lee del puerto serial y se imprime la traza completa.
      */
-    void procesar(ListaDeCarga* carga, RotorDeMapeo* rotor) {
-        rotor->rotar(rotacion);
-        
-        if (rotacion > 0) {
-            cout << "ROTANDO ROTOR +" << rotacion << endl;
-        } else {
-            cout << "ROTANDO ROTOR " << rotacion << endl;
-        }
+    Opciones() : cantidadPuertos(0), nivelSalida(SALIDA_TRAZA), usarMmap(true), hilos(1),
+                 pipeline(false), enVivo(false), intervaloControl(BitacoraDeControl::INTERVALO_MS),
+                 pasoPorCarga(false), monitor(0) {
+        entrada[0] = '\0';
+        bitacora[0] = '\0';
+        cascada[0] = '\0';
+        salida[0] = '\0';
+        informe[0] = '\0';
     }
 };
 
-// FUNCIÓN: CONFIGURAR PUERTO SERIAL
+/**
+ * @brief Convierte un texto a entero validando el rango.
+ * @param texto El texto a convertir.
+ * @param minimo Valor mínimo aceptado.
+ * @param maximo Valor máximo aceptado.
+ * @param valor Recibe el número convertido.
+ * @return true si el texto es un entero completo dentro del rango.
+ */
+bool leerEntero(const char* texto, long minimo, long maximo, int* valor) {
+    char* fin;
+    errno = 0;
+    long numero = strtol(texto, &fin, 10);
+    if (fin == texto || *fin != '\0' || errno != 0 || numero < minimo || numero > maximo) {
+        return false;
+    }
+    *valor = (int)numero;
+    return true;
+}
 
 /**
- * @brief Configura y abre el puerto serial para la comunicación.
- * @param puerto El path del dispositivo serial (e.g., "/dev/ttyUSB0").
- * @return El descriptor de archivo del puerto abierto, o -1 en caso de error.
+ * @brief Interpreta un valor booleano ("1", "si", "true", "0", "no", "false").
+ * @param texto El texto a interpretar.
+ * @param valor Recibe el valor interpretado.
+ * @return true si el texto es un booleano reconocido.
  */
-int configurarSerial(const char* puerto) {
-    // Abrir el puerto serial
-    int fd = open(puerto, O_RDWR | O_NOCTTY);
-    
-    if (fd == -1) {
-        return -1;
+bool leerBooleano(const char* texto, bool* valor) {
+    if (strcmp(texto, "1") == 0 || strcmp(texto, "si") == 0 || strcmp(texto, "true") == 0) {
+        *valor = true;
+        return true;
     }
+    if (strcmp(texto, "0") == 0 || strcmp(texto, "no") == 0 || strcmp(texto, "false") == 0) {
+        *valor = false;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * @brief Aplica una opción `clave = valor`, común a la línea de comandos y al archivo de configuración.
+ * @param clave Nombre de la opción sin los guiones iniciales (e.g., "baudios").
+ * @param valor Valor de la opción.
+ * @param opciones Opciones a modificar.
+ * @return true si la clave existe y el valor es válido.
+ */
+bool aplicarOpcion(const char* clave, const char* valor, Opciones* opciones) {
+    ConfiguracionSerial* serial = &opciones->serial;
     
-    // Configurar parámetros del puerto
-    struct termios opciones;
-    
-    // Obtener configuración actual
-    tcgetattr(fd, &opciones);
-    
-    // Configurar velocidad (9600 baudios)
-    cfsetispeed(&opciones, B9600);
-    cfsetospeed(&opciones, B9600);
-    
-    // Configuración: 8N1 (8 bits, sin paridad, 1 bit de stop)
-    opciones.c_cflag &= ~PARENB;  // Sin paridad
-    opciones.c_cflag &= ~CSTOPB;  // 1 bit de stop
-    opciones.c_cflag &= ~CSIZE;   // Limpiar tamaño
-    opciones.c_cflag |= CS8;      // 8 bits
-    
-    // Deshabilitar control de flujo hardware
-    opciones.c_cflag &= ~CRTSCTS;
-    
-    // Habilitar lectura
-    opciones.c_cflag |= CREAD | CLOCAL;
-    
-    // Modo raw (sin procesamiento)
-    opciones.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
-    opciones.c_iflag &= ~(IXON | IXOFF | IXANY);
-    opciones.c_oflag &= ~OPOST;
-    
-    // Aplicar configuración
-    tcsetattr(fd, TCSANOW, &opciones);
-    
-    // Esperar un momento para que se estabilice
-    usleep(100000); // 100ms
+    if (strcmp(clave, "puerto") == 0) {
+        // Cada aparición agrega un puerto; el primero queda también en la configuración serial
+        if (opciones->cantidadPuertos == Opciones::MAX_PUERTOS) return false;
+        char* destino = opciones->puertos[opciones->cantidadPuertos++];
+        strncpy(destino, valor, sizeof(opciones->puertos[0]) - 1);
+        destino[sizeof(opciones->puertos[0]) - 1] = '\0';
+        if (opciones->cantidadPuertos == 1) {
+            strcpy(serial->puerto, destino);
+        }
+        return true;
+    }
+    if (strcmp(clave, "baudios") == 0) {
+        int baudios;
+        if (!leerEntero(valor, 1, 4000000, &baudios) || convertirBaudios(baudios) == B0) return false;
+        serial->baudios = baudios;
+        return true;
+    }
+    if (strcmp(clave, "vmin") == 0) {
+        return leerEntero(valor, 0, 255, &serial->vmin);
+    }
+    if (strcmp(clave, "vtime") == 0) {
+        return leerEntero(valor, 0, 255, &serial->vtime);
+    }
+    if (strcmp(clave, "baja-latencia") == 0) {
+        return leerBooleano(valor, &serial->bajaLatencia);
+    }
+    if (strcmp(clave, "entrada") == 0) {
+        strncpy(opciones->entrada, valor, sizeof(opciones->entrada) - 1);
+        opciones->entrada[sizeof(opciones->entrada) - 1] = '\0';
+        return true;
+    }
+    if (strcmp(clave, "sin-mmap") == 0) {
+        bool desactivar;
+        if (!leerBooleano(valor, &desactivar)) return false;
+        opciones->usarMmap = !desactivar;
+        return true;
+    }
+    if (strcmp(clave, "hilos") == 0) {
+        return leerEntero(valor, 1, 256, &opciones->hilos);
+    }
+    if (strcmp(clave, "pipeline") == 0) {
+        return leerBooleano(valor, &opciones->pipeline);
+    }
+    if (strcmp(clave, "en-vivo") == 0) {
+        return leerBooleano(valor, &opciones->enVivo);
+    }
+    if (strcmp(clave, "bitacora") == 0) {
+        strncpy(opciones->bitacora, valor, sizeof(opciones->bitacora) - 1);
+        opciones->bitacora[sizeof(opciones->bitacora) - 1] = '\0';
+        return true;
+    }
+    if (strcmp(clave, "salida") == 0) {
+        strncpy(opciones->salida, valor, sizeof(opciones->salida) - 1);
+        opciones->salida[sizeof(opciones->salida) - 1] = '\0';
+        return true;
+    }
+    if (strcmp(clave, "intervalo-control") == 0) {
+        return leerEntero(valor, 0, 3600000, &opciones->intervaloControl);
+    }
+    if (strcmp(clave, "cascada") == 0) {
+        CascadaDeRotores prueba;
+        if (strlen(valor) >= sizeof(opciones->cascada) || !prueba.configurar(valor)) return false;
+        strcpy(opciones->cascada, valor);
+        return true;
+    }
+    if (strcmp(clave, "paso-por-carga") == 0) {
+        return leerBooleano(valor, &opciones->pasoPorCarga);
+    }
+    if (strcmp(clave, "monitor") == 0) {
+        return leerEntero(valor, 0, 3600000, &opciones->monitor);
+    }
+    if (strcmp(clave, "informe") == 0) {
+        if (valor[0] == '\0' || strlen(valor) >= sizeof(opciones->informe)) return false;
+        strcpy(opciones->informe, valor);
+        return true;
+    }
+    if (strcmp(clave, "verbosidad") == 0) {
+        if (strcmp(valor, "silencio") == 0) {
+            opciones->nivelSalida = SALIDA_SILENCIOSA;
+        } else if (strcmp(valor, "resumen") == 0) {
+            opciones->nivelSalida = SALIDA_RESUMEN;
+        } else if (strcmp(valor, "traza") == 0) {
+            opciones->nivelSalida = SALIDA_TRAZA;
+        } else {
+            return false;
+        }
+        return true;
+    }
     
-    return fd;
+    return false;
 }
 
-// FUNCIÓN: LEER LÍNEA DEL PUERTO SERIAL
+/**
+ * @brief Indica si una opción es un interruptor que no lleva valor en la línea de comandos.
+ * @param clave Nombre de la opción sin los guiones iniciales.
+ * @return true si la opción se activa solo con su nombre.
+ */
+bool esInterruptor(const char* clave) {
+    return strcmp(clave, "baja-latencia") == 0 || strcmp(clave, "sin-mmap") == 0 ||
+           strcmp(clave, "pipeline") == 0 || strcmp(clave, "en-vivo") == 0 ||
+           strcmp(clave, "paso-por-carga") == 0;
+}
 
 /**
- * @brief Lee una línea de texto desde el puerto serial.
- * @param fd Descriptor de archivo del puerto serial.
- * @param buffer Buffer donde se almacenará la línea leída.
- * @param maxLen Longitud máxima del buffer.
- * @return true si se leyó una línea no vacía terminada por '\n' o '\r', false en caso contrario.
+ * @brief Carga un archivo de configuración con líneas `clave = valor`.
+ *
+ * Se ignoran las líneas vacías y las que comienzan con '#'.
+ * @param ruta Path del archivo.
+ * @param opciones Opciones a modificar.
+ * @return true si el archivo se leyó y todas sus opciones son válidas.
  */
-bool leerLineaSerial(int fd, char* buffer, int maxLen) {
-    int posicion = 0;
+bool cargarConfiguracion(const char* ruta, Opciones* opciones) {
+    FILE* archivo = fopen(ruta, "r");
+    if (archivo == nullptr) {
+        cout << "ERROR: No se pudo abrir el archivo de configuracion " << ruta << endl;
+        return false;
+    }
+    
+    char renglon[512];
+    int numero = 0;
+    bool correcto = true;
     
-    while (posicion < maxLen - 1) {
-        char c;
-        int n = read(fd, &c, 1);
+    while (fgets(renglon, sizeof(renglon), archivo) != nullptr) {
+        numero++;
         
-        if (n <= 0) {
-            // No hay datos disponibles o error
-            continue;
+        // Quitar salto de línea y espacios finales
+        int largo = (int)strlen(renglon);
+        while (largo > 0 && (renglon[largo - 1] == '\n' || renglon[largo - 1] == '\r' ||
+                             renglon[largo - 1] == ' ' || renglon[largo - 1] == '\t')) {
+            renglon[--largo] = '\0';
         }
         
-        // Si es salto de línea, terminamos
-        if (c == '\n' || c == '\r') {
-            if (posicion > 0) {
-                buffer[posicion] = '\0';
-                return true;
-            }
+        char* clave = renglon;
+        while (*clave == ' ' || *clave == '\t') clave++;
+        if (*clave == '\0' || *clave == '#') continue;
+        
+        char* igual = strchr(clave, '=');
+        if (igual == nullptr) {
+            cout << "ERROR: " << ruta << ":" << numero << ": se esperaba clave = valor" << endl;
+            correcto = false;
             continue;
         }
         
-        // Agregar carácter al buffer
-        buffer[posicion++] = c;
+        // Separar y recortar clave y valor
+        char* finClave = igual;
+        while (finClave > clave && (finClave[-1] == ' ' || finClave[-1] == '\t')) finClave--;
+        *finClave = '\0';
+        char* valor = igual + 1;
+        while (*valor == ' ' || *valor == '\t') valor++;
+        
+        if (!aplicarOpcion(clave, valor, opciones)) {
+            cout << "ERROR: " << ruta << ":" << numero << ": opcion invalida '" << clave << "'" << endl;
+            correcto = false;
+        }
     }
     
-    buffer[posicion] = '\0';
-    return posicion > 0;
+    fclose(archivo);
+    return correcto;
 }
 
-// FUNCIÓN: PARSEAR LÍNEA
+/**
+ * @brief Muestra la ayuda de uso del programa.
+ * @param programa Nombre con el que se invocó el programa.
+ */
+void mostrarUso(const char* programa) {
+    cout << "Uso: " << programa << " [opciones]" << endl
+         << "  --puerto RUTA        Dispositivo serial (si se omite, se pregunta); puede" << endl
+         << "                       repetirse para atender varios puertos con epoll" << endl
+         << "  --baudios N          Velocidad: 1200 ... 921600 (por defecto 9600)" << endl
+         << "  --vmin N             termios VMIN, 0-255 (por defecto 1)" << endl
+         << "  --vtime N            termios VTIME en decimas de segundo, 0-255 (por defecto 0)" << endl
+         << "  --baja-latencia      Solicita ASYNC_LOW_LATENCY al driver serial" << endl
+         << "  --entrada RUTA       Reproduce una captura de tramas (\"-\" = entrada estandar)" << endl
+         << "                       en lugar de leer del puerto serial" << endl
+         << "  --sin-mmap           Lee la captura con read() en lugar de mapearla en memoria" << endl
+         << "  --hilos N            Decodifica la captura mapeada con N hilos (sin traza)," << endl
+         << "                       o reparte los puertos entre N hilos" << endl
+         << "  --pipeline           Lee, decodifica y escribe la traza en hilos separados" << endl
+         << "  --en-vivo            Muestra el mensaje a medida que llega (solo los caracteres" << endl
+         << "                       nuevos); requiere verbosidad silencio o resumen" << endl
+         << "  --bitacora ARCHIVO   Guarda puntos de control y, al reiniciar, reanuda la sesion" << endl
+         << "                       desde el ultimo; requiere verbosidad silencio o resumen" << endl
+         << "  --intervalo-control MS  Milisegundos entre puntos de control (por defecto 250)" << endl
+         << "  --salida DESTINO     Envia el mensaje a medida que se decodifica, sin guardarlo" << endl
+         << "                       entero: ARCHIVO, unix:RUTA, tcp:HOST:PUERTO o \"-\"" << endl
+         << "  --cascada ESPEC      Descifra con una cascada de rotores, del rapido al lento y" << endl
+         << "                       con reflector opcional (e.g., III,II,I/B); acepta las" << endl
+         << "                       tramas Mk,N (rotor k) y MP,N (N pasos de avance)" << endl
+         << "  --paso-por-carga     La cascada avanza un paso antes de cada caracter" << endl
+         << "  --monitor MS         Informa en stderr, cada MS milisegundos, el estado de la" << endl
+         << "                       decodificacion (leido sin detenerla)" << endl
+         << "  --informe DESTINO    Al terminar escribe un informe JSON de la sesion (ritmo," << endl
+         << "                       latencia, espera en read(), memoria) en ARCHIVO o \"-\";" << endl
+         << "                       la latencia se mide solo si la entrada se lee con read()" << endl
+         << "  --verbosidad NIVEL   silencio | resumen | traza (por defecto traza)" << endl
+         << "  --config ARCHIVO     Lee opciones 'clave = valor' desde un archivo" << endl
+         << "  --ayuda              Muestra este mensaje" << endl;
+}
 
 /**
- * @brief Parsea una línea de texto (trama) y crea el objeto TramaBase correspondiente.
- * @param linea La cadena de texto de la trama (e.g., "L,A" o "M,-5").
- * @return Un puntero a un nuevo objeto TramaBase (TramaLoad o TramaMap) o nullptr si la trama está mal formada.
- * @note El objeto retornado debe ser liberado con `delete`.
+ * @brief Interpreta los argumentos de la línea de comandos.
+ *
+ * Las opciones se aplican en orden, así que un valor dado después de
+ * `--config` reemplaza al del archivo.
+ * @param argc Cantidad de argumentos.
+ * @param argv Argumentos del programa.
+ * @param opciones Opciones a llenar.
+ * @return 0 para continuar, 1 si hubo un error, -1 si solo se pidió la ayuda.
  */
-TramaBase* parsearLinea(char* linea) {
-    int longitud = 0;
-    while (linea[longitud] != '\0') {
-        longitud++;
-    }
-    
-    if (longitud < 3) return nullptr; // Trama mínima "L,X" o "M,N" (M,N requiere al menos 3)
+int analizarArgumentos(int argc, char* argv[], Opciones* opciones) {
+    bool puertosEnLinea = false;
     
-    char tipo = linea[0];
-    
-    if (linea[1] != ',') return nullptr;
-    
-    if (tipo == 'L') {
-        // Trama: L,X
-        char caracter = linea[2];
-        return new TramaLoad(caracter);
-    }
-    else if (tipo == 'M') {
-        // Trama: M,N o M,-N
-        int numero = 0;
-        int signo = 1;
-        int indice = 2;
+    for (int i = 1; i < argc; i++) {
+        const char* argumento = argv[i];
         
-        if (linea[indice] == '-') {
-            signo = -1;
-            indice++;
+        if (strcmp(argumento, "--ayuda") == 0 || strcmp(argumento, "-h") == 0) {
+            mostrarUso(argv[0]);
+            return -1;
         }
+        if (argumento[0] != '-' || argumento[1] != '-') {
+            cout << "ERROR: Argumento desconocido '" << argumento << "'" << endl;
+            return 1;
+        }
+        
+        const char* clave = argumento + 2;
         
-        while (linea[indice] >= '0' && linea[indice] <= '9') {
-            numero = numero * 10 + (linea[indice] - '0');
-            indice++;
+        if (esInterruptor(clave)) {
+            aplicarOpcion(clave, "1", opciones);
+            continue;
+        }
+        if (i + 1 >= argc) {
+            cout << "ERROR: Falta el valor de " << argumento << endl;
+            return 1;
         }
         
-        if (indice == 2 || (signo == -1 && indice == 3)) {
-             // Caso de M, o M,- (sin número)
-             return nullptr; 
+        const char* valor = argv[++i];
+        
+        if (strcmp(clave, "puerto") == 0 && !puertosEnLinea) {
+            // Los puertos de la línea de comandos reemplazan a los del archivo
+            opciones->cantidadPuertos = 0;
+            puertosEnLinea = true;
         }
         
-        numero *= signo;
-        return new TramaMap(numero);
+        if (strcmp(clave, "config") == 0) {
+            if (!cargarConfiguracion(valor, opciones)) return 1;
+        } else if (!aplicarOpcion(clave, valor, opciones)) {
+            cout << "ERROR: Opcion invalida " << argumento << " " << valor << endl;
+            return 1;
+        }
     }
+    return 0;
+}
+
+// FUNCIÓN: DECODIFICAR VARIOS PUERTOS
+
+/**
+ * @brief Abre todos los puertos de las opciones y los decodifica a la vez hasta que todos terminen.
+ *
+ * Cada puerto conserva su propio rotor y su propia carga. Los puertos se
+ * reparten entre `opciones.hilos` hilos (el puerto i va al hilo i % hilos) y
+ * cada hilo los multiplexa con epoll. El resultado de cada puerto se imprime
+ * cuando recibe "FIN" o se cierra; no hay traza por trama.
+ * @param opciones Opciones del programa, con dos o más puertos.
+ * @return 0 si se pudo abrir al menos un puerto, 1 si no.
+ */
+int decodificarPuertos(const Opciones& opciones) {
+#ifdef __linux__
+    bool silencio = opciones.nivelSalida == SALIDA_SILENCIOSA;
+    FlujoSerial** flujos = new FlujoSerial*[opciones.cantidadPuertos];
+    int abiertos = 0;
+    
+    for (int i = 0; i < opciones.cantidadPuertos; i++) {
+        ConfiguracionSerial config = opciones.serial;
+        strcpy(config.puerto, opciones.puertos[i]);
+        
+        if (!silencio) {
+            cout << "Conectando al puerto " << config.puerto << "..." << endl;
+        }
+        int fd = configurarSerial(config);
+        if (fd == -1) {
+            // Un puerto ausente no impide atender los demás
+            cout << "ERROR: No se pudo abrir el puerto " << config.puerto << endl;
+            continue;
+        }
+        flujos[abiertos++] = new FlujoSerial(config.puerto, fd);
+    }
+    
+    if (abiertos == 0) {
+        delete[] flujos;
+        return 1;
+    }
+    if (!silencio) {
+        cout << "Conexion establecida con " << abiertos << " puertos!" << endl;
+    }
+    
+    // Repartir los flujos entre los hilos, en el mismo orden en que se abrieron
+    int hilos = opciones.hilos < abiertos ? opciones.hilos : abiertos;
+    FlujoSerial** grupos = new FlujoSerial*[abiertos];
+    int* inicioGrupo = new int[hilos + 1];
+    int posicion = 0;
+    for (int k = 0; k < hilos; k++) {
+        inicioGrupo[k] = posicion;
+        for (int i = k; i < abiertos; i += hilos) {
+            grupos[posicion++] = flujos[i];
+        }
+    }
+    inicioGrupo[hilos] = posicion;
     
-    return nullptr;
+    // El hilo principal atiende el primer grupo
+    thread* trabajadores = new thread[hilos > 1 ? hilos - 1 : 1];
+    for (int k = 1; k < hilos; k++) {
+        trabajadores[k - 1] = thread(atenderFlujos, grupos + inicioGrupo[k],
+                                     inicioGrupo[k + 1] - inicioGrupo[k], opciones.nivelSalida);
+    }
+    atenderFlujos(grupos, inicioGrupo[1], opciones.nivelSalida);
+    for (int k = 1; k < hilos; k++) {
+        trabajadores[k - 1].join();
+    }
+    
+    delete[] trabajadores;
+    delete[] inicioGrupo;
+    delete[] grupos;
+    for (int i = 0; i < abiertos; i++) {
+        delete flujos[i];
+    }
+    delete[] flujos;
+    PRT7_VOLCAR_INSTRUMENTACION();
+    
+    if (!silencio) {
+        cout << endl << "Sistema apagado correctamente." << endl;
+    }
+    return 0;
+#else
+    (void)opciones;
+    cout << "ERROR: Atender varios puertos requiere epoll (Linux)" << endl;
+    return 1;
+#endif
 }
 
 // FUNCIÓN PRINCIPAL
@@ -460,86 +809,381 @@ TramaBase* parsearLinea(char* linea) {
 /**
  * @brief Punto de entrada principal del programa.
  *
- * Inicializa las estructuras de datos, solicita el puerto serial al usuario,
- * establece la conexión y entra en un bucle para leer, parsear y procesar
- * las tramas seriales hasta recibir la señal "FIN".
- * @return 0 si la ejecución finaliza con éxito, 1 en caso de error de conexión.
+ * Inicializa las estructuras de datos, toma la configuración del puerto de la
+ * línea de comandos (o la solicita al usuario), establece la conexión y entra
+ * en un bucle para leer, parsear y procesar las tramas seriales hasta recibir
+ * la señal "FIN".
+ * @param argc Cantidad de argumentos.
+ * @param argv Argumentos del programa (ver `--ayuda`).
+ * @return 0 si la ejecución finaliza con éxito, 1 en caso de error de conexión o de argumentos.
  */
-int main() {
-    cout << "  DECODIFICADOR PRT-7" << endl;
+int main(int argc, char* argv[]) {
+    PRT7_INSTALAR_VOLCADO();
     
-    // Crear estructuras de datos
-    ListaDeCarga miListaDeCarga;
-    RotorDeMapeo miRotorDeMapeo;
+    Opciones opciones;
+    int resultado = analizarArgumentos(argc, argv, &opciones);
+    if (resultado != 0) {
+        return resultado < 0 ? 0 : 1;
+    }
     
-    // Pedir puerto
-    cout << "Ingrese el puerto serial del Arduino:" << endl;
-    cout << "(Puerto: /dev/ttyUSB0)" << endl;
+    bool traza = opciones.nivelSalida == SALIDA_TRAZA;
+    bool silencio = opciones.nivelSalida == SALIDA_SILENCIOSA;
     
-    char puerto[50];
-    cin.getline(puerto, 50);
+    if (opciones.enVivo && (traza || opciones.pipeline)) {
+        cout << "ERROR: --en-vivo requiere --verbosidad silencio o resumen, sin --pipeline" << endl;
+        return 1;
+    }
+    if (opciones.bitacora[0] != '\0' && (traza || opciones.pipeline || opciones.hilos > 1 ||
+                                         opciones.cantidadPuertos > 1)) {
+        cout << "ERROR: --bitacora requiere --verbosidad silencio o resumen, un solo puerto, "
+             << "sin --pipeline ni --hilos" << endl;
+        return 1;
+    }
+    if (opciones.cascada[0] != '\0' && (opciones.bitacora[0] != '\0' || opciones.cantidadPuertos > 1)) {
+        // Los puntos de control y los flujos de varios puertos guardan solo un rotor simple
+        cout << "ERROR: --cascada requiere un solo puerto, sin --bitacora" << endl;
+        return 1;
+    }
+    if (opciones.salida[0] != '\0' && (opciones.pipeline || opciones.enVivo || opciones.bitacora[0] != '\0' ||
+                                       opciones.cantidadPuertos > 1)) {
+        // El sumidero libera los nodos ya enviados: nadie más puede recorrer el mensaje
+        cout << "ERROR: --salida requiere un solo puerto, sin --pipeline, --en-vivo ni --bitacora" << endl;
+        return 1;
+    }
+    if (opciones.monitor > 0 && opciones.cantidadPuertos > 1) {
+        cout << "ERROR: --monitor requiere un solo puerto" << endl;
+        return 1;
+    }
+    if (opciones.informe[0] != '\0' && opciones.cantidadPuertos > 1) {
+        cout << "ERROR: --informe requiere un solo puerto" << endl;
+        return 1;
+    }
     
-    // Configurar y abrir puerto serial
-    cout << endl << "Conectando al puerto " << puerto << "..." << endl;
-    int fd = configurarSerial(puerto);
+    if (!silencio) {
+        cout << "  DECODIFICADOR PRT-7" << endl;
+    }
     
-    if (fd == -1) {
-        cout << endl << "ERROR: No se pudo abrir el puerto " << puerto << endl;
-        return 1;
+    if (opciones.cantidadPuertos > 1 && opciones.entrada[0] == '\0') {
+        return decodificarPuertos(opciones);
     }
     
-    cout << "Conexion establecida!" << endl;
+    // Crear estructuras de datos
+    ListaDeCarga miListaDeCarga;
+    RotorDeMapeo miRotorDeMapeo;
+    CascadaDeRotores miCascada;
+    if (opciones.cascada[0] != '\0') {
+        miCascada.configurar(opciones.cascada);
+        miCascada.setPasoPorCarga(opciones.pasoPorCarga);
+    }
     
-    // Buffer para leer líneas
-    char linea[100];
+    const char* puerto = opciones.serial.puerto;
+    bool reproduccion = opciones.entrada[0] != '\0';
+    int fd;
     
-    // Bucle principal
-    while (true) {
-        // Leer una línea del puerto serial
-        if (!leerLineaSerial(fd, linea, 100)) {
-            continue;
+    if (reproduccion) {
+        // Reproducir una captura grabada en lugar del puerto
+        if (!silencio) {
+            cout << endl << "Reproduciendo captura " << opciones.entrada << "..." << endl;
         }
+        fd = abrirCaptura(opciones.entrada);
         
-        // Ignorar líneas vacías
-        if (linea[0] == '\0') continue;
+        if (fd == -1) {
+            cout << endl << "ERROR: No se pudo abrir la captura " << opciones.entrada << endl;
+            return 1;
+        }
+    } else {
+        // Pedir puerto si no se indicó en los argumentos
+        if (puerto[0] == '\0') {
+            cout << "Ingrese el puerto serial del Arduino:" << endl;
+            cout << "(Puerto: /dev/ttyUSB0)" << endl;
+            
+            cin.getline(opciones.serial.puerto, sizeof(opciones.serial.puerto));
+        }
         
-        // Verificar señales especiales (I para Inicio, FIN para Final)
-        if (linea[0] == 'I') {
-            cout << "--- Inicio de transmision ---" << endl << endl;
-            continue;
+        // Configurar y abrir puerto serial
+        if (!silencio) {
+            cout << endl << "Conectando al puerto " << puerto << "..." << endl;
         }
-        if (linea[0] == 'F' && linea[1] == 'I' && linea[2] == 'N') {
-            cout << endl << "--- Fin de transmision ---" << endl;
-            break;
+        fd = configurarSerial(opciones.serial);
+        
+        if (fd == -1) {
+            cout << endl << "ERROR: No se pudo abrir el puerto " << puerto << endl;
+            return 1;
         }
         
-        // Mostrar trama recibida
-        cout << "Trama: [" << linea << "] -> ";
+        if (!silencio) {
+            cout << "Conexion establecida!" << endl;
+        }
+    }
+    
+    // Salida de la traza: se vuelca por tamaño, por tiempo o cuando el puerto queda inactivo
+    SalidaBufferizada salida(STDOUT_FILENO);
+    if (traza) {
+        salidaTraza = &salida;
+    }
+    
+    // El mensaje sale al destino a medida que se decodifica y sus nodos se liberan
+    SumideroDeDescriptor sumidero(&miListaDeCarga);
+    SumideroDeCarga* enFlujo = nullptr;
+    if (opciones.salida[0] != '\0') {
+        if (!sumidero.abrir(opciones.salida)) {
+            cout << "ERROR: No se pudo abrir la salida " << opciones.salida << endl;
+            return 1;
+        }
+        enFlujo = &sumidero;
+    }
+    
+    // Lector con buffer sobre el puerto; las capturas en archivo regular se mapean en memoria
+    // (en el pipeline la traza la vuelca el decodificador, no el hilo lector)
+    LectorDeLineas lector(fd);
+    VolcadosAlEsperar volcados = {&salida, enFlujo};
+    if (!opciones.pipeline) {
+        lector.setAntesDeEsperar(volcarAlEsperar, &volcados);
+    }
+    FuenteMapeada mapeada;
+    FuenteDeLineas* fuente = &lector;
+    if (reproduccion && opciones.usarMmap && mapeada.abrir(fd)) {
+        fuente = &mapeada;
+    }
+    const char* linea;
+    int longitud;
+    
+    // La sesión se mide desde que la entrada está abierta
+    InformeDeSesion* informe = nullptr;
+    if (opciones.informe[0] != '\0') {
+        informe = new InformeDeSesion();
+        lector.setMedicion(informe->getLatencias());
+    }
+    
+    // Ranuras reutilizables: el bucle no reserva memoria por trama
+    Decodificador decodificador(&miListaDeCarga, &miRotorDeMapeo);
+    if (opciones.cascada[0] != '\0') {
+        decodificador.setCascada(&miCascada);
+    }
+    
+    // El monitor lee el estado publicado por el decodificador desde otro hilo
+    // (si una salida anticipada lo deja activo, su destructor lo detiene)
+    InstantaneaDeEstado instantanea;
+    HiloMonitor monitor;
+    if (opciones.monitor > 0) {
+        decodificador.setInstantanea(&instantanea);
+        monitor.iniciar(&instantanea, opciones.monitor);
+    }
+    RegistroTrama registro;
+    PipelineDeDecodificacion* pipeline = nullptr;
+    BitacoraDeControl* bitacora = nullptr;
+    
+    if (opciones.pipeline) {
+        // Lectura, decodificación y traza en hilos unidos por colas SPSC
+        pipeline = new PipelineDeDecodificacion(fuente, &decodificador, traza ? &salida : nullptr);
+        pipeline->ejecutar();
         
-        // Parsear y crear trama
-        TramaBase* trama = parsearLinea(linea);
+        if (pipeline->getModoBinario()) {
+            DecodificadorContinuo continuo(&decodificador);
+            continuo.iniciarModoBinario();
+            alimentarContinuo(&continuo, &lector, fuente == &mapeada ? &mapeada : nullptr, nullptr, nullptr);
+        }
+    } else if (fuente == &mapeada && !traza && !opciones.enVivo && opciones.hilos > 1) {
+        // Reproducción en paralelo de la captura mapeada completa (el texto hasta "BIN", si lo hay)
+        const char* pendiente;
+        size_t restante;
+        size_t consumidos;
+        bool binario;
+        mapeada.getPendiente(&pendiente, &restante);
+        decodificador.procesarEnParalelo(pendiente, restante, opciones.hilos, &consumidos, &binario);
+        mapeada.avanzar(consumidos);
         
-        if (trama == nullptr) {
-            cout << "ERROR: Trama mal formada" << endl;
-            continue;
+        if (binario) {
+            // Las tramas binarias no se cortan en tramos: se siguen con la API de flujo continuo
+            DecodificadorContinuo continuo(&decodificador);
+            continuo.iniciarModoBinario();
+            alimentarContinuo(&continuo, &lector, &mapeada, nullptr, enFlujo);
         }
+    } else if (!traza) {
+        // Sin traza: los bytes se decodifican en lote con la API de flujo continuo (texto y binario)
+        DecodificadorContinuo continuo(&decodificador);
+        unsigned long long posicion = 0;
+        unsigned long long saltar = 0;
         
-        // Procesar (polimorfismo)
-        trama->procesar(&miListaDeCarga, &miRotorDeMapeo);
+        if (opciones.bitacora[0] != '\0') {
+            bitacora = new BitacoraDeControl(opciones.intervaloControl);
+            if (!bitacora->abrir(opciones.bitacora)) {
+                cout << "ERROR: No se pudo abrir la bitacora " << opciones.bitacora << endl;
+                delete bitacora;
+                delete informe;
+                return 1;
+            }
+            
+            // Reanudar: mensaje, rotor, conteos y línea incompleta del último punto de control
+            PuntoDeControl punto;
+            if (bitacora->recuperar(&miListaDeCarga, &punto)) {
+                if (!reanudarSesion(punto, &continuo)) {
+                    cout << "ERROR: La bitacora " << opciones.bitacora << " esta danada" << endl;
+                    delete bitacora;
+                    delete informe;
+                    return 1;
+                }
+                posicion = punto.posicionEntrada;
+                
+                // Una captura se retoma donde quedó; un puerto sigue con lo que llegue
+                if (reproduccion && fuente == &mapeada) {
+                    const char* pendiente;
+                    size_t restante;
+                    mapeada.getPendiente(&pendiente, &restante);
+                    if (posicion > restante) {
+                        cout << "ERROR: La captura es mas corta que la sesion de la bitacora" << endl;
+                        delete bitacora;
+                        delete informe;
+                        return 1;
+                    }
+                    mapeada.avanzar((size_t)posicion);
+                } else if (reproduccion && lseek(fd, (off_t)posicion, SEEK_SET) != (off_t)posicion) {
+                    saltar = posicion;
+                }
+                
+                if (!silencio) {
+                    cout << "Reanudando desde la bitacora " << opciones.bitacora << ": trama "
+                         << punto.getSecuencia() << ", " << punto.longitudMensaje
+                         << " caracteres, posicion " << posicion << " de la entrada" << endl;
+                }
+            }
+            bitacora->observar(&decodificador);
+        }
         
-        // Liberar memoria
-        delete trama;
+        // En vivo el encabezado va antes y después de cada trozo se imprimen solo los caracteres nuevos
+        if (opciones.enVivo && !silencio) {
+            cout << "  --- Mensaje Decodificado ---:" << endl;
+        }
+        
+        alimentarContinuo(&continuo, &lector, fuente == &mapeada ? &mapeada : nullptr,
+                          opciones.enVivo ? &miListaDeCarga : nullptr, enFlujo, bitacora, posicion, saltar);
+        
+        if (opciones.enVivo) {
+            miListaDeCarga.imprimirNuevos();
+            cout << endl;
+        }
+    } else {
+        // Bucle principal
+        bool binario = false;
+        while (true) {
+            // Leer una línea del puerto serial (termina si el puerto se cierra)
+            if (!fuente->leerLinea(&linea, &longitud)) {
+                break;
+            }
+            
+            clasificarTrama(linea, longitud, &registro);
+            if (!decodificador.procesar(registro, linea, longitud)) {
+                break;
+            }
+            if (registro.tipo == TRAMA_BINARIO) {
+                binario = true;
+                break;
+            }
+            
+            if (traza) {
+                salida.volcarSiVencido();
+            }
+            if (enFlujo != nullptr) {
+                enFlujo->volcarSiHaceFalta();
+            }
+        }
         
-        cout << endl;
+        if (binario) {
+            // El resto del flujo son tramas binarias: se sigue con la API de flujo continuo
+            salida.volcar();
+            DecodificadorContinuo continuo(&decodificador);
+            continuo.iniciarModoBinario();
+            alimentarContinuo(&continuo, &lector, fuente == &mapeada ? &mapeada : nullptr, nullptr, enFlujo);
+        }
+    }
+    
+    salida.volcar();
+    if (enFlujo != nullptr) {
+        enFlujo->volcar();
     }
+    salidaTraza = nullptr;
+    if (informe != nullptr) {
+        // El último bloque (el que trae "FIN") ya se procesó
+        lector.marcarProcesado();
+        informe->terminar();
+        informe->registrarDecodificador(decodificador);
+        informe->registrarLista(miListaDeCarga);
+        informe->registrarLectura(fuente == &mapeada ? (unsigned long long)mapeada.getEntregados()
+                                                     : lector.getBytesLeidos(),
+                                  lector.getLecturas(), lector.getNanosEnLectura());
+    }
+    monitor.detener();
+    PRT7_VOLCAR_INSTRUMENTACION();
     
-    // Cerrar puerto
-    close(fd);
+    // Cerrar puerto o captura
+    if (fd != STDIN_FILENO) {
+        close(fd);
+    }
     
     // Mostrar resultado final
-    cout << "  --- Mensaje Decodificado ---:" << endl;
-    miListaDeCarga.imprimirMensaje();    
-    cout << endl << "Sistema apagado correctamente." << endl;
+    if (opciones.nivelSalida == SALIDA_RESUMEN) {
+        long tramasCarga = decodificador.getTramasCarga();
+        long tramasMapeo = decodificador.getTramasMapeo();
+        long tramasMalFormadas = decodificador.getTramasMalFormadas();
+        long tramasDescartadas = decodificador.getTramasDescartadas();
+        cout << endl << "Tramas procesadas: "
+             << (tramasCarga + tramasMapeo + tramasMalFormadas + tramasDescartadas)
+             << " (carga: " << tramasCarga << ", mapeo: " << tramasMapeo
+             << ", mal formadas: " << tramasMalFormadas << ", descartadas: " << tramasDescartadas
+             << ", reparadas: " << decodificador.getTramasReparadas() << ")" << endl;
+        
+        if (decodificador.getCascada() != nullptr) {
+            cout << "Cascada: " << miCascada.getCantidad() << " rotores"
+                 << (miCascada.tieneReflector() ? " con reflector" : "") << ", posiciones ";
+            for (int r = 0; r < miCascada.getCantidad(); r++) {
+                cout << (char)('A' + miCascada.getPosicion(r));
+            }
+            cout << ", " << miCascada.getRecalculos() << " tramos recalculados" << endl;
+        }
+        if (pipeline != nullptr) {
+            const ColaSPSC<LineaLeida, PipelineDeDecodificacion::CAPACIDAD_LINEAS>& cola =
+                pipeline->getColaDeLineas();
+            cout << "Cola de lineas: profundidad maxima " << cola.getProfundidadMaxima()
+                 << "/" << cola.getCapacidad() << ", esperas por cola llena: " << cola.getEsperasLlena()
+                 << ", por cola vacia: " << cola.getEsperasVacia() << endl;
+        }
+        if (bitacora != nullptr) {
+            cout << "Bitacora: " << bitacora->getRegistros() << " puntos de control, "
+                 << bitacora->getSincronizaciones() << " fsync" << endl;
+        }
+        if (enFlujo != nullptr) {
+            cout << "Salida: " << enFlujo->getEnviados() << " caracteres en " << enFlujo->getEscrituras()
+                 << " escrituras, " << miListaDeCarga.getDescartados() << " liberados de la memoria" << endl;
+        }
+    }
+    delete pipeline;
+    delete bitacora;
+    if (enFlujo != nullptr) {
+        // El mensaje ya salió al destino a medida que llegaba
+        if (enFlujo->getFallido()) {
+            cout << "ERROR: Se interrumpio la escritura del mensaje en " << opciones.salida << endl;
+        } else if (!silencio) {
+            cout << "  --- Mensaje Decodificado ---: enviado a " << opciones.salida << endl;
+        }
+    } else if (!opciones.enVivo) {
+        // En vivo el mensaje ya se mostró a medida que llegaba
+        if (!silencio) {
+            cout << "  --- Mensaje Decodificado ---:" << endl;
+        }
+        miListaDeCarga.imprimirMensaje();
+    }
+    if (!silencio) {
+        cout << endl << "Sistema apagado correctamente." << endl;
+    }
     
-    return 0;
-}
\ No newline at end of file
+    bool informeFallido = false;
+    if (informe != nullptr) {
+        if (!informe->escribir(opciones.informe)) {
+            cout << "ERROR: No se pudo escribir el informe en " << opciones.informe << endl;
+            informeFallido = true;
+        }
+        delete informe;
+    }
+    
+    return (enFlujo != nullptr && enFlujo->getFallido()) || informeFallido ? 1 : 0;
+}
@@ -0,0 +1,197 @@
+/**
+ * @file pruebas.cpp
+ * @brief Pruebas de la biblioteca prt7 que no se pueden hacer desde la línea de comandos (ctest).
+ *
+ * Cada prueba es una función registrada en PRUEBAS; el programa las ejecuta
+ * todas, informa cada comprobación fallida y termina con 1 si alguna falló.
+ */
+
+#include <cstring>      // Para strcmp()
+#include <iostream>     // Para cout
+
+#include "prt7/prt7.h"
+
+using namespace std;
+
+/**
+ * @brief Comprobaciones fallidas en la ejecución.
+ */
+static int fallidas = 0;
+
+/**
+ * @brief Informa una comprobación que falló.
+ * @param prueba Nombre de la prueba.
+ * @param descripcion Qué se comprobaba.
+ * @param obtenido Valor obtenido.
+ * @param esperado Valor esperado.
+ */
+static void comprobar(const char* prueba, const char* descripcion, size_t obtenido, size_t esperado) {
+    if (obtenido == esperado) return;
+    cout << "ERROR: " << prueba << ": " << descripcion << " es " << obtenido
+         << " (se esperaba " << esperado << ")" << endl;
+    fallidas++;
+}
+
+// FUNCIONES AUXILIARES
+
+/**
+ * @brief Agrega a una lista varias veces el mismo carácter.
+ * @param lista Lista de destino.
+ * @param caracter Carácter a agregar.
+ * @param cantidad Veces que se agrega.
+ */
+static void llenar(ListaDeCarga& lista, char caracter, size_t cantidad) {
+    for (size_t i = 0; i < cantidad; i++) {
+        lista.insertarAlFinal(caracter);
+    }
+}
+
+/**
+ * @brief Lee con la vista incremental todos los caracteres pendientes.
+ * @param lista Lista a leer.
+ * @return Caracteres entregados.
+ */
+static size_t leerTodo(ListaDeCarga& lista) {
+    const char* datos;
+    size_t cantidad;
+    size_t total = 0;
+    while (lista.leerNuevos(&datos, &cantidad)) {
+        total += cantidad;
+    }
+    return total;
+}
+
+/**
+ * @brief Crea una lista de la que ya se liberaron los primeros caracteres, como tras un sumidero.
+ * @param lista Lista vacía a llenar.
+ * @param liberados Caracteres que se agregan, se leen y se liberan (se libera todo menos el último nodo).
+ * @param retenidos Caracteres que se agregan después, sin leer.
+ */
+static void llenarConLiberados(ListaDeCarga& lista, size_t liberados, size_t retenidos) {
+    llenar(lista, 'A', liberados);
+    leerTodo(lista);
+    lista.liberarEntregados();
+    llenar(lista, 'B', retenidos);
+}
+
+// PRUEBAS: LISTA DE CARGA
+
+/**
+ * @brief anteponer una lista que ya liberó caracteres a una lista que ya entregó parte de los suyos.
+ */
+static void pruebaAnteponerLiberada() {
+    const char* prueba = "anteponer/liberada";
+    ListaDeCarga otra;
+    llenarConLiberados(otra, 50000, 7);
+    size_t descartadosOtra = otra.getDescartados();
+    size_t retenidosOtra = otra.getRetenidos();
+    comprobar(prueba, "descartados de la otra lista", descartadosOtra > 0, 1);
+    
+    ListaDeCarga lista;
+    llenar(lista, 'C', 5);
+    leerTodo(lista);
+    llenar(lista, 'D', 3);
+    
+    lista.anteponer(otra);
+    comprobar(prueba, "getLongitud", lista.getLongitud(), 50000 + 7 + 5 + 3);
+    comprobar(prueba, "getDescartados", lista.getDescartados(), descartadosOtra);
+    comprobar(prueba, "getRetenidos", lista.getRetenidos(), retenidosOtra + 5 + 3);
+    comprobar(prueba, "getPendientes", lista.getPendientes(), 3);
+    comprobar(prueba, "caracteres nuevos", leerTodo(lista), 3);
+    
+    size_t copiados;
+    lista.getInstantanea(&copiados);
+    comprobar(prueba, "copia contigua", copiados, retenidosOtra + 5 + 3);
+    
+    lista.reiniciarVista();
+    comprobar(prueba, "getPendientes tras reiniciarVista", lista.getPendientes(), retenidosOtra + 5 + 3);
+    comprobar(prueba, "caracteres tras reiniciarVista", leerTodo(lista), retenidosOtra + 5 + 3);
+}
+
+/**
+ * @brief anteponer una lista que ya liberó caracteres a una lista vacía o sin vista.
+ */
+static void pruebaAnteponerLiberadaSinVista() {
+    const char* prueba = "anteponer/liberada_sin_vista";
+    
+    ListaDeCarga otra;
+    llenarConLiberados(otra, 50000, 4);
+    size_t retenidos = otra.getRetenidos();
+    ListaDeCarga vacia;
+    vacia.anteponer(otra);
+    comprobar(prueba, "getRetenidos (vacia)", vacia.getRetenidos(), retenidos);
+    comprobar(prueba, "getPendientes (vacia)", vacia.getPendientes(), retenidos);
+    comprobar(prueba, "caracteres nuevos (vacia)", leerTodo(vacia), retenidos);
+    
+    ListaDeCarga otraMas;
+    llenarConLiberados(otraMas, 50000, 2);
+    retenidos = otraMas.getRetenidos();
+    size_t descartados = otraMas.getDescartados();
+    ListaDeCarga sinVista;
+    llenar(sinVista, 'E', 5);
+    sinVista.anteponer(otraMas);
+    comprobar(prueba, "getDescartados (sin vista)", sinVista.getDescartados(), descartados);
+    comprobar(prueba, "getPendientes (sin vista)", sinVista.getPendientes(), retenidos + 5);
+    comprobar(prueba, "caracteres nuevos (sin vista)", leerTodo(sinVista), retenidos + 5);
+}
+
+/**
+ * @brief concatenar una lista nueva a una que ya liberó caracteres (como al recuperar una bitácora).
+ */
+static void pruebaConcatenarTrasLiberar() {
+    const char* prueba = "concatenar/tras_liberar";
+    ListaDeCarga lista;
+    llenarConLiberados(lista, 50000, 6);
+    size_t descartados = lista.getDescartados();
+    size_t retenidos = lista.getRetenidos();
+    
+    ListaDeCarga otra;
+    llenar(otra, 'F', 9);
+    lista.concatenar(otra);
+    comprobar(prueba, "getDescartados", lista.getDescartados(), descartados);
+    comprobar(prueba, "getRetenidos", lista.getRetenidos(), retenidos + 9);
+    comprobar(prueba, "getPendientes", lista.getPendientes(), 6 + 9);
+    comprobar(prueba, "caracteres nuevos", leerTodo(lista), 6 + 9);
+}
+
+// FUNCIÓN PRINCIPAL
+
+/**
+ * @struct RegistroPrueba
+ * @brief Nombre y función de una prueba.
+ */
+struct RegistroPrueba {
+    const char* nombre;   ///< Nombre con el que se filtra.
+    void (*funcion)();    ///< Cuerpo de la prueba.
+};
+
+/**
+ * @brief Pruebas del programa, en orden de ejecución.
+ */
+static const RegistroPrueba PRUEBAS[] = {
+    {"anteponer/liberada", pruebaAnteponerLiberada},
+    {"anteponer/liberada_sin_vista", pruebaAnteponerLiberadaSinVista},
+    {"concatenar/tras_liberar", pruebaConcatenarTrasLiberar},
+};
+
+/**
+ * @brief Ejecuta las pruebas (o solo la indicada como argumento).
+ * @param argc Cantidad de argumentos.
+ * @param argv Argumentos: opcionalmente, el nombre de una prueba.
+ * @return 0 si todas las comprobaciones pasaron, 1 si no.
+ */
+int main(int argc, char* argv[]) {
+    int ejecutadas = 0;
+    for (size_t i = 0; i < sizeof(PRUEBAS) / sizeof(PRUEBAS[0]); i++) {
+        if (argc > 1 && strcmp(argv[1], PRUEBAS[i].nombre) != 0) continue;
+        PRUEBAS[i].funcion();
+        ejecutadas++;
+    }
+    
+    if (ejecutadas == 0) {
+        cout << "ERROR: No hay ninguna prueba " << argv[1] << endl;
+        return 1;
+    }
+    cout << ejecutadas << " pruebas, " << fallidas << " comprobaciones fallidas" << endl;
+    return fallidas == 0 ? 0 : 1;
+}
@@ -0,0 +1,134 @@
+/**
+ * @file binario.cpp
+ * @brief Análisis y codificación de tramas binarias.
+ */
+
+#include "prt7/binario.h"
+
+#include <cstring>      // Para memcpy()
+
+using namespace std;
+
+/**
+ * @struct TablaCrc8
+ * @brief Tabla del CRC-8 de cada byte, calculada una sola vez al iniciar el programa.
+ */
+struct TablaCrc8 {
+    unsigned char valores[256]; ///< CRC de cada byte.
+    
+    /**
+     * @brief Constructor. Calcula la tabla bit a bit.
+     */
+    TablaCrc8() {
+        for (int i = 0; i < 256; i++) {
+            unsigned char crc = (unsigned char)i;
+            for (int bit = 0; bit < 8; bit++) {
+                crc = (crc & 0x80) ? (unsigned char)((crc << 1) ^ 0x07) : (unsigned char)(crc << 1);
+            }
+            valores[i] = crc;
+        }
+    }
+};
+
+static const TablaCrc8 tablaCrc8;
+
+unsigned char calcularCrc8(const unsigned char* datos, size_t cantidad, unsigned char inicial) {
+    unsigned char crc = inicial;
+    for (size_t i = 0; i < cantidad; i++) {
+        crc = tablaCrc8.valores[crc ^ datos[i]];
+    }
+    return crc;
+}
+
+/**
+ * @brief Lee un varint sin signo (7 bits por byte, el bit alto indica que sigue otro byte).
+ * @param datos Inicio del varint.
+ * @param cantidad Bytes disponibles.
+ * @param valor Recibe el valor leído.
+ * @return Bytes que ocupa el varint, 0 si está incompleto o -1 si supera MAX_VARINT bytes.
+ */
+static int leerVarint(const unsigned char* datos, size_t cantidad, unsigned int* valor) {
+    unsigned int resultado = 0;
+    for (size_t i = 0; i < MAX_VARINT; i++) {
+        if (i == cantidad) return 0;
+        resultado |= (unsigned int)(datos[i] & 0x7F) << (7 * i);
+        if ((datos[i] & 0x80) == 0) {
+            *valor = resultado;
+            return (int)i + 1;
+        }
+    }
+    return -1;
+}
+
+/**
+ * @brief Escribe un varint sin signo.
+ * @param valor Valor a escribir.
+ * @param destino Buffer de al menos MAX_VARINT bytes.
+ * @return Bytes escritos.
+ */
+static size_t escribirVarint(unsigned int valor, unsigned char* destino) {
+    size_t usados = 0;
+    while (valor >= 0x80) {
+        destino[usados++] = (unsigned char)(valor | 0x80);
+        valor >>= 7;
+    }
+    destino[usados++] = (unsigned char)valor;
+    return usados;
+}
+
+ResultadoBinario analizarTramaBinaria(const char* datos, size_t cantidad, TramaBinaria* trama) {
+    const unsigned char* bytes = reinterpret_cast<const unsigned char*>(datos);
+    
+    if (cantidad == 0) return BINARIO_INCOMPLETA;
+    if (bytes[0] != SINCRONIA_BINARIA) return BINARIO_TEXTO;
+    if (cantidad < 2) return BINARIO_INCOMPLETA;
+    
+    unsigned char tipo = bytes[1];
+    trama->tamano = 1;
+    if (tipo != BINARIO_CARGA && tipo != BINARIO_MAPEO) return BINARIO_INVALIDA;
+    
+    unsigned int valor;
+    int largoVarint = leerVarint(bytes + 2, cantidad - 2, &valor);
+    if (largoVarint < 0) return BINARIO_INVALIDA;
+    if (largoVarint == 0) return BINARIO_INCOMPLETA;
+    
+    size_t contenido = 2 + (size_t)largoVarint;
+    if (tipo == BINARIO_CARGA) {
+        if (valor == 0 || valor > MAX_CARGA_BINARIA) return BINARIO_INVALIDA;
+        contenido += valor;
+    }
+    if (cantidad < contenido + 1) return BINARIO_INCOMPLETA;
+    
+    trama->tamano = contenido + 1;
+    if (calcularCrc8(bytes + 1, contenido - 1) != bytes[contenido]) return BINARIO_INVALIDA;
+    
+    if (tipo == BINARIO_CARGA) {
+        trama->carga = datos + 2 + largoVarint;
+        trama->largo = valor;
+        return BINARIO_TRAMA_CARGA;
+    }
+    // Zigzag: 0, -1, 1, -2, ... se codifican como 0, 1, 2, 3, ...
+    trama->rotacion = (int)(valor >> 1) ^ -(int)(valor & 1);
+    return BINARIO_TRAMA_MAPEO;
+}
+
+size_t codificarCargaBinaria(const char* cifrados, size_t largo, char* destino) {
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(destino);
+    bytes[0] = SINCRONIA_BINARIA;
+    bytes[1] = BINARIO_CARGA;
+    size_t usados = 2 + escribirVarint((unsigned int)largo, bytes + 2);
+    memcpy(bytes + usados, cifrados, largo);
+    usados += largo;
+    bytes[usados] = calcularCrc8(bytes + 1, usados - 1);
+    return usados + 1;
+}
+
+size_t codificarMapeoBinario(int rotacion, char* destino) {
+    unsigned char* bytes = reinterpret_cast<unsigned char*>(destino);
+    bytes[0] = SINCRONIA_BINARIA;
+    bytes[1] = BINARIO_MAPEO;
+    unsigned int zigzag = ((unsigned int)rotacion << 1) ^ (unsigned int)(rotacion >> 31);
+    size_t usados = 2 + escribirVarint(zigzag, bytes + 2);
+    bytes[usados] = calcularCrc8(bytes + 1, usados - 1);
+    return usados + 1;
+}
@@ -0,0 +1,303 @@
+/**
+ * @file bitacora.cpp
+ * @brief Bitácora de puntos de control.
+ */
+
+#include "prt7/bitacora.h"
+
+#include <cstring>      // Para memcpy(), memcmp()
+#include <fcntl.h>      // Para open()
+#include <sys/mman.h>   // Para mmap()
+#include <sys/stat.h>   // Para fstat()
+#include <sys/uio.h>    // Para struct iovec
+#include <unistd.h>     // Para fsync(), ftruncate(), close()
+
+#include "prt7/binario.h"
+#include "prt7/escritura.h"
+#include "prt7/salida.h"
+
+using namespace std;
+
+static const char MARCA[8] = { 'P', 'R', 'T', '7', 'B', 'T', 'C', '1' }; ///< Cabecera del archivo.
+static const char INICIO_REGISTRO = 'P';                                ///< Primer byte de cada registro.
+static const size_t TAM_ENCABEZADO = 1 + 4;                             ///< Marca y largo del cuerpo.
+
+/// Campos fijos del cuerpo: rotor, cinco conteos, posición, banderas y largo de lo pendiente.
+static const size_t TAM_FIJO = 4 + 5 * 8 + 8 + 1 + 2;
+
+/// Banderas del estado del flujo continuo.
+enum BanderaContinuo {
+    BANDERA_BINARIO = 1,
+    BANDERA_DESCARTANDO = 2,
+    BANDERA_RESINCRONIZANDO = 4,
+    BANDERA_TERMINADO = 8
+};
+
+/**
+ * @brief Copia un campo al buffer de un registro.
+ * @param destino Posición de escritura (se avanza).
+ * @param valor Campo a copiar.
+ * @param tamano Bytes del campo.
+ */
+static void agregarCampo(char** destino, const void* valor, size_t tamano) {
+    memcpy(*destino, valor, tamano);
+    *destino += tamano;
+}
+
+/**
+ * @brief Copia un campo desde el cuerpo de un registro.
+ * @param origen Posición de lectura (se avanza).
+ * @param valor Recibe el campo.
+ * @param tamano Bytes del campo.
+ */
+static void leerCampo(const char** origen, void* valor, size_t tamano) {
+    memcpy(valor, *origen, tamano);
+    *origen += tamano;
+}
+
+/**
+ * @brief Decodifica el cuerpo de un registro.
+ * @param cuerpo Inicio del cuerpo.
+ * @param largo Bytes del cuerpo.
+ * @param punto Recibe el punto de control (salvo `longitudMensaje`).
+ * @param caracteres Recibe el inicio de los caracteres decodificados del registro.
+ * @param cantidad Recibe cuántos son.
+ * @return false si el cuerpo no es coherente.
+ */
+static bool leerCuerpo(const char* cuerpo, size_t largo, PuntoDeControl* punto,
+                       const char** caracteres, size_t* cantidad) {
+    if (largo < TAM_FIJO) return false;
+    
+    const char* origen = cuerpo;
+    int desplazamiento;
+    long long conteos[5];
+    unsigned long long posicion;
+    unsigned char banderas;
+    unsigned short pendientes;
+    leerCampo(&origen, &desplazamiento, 4);
+    leerCampo(&origen, conteos, sizeof(conteos));
+    leerCampo(&origen, &posicion, 8);
+    leerCampo(&origen, &banderas, 1);
+    leerCampo(&origen, &pendientes, 2);
+    if (pendientes > MAX_TRAMA_BINARIA || TAM_FIJO + pendientes > largo) return false;
+    
+    punto->desplazamiento = desplazamiento;
+    punto->tramasCarga = (long)conteos[0];
+    punto->tramasMapeo = (long)conteos[1];
+    punto->tramasMalFormadas = (long)conteos[2];
+    punto->tramasDescartadas = (long)conteos[3];
+    punto->tramasReparadas = (long)conteos[4];
+    punto->posicionEntrada = posicion;
+    punto->continuo.binario = (banderas & BANDERA_BINARIO) != 0;
+    punto->continuo.descartando = (banderas & BANDERA_DESCARTANDO) != 0;
+    punto->continuo.resincronizando = (banderas & BANDERA_RESINCRONIZANDO) != 0;
+    punto->continuo.terminado = (banderas & BANDERA_TERMINADO) != 0;
+    punto->continuo.largo = pendientes;
+    leerCampo(&origen, punto->continuo.pendiente, pendientes);
+    
+    *caracteres = origen;
+    *cantidad = largo - TAM_FIJO - pendientes;
+    return true;
+}
+
+BitacoraDeControl::BitacoraDeControl(int intervalo, int porFsync)
+    : fd(-1), nuevos(nullptr), largoNuevos(0), capacidadNuevos(0), longitudMensaje(0),
+      intervaloMs(intervalo), registrosPorFsync(porFsync > 0 ? porFsync : 1), sinSincronizar(0),
+      ultimoRegistro(SalidaBufferizada::milisegundos()), ultimaPosicion(~0ULL), registros(0),
+      sincronizaciones(0) {}
+
+BitacoraDeControl::~BitacoraDeControl() {
+    if (fd != -1) {
+        sincronizar();
+        close(fd);
+    }
+    delete[] nuevos;
+}
+
+void BitacoraDeControl::alDecodificar(void* contexto, const char* datos, size_t cantidad) {
+    BitacoraDeControl* bitacora = static_cast<BitacoraDeControl*>(contexto);
+    
+    if (bitacora->largoNuevos + cantidad > bitacora->capacidadNuevos) {
+        size_t capacidad = bitacora->capacidadNuevos > 0 ? bitacora->capacidadNuevos * 2 : 4096;
+        while (capacidad < bitacora->largoNuevos + cantidad) capacidad *= 2;
+        char* ampliado = new char[capacidad];
+        if (bitacora->largoNuevos > 0) memcpy(ampliado, bitacora->nuevos, bitacora->largoNuevos);
+        delete[] bitacora->nuevos;
+        bitacora->nuevos = ampliado;
+        bitacora->capacidadNuevos = capacidad;
+    }
+    memcpy(bitacora->nuevos + bitacora->largoNuevos, datos, cantidad);
+    bitacora->largoNuevos += cantidad;
+}
+
+bool BitacoraDeControl::abrir(const char* ruta) {
+    fd = open(ruta, O_RDWR | O_CREAT | O_APPEND, 0644);
+    if (fd == -1) return false;
+    
+    struct stat informacion;
+    char cabecera[sizeof(MARCA)];
+    bool valida = fstat(fd, &informacion) == 0;
+    if (valida && informacion.st_size == 0) {
+        valida = escribirTodo(fd, MARCA, sizeof(MARCA));
+    } else if (valida) {
+        valida = pread(fd, cabecera, sizeof(cabecera), 0) == (ssize_t)sizeof(cabecera) &&
+                 memcmp(cabecera, MARCA, sizeof(MARCA)) == 0;
+    }
+    
+    if (!valida) {
+        close(fd);
+        fd = -1;
+    }
+    return valida;
+}
+
+bool BitacoraDeControl::recuperar(ListaDeCarga* carga, PuntoDeControl* punto) {
+    struct stat informacion;
+    if (fd == -1 || fstat(fd, &informacion) != 0 || (size_t)informacion.st_size <= sizeof(MARCA)) {
+        return false;
+    }
+    size_t tamano = (size_t)informacion.st_size;
+    void* mapeo = mmap(nullptr, tamano, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (mapeo == MAP_FAILED) return false;
+    const char* datos = static_cast<const char*>(mapeo);
+    
+    // Los caracteres se juntan aparte y se agregan a la carga en O(1) solo si la sesión sigue abierta
+    ListaDeCarga recuperada;
+    size_t posicion = sizeof(MARCA);
+    size_t longitud = 0;
+    bool hayPunto = false;
+    
+    while (tamano - posicion >= TAM_ENCABEZADO + 1 && datos[posicion] == INICIO_REGISTRO) {
+        unsigned int largo;
+        memcpy(&largo, datos + posicion + 1, 4);
+        if (largo > tamano - posicion - TAM_ENCABEZADO - 1) break;
+        
+        const char* cuerpo = datos + posicion + TAM_ENCABEZADO;
+        unsigned char crc = calcularCrc8(reinterpret_cast<const unsigned char*>(cuerpo), largo);
+        if (crc != (unsigned char)cuerpo[largo]) break;
+        
+        PuntoDeControl leido;
+        const char* caracteres;
+        size_t cantidad;
+        if (!leerCuerpo(cuerpo, largo, &leido, &caracteres, &cantidad)) break;
+        
+        recuperada.insertarBloque(caracteres, cantidad);
+        longitud += cantidad;
+        leido.longitudMensaje = longitud;
+        *punto = leido;
+        hayPunto = true;
+        posicion += TAM_ENCABEZADO + largo + 1;
+    }
+    munmap(mapeo, tamano);
+    
+    if (hayPunto && punto->continuo.terminado) {
+        // La sesión anterior terminó con "FIN": se empieza una nueva
+        hayPunto = false;
+        posicion = sizeof(MARCA);
+        longitud = 0;
+    }
+    if (posicion < tamano && ftruncate(fd, (off_t)posicion) != 0) {
+        return false;
+    }
+    
+    longitudMensaje = longitud;
+    if (hayPunto) {
+        carga->concatenar(recuperada);
+        ultimaPosicion = punto->posicionEntrada;
+    }
+    return hayPunto;
+}
+
+void BitacoraDeControl::observar(Decodificador* decodificador) {
+    decodificador->setAlDecodificar(alDecodificar, this);
+}
+
+bool BitacoraDeControl::registrar(const DecodificadorContinuo& continuo, unsigned long long posicionEntrada) {
+    if (fd == -1) return false;
+    
+    const Decodificador* decodificador = continuo.getDecodificador();
+    EstadoContinuo estado;
+    continuo.guardarEstado(&estado);
+    
+    int desplazamiento = decodificador->getRotor()->getDesplazamiento();
+    long long conteos[5] = { decodificador->getTramasCarga(), decodificador->getTramasMapeo(),
+                             decodificador->getTramasMalFormadas(), decodificador->getTramasDescartadas(),
+                             decodificador->getTramasReparadas() };
+    unsigned char banderas = (unsigned char)((estado.binario ? BANDERA_BINARIO : 0) |
+                                             (estado.descartando ? BANDERA_DESCARTANDO : 0) |
+                                             (estado.resincronizando ? BANDERA_RESINCRONIZANDO : 0) |
+                                             (estado.terminado ? BANDERA_TERMINADO : 0));
+    unsigned short pendientes = (unsigned short)estado.largo;
+    unsigned int largo = (unsigned int)(TAM_FIJO + estado.largo + largoNuevos);
+    
+    // Encabezado y campos fijos en un buffer; los caracteres nuevos se escriben desde donde están
+    char encabezado[TAM_ENCABEZADO + TAM_FIJO + MAX_TRAMA_BINARIA];
+    char* destino = encabezado;
+    agregarCampo(&destino, &INICIO_REGISTRO, 1);
+    agregarCampo(&destino, &largo, 4);
+    agregarCampo(&destino, &desplazamiento, 4);
+    agregarCampo(&destino, conteos, sizeof(conteos));
+    agregarCampo(&destino, &posicionEntrada, 8);
+    agregarCampo(&destino, &banderas, 1);
+    agregarCampo(&destino, &pendientes, 2);
+    agregarCampo(&destino, estado.pendiente, estado.largo);
+    
+    size_t largoEncabezado = (size_t)(destino - encabezado);
+    unsigned char crc = calcularCrc8(reinterpret_cast<const unsigned char*>(encabezado) + TAM_ENCABEZADO,
+                                     largoEncabezado - TAM_ENCABEZADO);
+    crc = calcularCrc8(reinterpret_cast<const unsigned char*>(nuevos), largoNuevos, crc);
+    
+    struct iovec segmentos[3];
+    segmentos[0].iov_base = encabezado;
+    segmentos[0].iov_len = largoEncabezado;
+    segmentos[1].iov_base = nuevos;
+    segmentos[1].iov_len = largoNuevos;
+    segmentos[2].iov_base = &crc;
+    segmentos[2].iov_len = 1;
+    if (!escribirSegmentos(fd, segmentos, 3)) {
+        return false;
+    }
+    
+    longitudMensaje += largoNuevos;
+    largoNuevos = 0;
+    ultimaPosicion = posicionEntrada;
+    ultimoRegistro = SalidaBufferizada::milisegundos();
+    registros++;
+    if (++sinSincronizar >= registrosPorFsync) {
+        sincronizar();
+    }
+    return true;
+}
+
+bool BitacoraDeControl::registrarSiVencido(const DecodificadorContinuo& continuo,
+                                            unsigned long long posicionEntrada) {
+    // Sin bytes nuevos (e.g., un puerto inactivo) no hay nada que registrar
+    if (posicionEntrada == ultimaPosicion && largoNuevos == 0) {
+        return true;
+    }
+    if (SalidaBufferizada::milisegundos() - ultimoRegistro < intervaloMs) {
+        return true;
+    }
+    return registrar(continuo, posicionEntrada);
+}
+
+void BitacoraDeControl::sincronizar() {
+    if (fd != -1 && sinSincronizar > 0) {
+        fsync(fd);
+        sincronizaciones++;
+        sinSincronizar = 0;
+    }
+}
+
+bool reanudarSesion(const PuntoDeControl& punto, DecodificadorContinuo* continuo) {
+    Decodificador* decodificador = continuo->getDecodificador();
+    RotorDeMapeo* rotor = decodificador->getRotor();
+    
+    if (!continuo->restaurarEstado(punto.continuo)) {
+        return false;
+    }
+    rotor->rotar(punto.desplazamiento - rotor->getDesplazamiento());
+    decodificador->setConteos(punto.tramasCarga, punto.tramasMapeo, punto.tramasMalFormadas,
+                              punto.tramasDescartadas, punto.tramasReparadas);
+    return true;
+}
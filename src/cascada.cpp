@@ -0,0 +1,194 @@
+/**
+ * @file cascada.cpp
+ * @brief Configuración de la cascada de rotores y recálculo de sus tramos.
+ */
+
+#include "prt7/cascada.h"
+
+#include <cstring>      // Para strlen(), strcmp(), strchr()
+
+using namespace std;
+
+/**
+ * @struct RotorDeCatalogo
+ * @brief Cableado y muesca de un rotor o reflector con nombre.
+ */
+struct RotorDeCatalogo {
+    const char* nombre;   ///< Nombre en la especificación (e.g., "III").
+    const char* cableado; ///< Salida de cada contacto en la posición 'A'.
+    char muesca;          ///< Letra en la que arrastra al siguiente rotor ('\0' para los reflectores).
+};
+
+/// Rotores I a V de la Enigma I.
+static const RotorDeCatalogo ROTORES[] = {
+    {"I",   "EKMFLGDQVZNTOWYHXUSPAIBRCJ", 'Q'},
+    {"II",  "AJDKSIRUXBLHWTMCQGZNPYFVOE", 'E'},
+    {"III", "BDFHJLCPRTXVZNYEIWGAKMUSQO", 'V'},
+    {"IV",  "ESOVPZJAYQUIRHXLNFTGKDCMWB", 'J'},
+    {"V",   "VZBRGITYUPSDNHLXAWMJQOFECK", 'Z'},
+};
+
+/// Reflectores B y C de la Enigma I.
+static const RotorDeCatalogo REFLECTORES[] = {
+    {"B", "YRUHQSLDPXNGOKMIEBFZCWVJAT", '\0'},
+    {"C", "FVPJIAOYEDRZXWGCTKUQSBNMHL", '\0'},
+};
+
+/**
+ * @brief Busca un nombre en un catálogo.
+ * @param catalogo Rotores o reflectores.
+ * @param cantidad Entradas del catálogo.
+ * @param nombre Nombre buscado.
+ * @param largo Caracteres de `nombre`.
+ * @return La entrada, o nullptr si no está.
+ */
+static const RotorDeCatalogo* buscarEnCatalogo(const RotorDeCatalogo* catalogo, size_t cantidad,
+                                               const char* nombre, size_t largo) {
+    for (size_t i = 0; i < cantidad; i++) {
+        if (strlen(catalogo[i].nombre) == largo && strncmp(catalogo[i].nombre, nombre, largo) == 0) {
+            return &catalogo[i];
+        }
+    }
+    return nullptr;
+}
+
+/**
+ * @brief Convierte un cableado de texto a posiciones y verifica que sea una permutación de A-Z.
+ * @param cableado Texto de al menos 26 caracteres.
+ * @param destino Recibe la salida de cada contacto (0 a 25).
+ * @return false si hay caracteres fuera de A-Z o letras repetidas.
+ */
+static bool leerPermutacion(const char* cableado, unsigned char* destino) {
+    bool usada[CascadaDeRotores::LONGITUD] = {};
+    for (int i = 0; i < CascadaDeRotores::LONGITUD; i++) {
+        if (cableado[i] < 'A' || cableado[i] > 'Z' || usada[cableado[i] - 'A']) {
+            return false;
+        }
+        usada[cableado[i] - 'A'] = true;
+        destino[i] = (unsigned char)(cableado[i] - 'A');
+    }
+    return true;
+}
+
+CascadaDeRotores::CascadaDeRotores()
+    : cantidad(0), enMuesca(0), conReflector(false), pasoPorCarga(false),
+      vencido(0), recalculos(0) {
+    for (int i = 0; i < LONGITUD; i++) {
+        reflector[i] = (unsigned char)i;
+        tramos[0][i] = (unsigned char)i;
+    }
+}
+
+bool CascadaDeRotores::agregarRotor(const char* cableado, int muesca) {
+    unsigned char directo[LONGITUD];
+    if (cantidad == MAX_ROTORES || strlen(cableado) != (size_t)LONGITUD ||
+        !leerPermutacion(cableado, directo)) {
+        return false;
+    }
+    if (muesca != SIN_MUESCA && (muesca < 0 || muesca >= LONGITUD)) {
+        return false;
+    }
+    
+    // Entrada y salida del rotor para cada una de sus 26 posiciones
+    int r = cantidad;
+    for (int p = 0; p < LONGITUD; p++) {
+        for (int x = 0; x < LONGITUD; x++) {
+            int salida = (directo[(x + p) % LONGITUD] - p + LONGITUD) % LONGITUD;
+            adelante[r][p][x] = (unsigned char)salida;
+            atras[r][p][salida] = (unsigned char)x;
+        }
+    }
+    posiciones[r] = 0;
+    muescas[r] = muesca;
+    cantidad++;
+    
+    // El anterior último rotor ahora puede arrastrar al nuevo
+    for (int i = 0; i < cantidad; i++) {
+        actualizarMuesca(i);
+    }
+    memcpy(tramos[cantidad], reflector, sizeof(reflector));
+    vencido = cantidad - 1;
+    return true;
+}
+
+bool CascadaDeRotores::setReflector(const char* cableado) {
+    unsigned char pares[LONGITUD];
+    if (strlen(cableado) != (size_t)LONGITUD || !leerPermutacion(cableado, pares)) {
+        return false;
+    }
+    for (int i = 0; i < LONGITUD; i++) {
+        if (pares[i] == i || pares[pares[i]] != i) return false;
+    }
+    
+    memcpy(reflector, pares, sizeof(reflector));
+    memcpy(tramos[cantidad], reflector, sizeof(reflector));
+    conReflector = true;
+    vencido = cantidad - 1;
+    return true;
+}
+
+bool CascadaDeRotores::configurar(const char* especificacion) {
+    *this = CascadaDeRotores();
+    
+    const char* barra = strchr(especificacion, '/');
+    size_t largoRotores = barra != nullptr ? (size_t)(barra - especificacion) : strlen(especificacion);
+    
+    const char* actual = especificacion;
+    const char* finRotores = especificacion + largoRotores;
+    while (actual < finRotores) {
+        const char* coma = actual;
+        while (coma < finRotores && *coma != ',') coma++;
+        size_t largo = (size_t)(coma - actual);
+        
+        char cableado[LONGITUD + 1];
+        int muesca = SIN_MUESCA;
+        const RotorDeCatalogo* nombrado = buscarEnCatalogo(ROTORES, sizeof(ROTORES) / sizeof(ROTORES[0]),
+                                                           actual, largo);
+        if (nombrado != nullptr) {
+            strcpy(cableado, nombrado->cableado);
+            muesca = nombrado->muesca - 'A';
+        } else if (largo == (size_t)LONGITUD || (largo == (size_t)LONGITUD + 2 && actual[LONGITUD] == '@' &&
+                                                 actual[LONGITUD + 1] >= 'A' && actual[LONGITUD + 1] <= 'Z')) {
+            memcpy(cableado, actual, LONGITUD);
+            cableado[LONGITUD] = '\0';
+            if (largo > (size_t)LONGITUD) muesca = actual[LONGITUD + 1] - 'A';
+        } else {
+            *this = CascadaDeRotores();
+            return false;
+        }
+        
+        if (!agregarRotor(cableado, muesca)) {
+            *this = CascadaDeRotores();
+            return false;
+        }
+        actual = coma + 1;
+    }
+    
+    if (cantidad == 0) return false;
+    if (barra == nullptr) return true;
+    
+    const char* nombre = barra + 1;
+    const RotorDeCatalogo* reflejo = buscarEnCatalogo(REFLECTORES, sizeof(REFLECTORES) / sizeof(REFLECTORES[0]),
+                                                      nombre, strlen(nombre));
+    if (!setReflector(reflejo != nullptr ? reflejo->cableado : nombre)) {
+        *this = CascadaDeRotores();
+        return false;
+    }
+    return true;
+}
+
+void CascadaDeRotores::recalcularTramos() {
+    // Cada tramo se arma con el siguiente, que ya está al día
+    for (int r = vencido; r >= 1; r--) {
+        const unsigned char* entrada = adelante[r][posiciones[r]];
+        const unsigned char* salida = atras[r][posiciones[r]];
+        const unsigned char* siguiente = tramos[r + 1];
+        for (int x = 0; x < LONGITUD; x++) {
+            // Sin reflector la señal no atraviesa el rotor hacia adentro
+            int y = conReflector ? entrada[x] : x;
+            tramos[r][x] = salida[siguiente[y]];
+        }
+        recalculos++;
+    }
+    vencido = 0;
+}
@@ -0,0 +1,257 @@
+/**
+ * @file decodificador_continuo.cpp
+ * @brief API de flujo continuo sobre Decodificador.
+ */
+
+#include "prt7/decodificador_continuo.h"
+
+#include <cstring>      // Para memcpy(), memmove()
+
+#include "prt7/instrumentacion.h"
+#include "prt7/parser.h"
+
+using namespace std;
+
+void DecodificadorContinuo::procesarRegistros(const RegistroTrama* registros, size_t cantidad) {
+    if (!decodificador->procesarLote(registros, cantidad)) {
+        terminado = true;
+        if (alTerminar != nullptr) {
+            alTerminar(contextoTerminar);
+        }
+    } else if (cantidad > 0 && registros[cantidad - 1].tipo == TRAMA_BINARIO) {
+        // tokenizarBloque se detiene justo después de "BIN"
+        binario = true;
+    }
+}
+
+void DecodificadorContinuo::procesarLinea(const char* linea, size_t longitud) {
+    RegistroTrama registro;
+    clasificarTrama(linea, (int)longitud, &registro);
+    procesarRegistros(&registro, 1);
+}
+
+bool DecodificadorContinuo::saltarLineaDescartada(const char* datos, size_t cantidad, size_t* posicion) {
+    while (*posicion < cantidad) {
+        char c = datos[(*posicion)++];
+        if (c == '\n' || c == '\r') {
+            descartando = false;
+            return true;
+        }
+    }
+    return false;
+}
+
+size_t DecodificadorContinuo::alimentarTexto(const char* datos, size_t cantidad) {
+    const size_t MAX_LINEA = FuenteDeLineas::MAX_LINEA;
+    size_t posicion = 0;
+    
+    if (descartando && !saltarLineaDescartada(datos, cantidad, &posicion)) {
+        return cantidad;
+    }
+    
+    // Completar la línea que quedó a medias en el trozo anterior
+    if (largoPendiente > 0) {
+        bool completa = false;
+        while (posicion < cantidad && largoPendiente <= MAX_LINEA) {
+            char c = datos[posicion++];
+            if (c == '\n' || c == '\r') {
+                completa = true;
+                break;
+            }
+            pendiente[largoPendiente++] = c;
+        }
+        
+        if (completa) {
+            procesarLinea(pendiente, largoPendiente);
+            largoPendiente = 0;
+        } else if (largoPendiente > MAX_LINEA) {
+            // Línea demasiado larga: se descarta entera, como en LectorDeLineas
+            procesarLinea(pendiente, largoPendiente);
+            largoPendiente = 0;
+            descartando = true;
+            if (!saltarLineaDescartada(datos, cantidad, &posicion)) {
+                return cantidad;
+            }
+        }
+    }
+    
+    // Líneas completas: tokenizar en lote sobre los bytes recibidos
+    RegistroTrama lote[TAM_LOTE];
+    while (posicion < cantidad && !terminado && !binario) {
+        size_t consumidos;
+        size_t registros = tokenizarBloque(datos + posicion, cantidad - posicion, false,
+                                           lote, TAM_LOTE, &consumidos);
+        procesarRegistros(lote, registros);
+        if (consumidos == 0) break;
+        posicion += consumidos;
+    }
+    if (terminado || binario) {
+        return posicion;
+    }
+    
+    // Resto sin terminador: guardarlo, o descartarlo si ya es demasiado largo
+    size_t resto = cantidad - posicion;
+    if (resto > MAX_LINEA) {
+        procesarLinea(datos + posicion, MAX_LINEA + 1);
+        descartando = true;
+    } else if (!terminado && resto > 0) {
+        memcpy(pendiente + largoPendiente, datos + posicion, resto);
+        largoPendiente += resto;
+    }
+    return cantidad;
+}
+
+size_t DecodificadorContinuo::procesarTramasBinarias(const char* datos, size_t cantidad) {
+    size_t posicion = 0;
+    
+    while (posicion < cantidad) {
+        if (resincronizando) {
+            // Saltar hasta la próxima sincronía o el próximo '\n' (vuelta a texto), mirando cada byte una vez
+            while (posicion < cantidad && (unsigned char)datos[posicion] != SINCRONIA_BINARIA &&
+                   datos[posicion] != '\n') {
+                posicion++;
+            }
+            if (posicion == cantidad) break;
+            if (datos[posicion] == '\n') {
+                resincronizando = false;
+                binario = false;
+                break;
+            }
+        }
+        
+        // Terminadores sueltos donde va una sincronía (e.g., el '\n' de "BIN\r\n" que llegó en
+        // otro trozo): no son texto todavía, se saltan
+        if (datos[posicion] == '\n' || datos[posicion] == '\r') {
+            posicion++;
+            continue;
+        }
+        
+        TramaBinaria trama;
+        ResultadoBinario resultado = analizarTramaBinaria(datos + posicion, cantidad - posicion, &trama);
+        
+        if (resultado == BINARIO_INCOMPLETA) break;
+        if (resultado == BINARIO_TEXTO) {
+            binario = false;
+            break;
+        }
+        
+        if (resultado == BINARIO_INVALIDA) {
+            // Una sola trama descartada por cada pérdida de sincronía
+            if (!resincronizando) {
+                decodificador->contarDescartada();
+                PRT7_CONTAR_TRAMA(TRAMA_DESCARTADA);
+                resincronizando = true;
+            }
+            posicion++;
+            continue;
+        }
+        
+        resincronizando = false;
+        if (resultado == BINARIO_TRAMA_CARGA) {
+            decodificador->procesarCorrida(trama.carga, trama.largo);
+        } else {
+            decodificador->procesarRotacion(trama.rotacion);
+        }
+        PRT7_CONTAR_TRAMA(resultado == BINARIO_TRAMA_CARGA ? TRAMA_LOAD : TRAMA_MAP);
+        posicion += trama.tamano;
+    }
+    return posicion;
+}
+
+size_t DecodificadorContinuo::alimentarBinario(const char* datos, size_t cantidad) {
+    if (largoBinario == 0) {
+        // Caso común: las tramas se analizan directamente sobre los bytes recibidos
+        size_t consumidos = procesarTramasBinarias(datos, cantidad);
+        if (!binario) {
+            return consumidos;
+        }
+        memcpy(pendienteBinario, datos + consumidos, cantidad - consumidos);
+        largoBinario = cantidad - consumidos;
+        return cantidad;
+    }
+    
+    // Completar la trama cortada: como MAX_TRAMA_BINARIA cabe una trama entera, siempre se avanza
+    size_t agregados = MAX_TRAMA_BINARIA - largoBinario;
+    if (agregados > cantidad) agregados = cantidad;
+    memcpy(pendienteBinario + largoBinario, datos, agregados);
+    largoBinario += agregados;
+    
+    size_t consumidos = procesarTramasBinarias(pendienteBinario, largoBinario);
+    size_t sobrantes = largoBinario - consumidos;
+    largoBinario = 0;
+    
+    if (!binario) {
+        // Los bytes sobrantes ya son texto, anterior al resto de `datos`
+        char texto[MAX_TRAMA_BINARIA];
+        memcpy(texto, pendienteBinario + consumidos, sobrantes);
+        alimentar(texto, sobrantes);
+    } else {
+        memmove(pendienteBinario, pendienteBinario + consumidos, sobrantes);
+        largoBinario = sobrantes;
+    }
+    return agregados;
+}
+
+bool DecodificadorContinuo::alimentar(const char* datos, size_t cantidad) {
+    size_t posicion = 0;
+    
+    while (posicion < cantidad && !terminado) {
+        if (binario) {
+            posicion += alimentarBinario(datos + posicion, cantidad - posicion);
+        } else {
+            posicion += alimentarTexto(datos + posicion, cantidad - posicion);
+        }
+    }
+    return !terminado;
+}
+
+bool DecodificadorContinuo::finalizar() {
+    if (largoPendiente > 0 && !terminado) {
+        procesarLinea(pendiente, largoPendiente);
+    }
+    if (largoBinario > 0 && !terminado && !resincronizando) {
+        decodificador->contarDescartada();
+        PRT7_CONTAR_TRAMA(TRAMA_DESCARTADA);
+    }
+    largoPendiente = 0;
+    largoBinario = 0;
+    descartando = false;
+    resincronizando = false;
+    return !terminado;
+}
+
+void DecodificadorContinuo::guardarEstado(EstadoContinuo* estado) const {
+    if (binario) {
+        memcpy(estado->pendiente, pendienteBinario, largoBinario);
+        estado->largo = largoBinario;
+    } else {
+        memcpy(estado->pendiente, pendiente, largoPendiente);
+        estado->largo = largoPendiente;
+    }
+    estado->binario = binario;
+    estado->descartando = descartando;
+    estado->resincronizando = resincronizando;
+    estado->terminado = terminado;
+}
+
+bool DecodificadorContinuo::restaurarEstado(const EstadoContinuo& estado) {
+    size_t maximo = estado.binario ? MAX_TRAMA_BINARIA : FuenteDeLineas::MAX_LINEA;
+    if (estado.largo > maximo) {
+        return false;
+    }
+    
+    binario = estado.binario;
+    descartando = estado.descartando;
+    resincronizando = estado.resincronizando;
+    terminado = estado.terminado;
+    largoPendiente = 0;
+    largoBinario = 0;
+    if (binario) {
+        memcpy(pendienteBinario, estado.pendiente, estado.largo);
+        largoBinario = estado.largo;
+    } else {
+        memcpy(pendiente, estado.pendiente, estado.largo);
+        largoPendiente = estado.largo;
+    }
+    return true;
+}
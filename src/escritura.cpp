@@ -0,0 +1,73 @@
+/**
+ * @file escritura.cpp
+ * @brief Escritura completa (con reintentos) a un descriptor.
+ */
+
+#include "prt7/escritura.h"
+
+#include <cerrno>       // Para errno
+#include <cstring>      // Para memset()
+#include <sys/socket.h> // Para sendmsg(), MSG_NOSIGNAL
+#include <unistd.h>     // Para write()
+
+using namespace std;
+
+bool escribirTodo(int fd, const char* datos, size_t cantidad) {
+    while (cantidad > 0) {
+        ssize_t n = write(fd, datos, cantidad);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        datos += n;
+        cantidad -= (size_t)n;
+    }
+    return true;
+}
+
+/**
+ * @brief Descarta de los segmentos los bytes ya escritos: salta los completos y ajusta el primero parcial.
+ * @param segmentos Segmentos pendientes (se adelanta al primero no escrito).
+ * @param cantidad Cantidad de segmentos pendientes (se actualiza).
+ * @param escritos Bytes escritos por la última llamada.
+ */
+static void avanzarSegmentos(struct iovec** segmentos, int* cantidad, size_t escritos) {
+    while (*cantidad > 0 && escritos >= (*segmentos)->iov_len) {
+        escritos -= (*segmentos)->iov_len;
+        (*segmentos)++;
+        (*cantidad)--;
+    }
+    if (*cantidad > 0) {
+        (*segmentos)->iov_base = (char*)(*segmentos)->iov_base + escritos;
+        (*segmentos)->iov_len -= escritos;
+    }
+}
+
+bool escribirSegmentos(int fd, struct iovec* segmentos, int cantidad) {
+    while (cantidad > 0) {
+        ssize_t n = writev(fd, segmentos, cantidad);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        avanzarSegmentos(&segmentos, &cantidad, (size_t)n);
+    }
+    return true;
+}
+
+bool enviarSegmentos(int fd, struct iovec* segmentos, int cantidad) {
+    while (cantidad > 0) {
+        struct msghdr mensaje;
+        memset(&mensaje, 0, sizeof(mensaje));
+        mensaje.msg_iov = segmentos;
+        mensaje.msg_iovlen = (size_t)cantidad;
+        
+        ssize_t n = sendmsg(fd, &mensaje, MSG_NOSIGNAL);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            return false;
+        }
+        avanzarSegmentos(&segmentos, &cantidad, (size_t)n);
+    }
+    return true;
+}
@@ -0,0 +1,193 @@
+/**
+ * @file generador.cpp
+ * @brief Sorteo y escritura de las tramas sintéticas del GeneradorDeTramas.
+ */
+
+#include "prt7/generador.h"
+
+#include <cstdio>       // Para snprintf()
+#include <cstring>      // Para memcpy(), memset()
+
+using namespace std;
+
+/**
+ * @brief Líneas mal formadas que se generan (ninguna empieza con 'I', "FIN" ni "BIN").
+ */
+static const char* const MAL_FORMADAS[] = {
+    "X,1", "L", "M,", "M,-", "L;A", "MAP", "M,x12", "L,AB", "M,99999999999", "M,-2147483649", "M,1.5", "L,"
+};
+static const size_t CANTIDAD_MAL_FORMADAS = sizeof(MAL_FORMADAS) / sizeof(MAL_FORMADAS[0]);
+
+/**
+ * @brief Bytes de ruido que el parser recorta de los extremos de una línea.
+ */
+static const char RUIDO[] = { '\0', ' ', '\t', (char)0x7F, (char)0xFF };
+
+/**
+ * @brief Largo de la línea demasiado larga que se genera (supera FuenteDeLineas::MAX_LINEA).
+ */
+static const size_t LARGO_EXCESIVO = 113;
+
+GeneradorDeTramas::GeneradorDeTramas(const PerfilDeCarga& p)
+    : perfil(p), estado(p.semilla != 0 ? p.semilla : 1), desplazamiento(0), iniciado(false),
+      corridaPendiente(0), generadas(0), tramasCarga(0), tramasMapeo(0), tramasMalFormadas(0),
+      tramasDescartadas(0), tramasReparadas(0), alGenerar(nullptr), contextoGenerado(nullptr),
+      largoEsperados(0) {
+    if (perfil.corridaMaxima < 1) perfil.corridaMaxima = 1;
+    if (perfil.rotacionMaxima < 0) perfil.rotacionMaxima = 0;
+    
+    // Unos pocos sorteos iniciales separan las semillas pequeñas y parecidas
+    for (int i = 0; i < 8; i++) {
+        sortear();
+    }
+}
+
+int GeneradorDeTramas::sortearRotacion(unsigned long long valor) {
+    unsigned long long amplitud = 2ULL * (unsigned long long)perfil.rotacionMaxima + 1;
+    long long rotacion = (long long)((valor >> 20) % amplitud) - perfil.rotacionMaxima;
+    
+    desplazamiento = (desplazamiento + (int)(rotacion % LONGITUD) + LONGITUD) % LONGITUD;
+    tramasMapeo++;
+    return (int)rotacion;
+}
+
+size_t GeneradorDeTramas::escribirError(char* destino, unsigned long long valor) {
+    unsigned long long variante = (valor >> 12) % (CANTIDAD_MAL_FORMADAS + 2);
+    
+    if (variante == CANTIDAD_MAL_FORMADAS) {
+        // Checksum incorrecto: el de "L,A" es 0x21
+        memcpy(destino, "L,A*00\n", 7);
+        tramasDescartadas++;
+        return 7;
+    }
+    if (variante == CANTIDAD_MAL_FORMADAS + 1) {
+        // Línea demasiado larga: las fuentes entregan solo su comienzo
+        memcpy(destino, "L,A", 3);
+        memset(destino + 3, 'Z', LARGO_EXCESIVO - 3);
+        destino[LARGO_EXCESIVO] = '\n';
+        tramasDescartadas++;
+        return LARGO_EXCESIVO + 1;
+    }
+    
+    size_t largo = strlen(MAL_FORMADAS[variante]);
+    memcpy(destino, MAL_FORMADAS[variante], largo);
+    destino[largo] = '\n';
+    tramasMalFormadas++;
+    return largo + 1;
+}
+
+size_t GeneradorDeTramas::escribirTexto(char* destino) {
+    unsigned long long valor = sortear();
+    unsigned long long carga = sortear();
+    
+    if (corridaPendiente == 0) {
+        long clase = (long)(valor % 1000);
+        if (clase < perfil.malFormadasPorMil) {
+            return escribirError(destino, carga);
+        }
+        clase -= perfil.malFormadasPorMil;
+        if (clase < perfil.reiniciosPorMil) {
+            memcpy(destino, "I\n", 2);
+            return 2;
+        }
+    }
+    
+    size_t usados = 0;
+    bool ruido = (long)((valor >> 30) % 1000) < perfil.ruidoPorMil;
+    int extremos = (int)((valor >> 40) % 3) + 1; // 1 = al comienzo, 2 = al final, 3 = en ambos
+    if (ruido && (extremos & 1)) {
+        int cantidad = (int)((carga >> 2) % 3) + 1;
+        for (int i = 0; i < cantidad; i++) {
+            destino[usados++] = RUIDO[(carga >> (8 + 4 * i)) % sizeof(RUIDO)];
+        }
+    }
+    
+    if (corridaPendiente == 0 && (long)((valor >> 10) % 1000) < perfil.mapeoPorMil) {
+        usados += (size_t)snprintf(destino + usados, 16, "M,%d", sortearRotacion(carga));
+    } else {
+        if (corridaPendiente == 0) {
+            corridaPendiente = 1 + (int)((valor >> 50) % (unsigned long long)perfil.corridaMaxima);
+        }
+        corridaPendiente--;
+        
+        char cifrado = sortearCaracter(carga);
+        if (cifrado == ' ') {
+            memcpy(destino + usados, "L,Space", 7);
+            usados += 7;
+        } else {
+            destino[usados++] = 'L';
+            destino[usados++] = ',';
+            destino[usados++] = cifrado;
+        }
+        esperar(cifrado);
+    }
+    
+    if (ruido && (extremos & 2)) {
+        int cantidad = (int)((carga >> 5) % 3) + 1;
+        for (int i = 0; i < cantidad; i++) {
+            destino[usados++] = RUIDO[(carga >> (24 + 4 * i)) % sizeof(RUIDO)];
+        }
+    }
+    if (ruido) tramasReparadas++;
+    
+    destino[usados++] = '\n';
+    return usados;
+}
+
+size_t GeneradorDeTramas::escribirBinaria(char* destino) {
+    unsigned long long valor = sortear();
+    
+    if ((long)((valor >> 10) % 1000) < perfil.mapeoPorMil) {
+        return codificarMapeoBinario(sortearRotacion(sortear()), destino);
+    }
+    
+    size_t largo = 1 + (size_t)((valor >> 50) % (unsigned long long)perfil.corridaMaxima);
+    if (largo > MAX_CARGA_BINARIA) largo = MAX_CARGA_BINARIA;
+    
+    char cifrados[MAX_CARGA_BINARIA];
+    for (size_t i = 0; i < largo; i++) {
+        cifrados[i] = sortearCaracter(sortear());
+        esperar(cifrados[i]);
+    }
+    return codificarCargaBinaria(cifrados, largo, destino);
+}
+
+size_t GeneradorDeTramas::generar(char* destino, size_t capacidad, unsigned long long maxTramas,
+                                  unsigned long long* escritas) {
+    size_t usados = 0;
+    if (!iniciado) {
+        memcpy(destino, "I\n", 2);
+        usados = 2;
+        if (perfil.binario) {
+            memcpy(destino + usados, "BIN\n", 4);
+            usados += 4;
+        }
+        iniciado = true;
+    }
+    
+    unsigned long long cantidad = 0;
+    while (cantidad < maxTramas && capacidad - usados >= MAX_TRAMA) {
+        usados += perfil.binario ? escribirBinaria(destino + usados) : escribirTexto(destino + usados);
+        cantidad++;
+    }
+    
+    generadas += cantidad;
+    if (escritas != nullptr) *escritas = cantidad;
+    entregarEsperados();
+    return usados;
+}
+
+size_t GeneradorDeTramas::finalizar(char* destino) {
+    size_t usados = 0;
+    if (!iniciado) {
+        usados = generar(destino, MAX_TRAMA, 0, nullptr);
+    }
+    
+    // En binario el '\n' previo resincroniza si la última trama quedó incompleta
+    const char* fin = perfil.binario ? "\nFIN\n" : "FIN\n";
+    size_t largo = strlen(fin);
+    memcpy(destino + usados, fin, largo);
+    
+    entregarEsperados();
+    return usados + largo;
+}
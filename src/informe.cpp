@@ -0,0 +1,90 @@
+/**
+ * @file informe.cpp
+ * @brief Formato y escritura del informe JSON de fin de sesión.
+ */
+
+#include "prt7/informe.h"
+
+#include <cstdio>       // Para snprintf()
+#include <cstring>      // Para strcmp()
+#include <fcntl.h>      // Para open()
+#include <iostream>     // Para cout (se vacía antes de escribir en la salida estándar)
+#include <unistd.h>     // Para close()
+
+#include "prt7/escritura.h"
+
+using namespace std;
+
+InformeDeSesion::InformeDeSesion()
+    : inicio(relojInstrumentacion()), duracion(0), tramasCarga(0), tramasMapeo(0), tramasMalFormadas(0),
+      tramasDescartadas(0), tramasReparadas(0), rotacionMaxima(0), finRecibido(false), bytes(0),
+      lecturas(0), nanosEnLectura(0), memoriaMaxima(0) {}
+
+void InformeDeSesion::registrarDecodificador(const Decodificador& decodificador) {
+    tramasCarga = decodificador.getTramasCarga();
+    tramasMapeo = decodificador.getTramasMapeo();
+    tramasMalFormadas = decodificador.getTramasMalFormadas();
+    tramasDescartadas = decodificador.getTramasDescartadas();
+    tramasReparadas = decodificador.getTramasReparadas();
+    rotacionMaxima = decodificador.getRotacionMaxima();
+    finRecibido = decodificador.getFinRecibido();
+}
+
+void InformeDeSesion::registrarLista(const ListaDeCarga& lista) {
+    memoriaMaxima = lista.getMemoriaMaxima();
+}
+
+/**
+ * @brief Convierte nanosegundos a microsegundos con decimales.
+ * @param nanos Nanosegundos.
+ * @return Microsegundos.
+ */
+static double aMicrosegundos(unsigned long long nanos) {
+    return (double)nanos / 1e3;
+}
+
+size_t InformeDeSesion::formatear(char* destino, size_t capacidad) const {
+    long tramas = tramasCarga + tramasMapeo + tramasMalFormadas + tramasDescartadas;
+    
+    // Una sesión vacía dura unos microsegundos: el ritmo se informa igual, sin dividir por cero
+    double segundos = (double)duracion / 1e9;
+    double porSegundo = segundos > 0 ? 1.0 / segundos : 0.0;
+    
+    int escritos = snprintf(destino, capacidad,
+        "{\"formato\":1,\"fin_recibido\":%s,\"duracion_s\":%.6f,"
+        "\"bytes\":%llu,\"bytes_por_segundo\":%.1f,"
+        "\"tramas\":{\"total\":%ld,\"carga\":%ld,\"mapeo\":%ld,\"mal_formadas\":%ld,"
+        "\"descartadas\":%ld,\"reparadas\":%ld},\"tramas_por_segundo\":%.1f,"
+        "\"lecturas\":%ld,\"bloqueado_en_lectura_s\":%.6f,"
+        "\"latencia_decodificacion_us\":{\"muestras\":%llu,\"p50\":%.3f,\"p90\":%.3f,\"p99\":%.3f,"
+        "\"p999\":%.3f,\"maximo\":%.3f},"
+        "\"memoria_lista_max_bytes\":%lu,\"rotacion_maxima\":%lld}\n",
+        finRecibido ? "true" : "false", segundos,
+        bytes, (double)bytes * porSegundo,
+        tramas, tramasCarga, tramasMapeo, tramasMalFormadas,
+        tramasDescartadas, tramasReparadas, (double)tramas * porSegundo,
+        lecturas, (double)nanosEnLectura / 1e9,
+        latencias.getMuestras(), aMicrosegundos(latencias.percentil(500)), aMicrosegundos(latencias.percentil(900)),
+        aMicrosegundos(latencias.percentil(990)), aMicrosegundos(latencias.percentil(999)),
+        aMicrosegundos(latencias.getMaximo()),
+        (unsigned long)memoriaMaxima, rotacionMaxima);
+    
+    if (escritos < 0) return 0;
+    return (size_t)escritos < capacidad ? (size_t)escritos : capacidad - 1;
+}
+
+bool InformeDeSesion::escribir(const char* destino) const {
+    char texto[MAX_INFORME];
+    size_t largo = formatear(texto, sizeof(texto));
+    
+    if (strcmp(destino, "-") == 0) {
+        // Después de lo que el programa ya imprimió con cout
+        cout.flush();
+        return escribirTodo(STDOUT_FILENO, texto, largo);
+    }
+    
+    int fd = open(destino, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) return false;
+    bool correcto = escribirTodo(fd, texto, largo);
+    return close(fd) == 0 && correcto;
+}
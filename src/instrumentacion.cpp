@@ -0,0 +1,148 @@
+/**
+ * @file instrumentacion.cpp
+ * @brief Estado global y volcado de la instrumentación.
+ */
+
+#include "prt7/instrumentacion.h"
+
+#ifdef PRT7_INSTRUMENTACION
+#include <cerrno>       // Para errno
+#include <csignal>      // Para sigaction()
+#include <cstring>      // Para memset()
+#include <unistd.h>     // Para write()
+
+using namespace std;
+
+/**
+ * @brief Instrumentación global del proceso.
+ */
+Instrumentacion instrumentacion;
+
+/**
+ * @brief Momento en que el hilo recibió el bloque de bytes que está decodificando.
+ */
+thread_local unsigned long long marcaRecepcion = 0;
+
+/**
+ * @brief Agrega un texto a un buffer (sin usar funciones inseguras en señales).
+ * @param destino Buffer de salida.
+ * @param usados Bytes ocupados en `destino` (se actualiza).
+ * @param capacidad Tamaño de `destino`.
+ * @param texto Texto terminado en '\0'.
+ */
+static void agregarTexto(char* destino, int* usados, int capacidad, const char* texto) {
+    for (; *texto != '\0' && *usados < capacidad; texto++) {
+        destino[(*usados)++] = *texto;
+    }
+}
+
+/**
+ * @brief Agrega a un buffer un texto seguido de un número sin signo en base 10.
+ * @param destino Buffer de salida.
+ * @param usados Bytes ocupados en `destino` (se actualiza).
+ * @param capacidad Tamaño de `destino`.
+ * @param texto Texto a agregar antes del número.
+ * @param numero Número a agregar.
+ */
+static void agregarCampo(char* destino, int* usados, int capacidad, const char* texto,
+                         unsigned long long numero) {
+    agregarTexto(destino, usados, capacidad, texto);
+    
+    char digitos[24];
+    int posicion = sizeof(digitos);
+    do {
+        digitos[--posicion] = (char)('0' + numero % 10);
+        numero /= 10;
+    } while (numero > 0);
+    
+    while (posicion < (int)sizeof(digitos) && *usados < capacidad) {
+        destino[(*usados)++] = digitos[posicion++];
+    }
+}
+
+/**
+ * @brief Agrega a un buffer el resumen de un histograma: muestras y percentiles.
+ * @param destino Buffer de salida.
+ * @param usados Bytes ocupados en `destino` (se actualiza).
+ * @param capacidad Tamaño de `destino`.
+ * @param nombre Nombre de la métrica.
+ * @param histograma Histograma a resumir.
+ */
+static void agregarHistograma(char* destino, int* usados, int capacidad, const char* nombre,
+                              const HistogramaLatencia& histograma) {
+    agregarCampo(destino, usados, capacidad, nombre, histograma.getMuestras());
+    agregarCampo(destino, usados, capacidad, " p50=", histograma.percentil(500));
+    agregarCampo(destino, usados, capacidad, " p90=", histograma.percentil(900));
+    agregarCampo(destino, usados, capacidad, " p99=", histograma.percentil(990));
+    agregarCampo(destino, usados, capacidad, " p99.9=", histograma.percentil(999));
+    agregarCampo(destino, usados, capacidad, " max=", histograma.getMaximo());
+    agregarTexto(destino, usados, capacidad, " ns\n");
+}
+
+/**
+ * @brief Escribe los contadores e histogramas en un descriptor.
+ *
+ * Solo usa lecturas atómicas, aritmética y write(), así que es seguro
+ * llamarla desde un manejador de señal.
+ * @param fd Descriptor de destino (e.g., STDERR_FILENO).
+ */
+void volcarInstrumentacion(int fd) {
+    const int CAPACIDAD = 2048;
+    char texto[CAPACIDAD];
+    int usados = 0;
+    const Instrumentacion& datos = instrumentacion;
+    
+    agregarCampo(texto, &usados, CAPACIDAD, "--- Instrumentacion PRT-7 ---\ntramas: carga=",
+                 datos.tramas[0].load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, " mapeo=", datos.tramas[1].load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, " inicio=", datos.tramas[2].load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, " fin=", datos.tramas[3].load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, " mal_formadas=", datos.tramas[4].load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, " binario=", datos.tramas[5].load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, " descartadas=", datos.tramas[6].load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, "\nentrada: bytes=", datos.bytesLeidos.load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, " lecturas=", datos.lecturas.load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, "\nrotor: rotaciones=", datos.rotaciones.load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, " consultas_mapeo=", datos.consultasMapeo.load(memory_order_relaxed));
+    agregarCampo(texto, &usados, CAPACIDAD, " caracteres_en_lote=",
+                 datos.caracteresEnLote.load(memory_order_relaxed));
+    agregarTexto(texto, &usados, CAPACIDAD, "\n");
+    agregarHistograma(texto, &usados, CAPACIDAD, "parseo: muestras=", datos.parseo);
+    agregarHistograma(texto, &usados, CAPACIDAD, "procesar: muestras=", datos.procesado);
+    agregarHistograma(texto, &usados, CAPACIDAD, "rotar: muestras=", datos.rotacion);
+    agregarHistograma(texto, &usados, CAPACIDAD, "recepcion_a_carga: muestras=", datos.latencia);
+    
+    const char* pendiente = texto;
+    while (usados > 0) {
+        ssize_t escritos = write(fd, pendiente, usados);
+        if (escritos < 0 && errno == EINTR) continue;
+        if (escritos <= 0) break;
+        pendiente += escritos;
+        usados -= (int)escritos;
+    }
+}
+
+/**
+ * @brief Manejador de SIGUSR1: vuelca la instrumentación a stderr sin detener la decodificación.
+ * @param senal Número de la señal.
+ */
+static void manejarVolcadoInstrumentacion(int senal) {
+    (void)senal;
+    int errnoPrevio = errno;
+    volcarInstrumentacion(STDERR_FILENO);
+    errno = errnoPrevio;
+}
+
+/**
+ * @brief Instala el manejador de SIGUSR1 para volcar la instrumentación a pedido.
+ */
+void instalarVolcadoInstrumentacion() {
+    struct sigaction accion;
+    memset(&accion, 0, sizeof(accion));
+    accion.sa_handler = manejarVolcadoInstrumentacion;
+    accion.sa_flags = SA_RESTART;
+    sigemptyset(&accion.sa_mask);
+    sigaction(SIGUSR1, &accion, nullptr);
+}
+
+#endif // PRT7_INSTRUMENTACION
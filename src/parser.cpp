@@ -0,0 +1,290 @@
+/**
+ * @file parser.cpp
+ * @brief Clasificación de tramas de texto y tokenizador en lote.
+ */
+
+#include "prt7/parser.h"
+
+#include <cstring>      // Para strlen(), memcmp()
+
+#include "prt7/fuentes.h"
+#include "prt7/instrumentacion.h"
+
+using namespace std;
+
+bool analizarTrama(const char* linea, int longitud, RegistroTrama* registro) {
+    if (longitud < 3) return false; // Trama mínima "L,X" o "M,N" (M,N requiere al menos 3)
+    
+    char tipo = linea[0];
+    int rotor = 0;
+    int inicioValor = 2;
+    
+    if (tipo == 'M' && longitud >= 4 && linea[2] == ',') {
+        // Variantes de la cascada: "Mk,N" (rotor k) y "MP,N" (N pasos de avance)
+        if (linea[1] >= '0' && linea[1] <= '9') {
+            rotor = linea[1] - '0';
+        } else if (linea[1] == 'P') {
+            rotor = TramaMap::ROTOR_PASOS;
+        } else {
+            return false;
+        }
+        inicioValor = 3;
+    } else if (linea[1] != ',') {
+        return false;
+    }
+    
+    if (tipo == 'L') {
+        // Trama: L,X o L,Space (cualquier otra cosa después del carácter la invalida)
+        if (longitud == 3) {
+            registro->caracter = linea[2];
+        } else if (longitud == 7 && memcmp(linea + 2, "Space", 5) == 0) {
+            registro->caracter = ' ';
+        } else {
+            return false;
+        }
+        registro->tipo = TRAMA_LOAD;
+        return true;
+    }
+    else if (tipo == 'M') {
+        // Trama: M,N o M,-N (o Mk,N / MP,N)
+        long long numero = 0;
+        int signo = 1;
+        int indice = inicioValor;
+        
+        if (linea[indice] == '-') {
+            signo = -1;
+            indice++;
+        }
+        
+        int inicioDigitos = indice;
+        while (indice < longitud && linea[indice] >= '0' && linea[indice] <= '9') {
+            numero = numero * 10 + (linea[indice] - '0');
+            indice++;
+            
+            // Fuera del rango de int la trama se rechaza (sin desbordar el acumulador)
+            if (numero > 2147483648LL) return false;
+        }
+        
+        if (indice == inicioDigitos || indice != longitud) {
+             // Caso de M, o M,- (sin número), o basura después del número
+             return false; 
+        }
+        if (signo == 1 && numero > 2147483647LL) return false;
+        if (rotor == TramaMap::ROTOR_PASOS && (signo < 0 || numero > CascadaDeRotores::MAX_PASOS)) {
+            // Los pasos no se pueden deshacer y cada uno se aplica por separado
+            return false;
+        }
+        
+        registro->tipo = TRAMA_MAP;
+        registro->rotor = (signed char)rotor;
+        registro->rotacion = (int)(numero * signo);
+        return true;
+    }
+    
+    return false;
+}
+
+/**
+ * @brief Indica si un byte es ruido que no puede formar parte de una trama (control, espacio o no ASCII).
+ * @param c El byte.
+ * @return true si es ruido.
+ */
+static inline bool esRuido(char c) {
+    return (unsigned char)c <= ' ' || (unsigned char)c >= 0x7F;
+}
+
+/**
+ * @brief Convierte un dígito hexadecimal (mayúscula o minúscula).
+ * @param c El carácter.
+ * @return Su valor, o -1 si no es un dígito hexadecimal.
+ */
+static inline int valorHexadecimal(char c) {
+    if (c >= '0' && c <= '9') return c - '0';
+    if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+    if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+    return -1;
+}
+
+bool verificarChecksum(const char* linea, int* longitud, bool* valido) {
+    int largo = *longitud;
+    if (largo < 4 || linea[largo - 3] != '*') return false;
+    
+    int alto = valorHexadecimal(linea[largo - 2]);
+    int bajo = valorHexadecimal(linea[largo - 1]);
+    if (alto < 0 || bajo < 0) return false;
+    
+    unsigned char suma = 0;
+    for (int i = 0; i < largo - 3; i++) {
+        suma ^= (unsigned char)linea[i];
+    }
+    *valido = suma == (unsigned char)(alto * 16 + bajo);
+    *longitud = largo - 3;
+    return true;
+}
+
+void clasificarTrama(const char* linea, int longitud, RegistroTrama* registro) {
+    PRT7_CRONOMETRAR(parseo);
+    registro->reparada = false;
+    
+    if (longitud > FuenteDeLineas::MAX_LINEA) {
+        // Línea demasiado larga (las fuentes entregan solo su comienzo y descartan el resto)
+        registro->tipo = TRAMA_DESCARTADA;
+        PRT7_CONTAR_TRAMA(registro->tipo);
+        return;
+    }
+    
+    // Quitar el ruido de los extremos (e.g., bytes nulos tras una interferencia);
+    // "L, " tiene un espacio como carga, así que nunca se recorta por debajo de 3
+    int original = longitud;
+    while (longitud > 0 && esRuido(linea[0])) {
+        linea++;
+        longitud--;
+    }
+    while (longitud > 3 && esRuido(linea[longitud - 1])) {
+        longitud--;
+    }
+    bool recortada = longitud != original;
+    
+    bool checksumValido;
+    if (longitud == 0) {
+        registro->tipo = TRAMA_MAL_FORMADA;
+    } else if (linea[0] == 'I') {
+        registro->tipo = TRAMA_INICIO;
+    } else if (longitud >= 3 && linea[0] == 'F' && linea[1] == 'I' && linea[2] == 'N') {
+        registro->tipo = TRAMA_FIN;
+    } else if (longitud == 3 && linea[0] == 'B' && linea[1] == 'I' && linea[2] == 'N') {
+        registro->tipo = TRAMA_BINARIO;
+    } else if (verificarChecksum(linea, &longitud, &checksumValido) && !checksumValido) {
+        registro->tipo = TRAMA_DESCARTADA;
+    } else if (!analizarTrama(linea, longitud, registro)) {
+        registro->tipo = TRAMA_MAL_FORMADA;
+    } else {
+        registro->reparada = recortada;
+    }
+    
+    PRT7_CONTAR_TRAMA(registro->tipo);
+}
+
+/**
+ * @brief Clasifica un segmento entre terminadores como una línea (si no está vacío).
+ *
+ * Un segmento de más de MAX_LINEA caracteres se descarta completo como una
+ * sola trama, sin volver a recorrerlo.
+ * @param linea Inicio del segmento.
+ * @param largo Largo del segmento (puede ser 0).
+ * @param registros Arreglo de salida.
+ * @param maxRegistros Capacidad de `registros`.
+ * @param cantidad Registros ya escritos (se actualiza).
+ * @param usados Recibe los bytes del segmento que quedaron clasificados.
+ * @return true si se llegó a "FIN" o "BIN".
+ */
+static bool clasificarSegmento(const char* linea, size_t largo, RegistroTrama* registros,
+                               size_t maxRegistros, size_t* cantidad, size_t* usados) {
+    *usados = 0;
+    if (largo == 0 || *cantidad == maxRegistros) {
+        return false;
+    }
+    
+    size_t pieza = largo;
+    if (pieza > (size_t)FuenteDeLineas::MAX_LINEA) {
+        pieza = FuenteDeLineas::MAX_LINEA + 1;
+    }
+    
+    RegistroTrama* registro = &registros[(*cantidad)++];
+    clasificarTrama(linea, (int)pieza, registro);
+    *usados = largo;
+    
+    // Después de "BIN" los bytes ya no son texto
+    return registro->tipo == TRAMA_FIN || registro->tipo == TRAMA_BINARIO;
+}
+
+size_t tokenizarBloque(const char* datos, size_t tamano, bool finDeDatos,
+                       RegistroTrama* registros, size_t maxRegistros, size_t* consumidos) {
+    size_t cantidad = 0;
+    size_t inicioLinea = 0;
+    size_t usados;
+    size_t bloque = 0;
+    *consumidos = 0;
+    
+    while (bloque < tamano) {
+        unsigned long long mascara;
+        size_t ancho;
+        
+        if (bloque + 64 <= tamano) {
+            mascara = mascaraTerminadores64(datos + bloque);
+            ancho = 64;
+        } else {
+            // Cola del bloque: recorrido escalar
+            mascara = 0;
+            ancho = tamano - bloque;
+            for (size_t i = 0; i < ancho; i++) {
+                if (datos[bloque + i] == '\n' || datos[bloque + i] == '\r') {
+                    mascara |= 1ULL << i;
+                }
+            }
+        }
+        
+        while (mascara != 0) {
+            size_t terminador = bloque + (size_t)__builtin_ctzll(mascara);
+            mascara &= mascara - 1;
+            
+            size_t largo = terminador - inicioLinea;
+            bool fin = clasificarSegmento(datos + inicioLinea, largo, registros,
+                                          maxRegistros, &cantidad, &usados);
+            if (fin) {
+                // Tras "FIN" o "BIN" se consume también su terminador, completo si es "\r\n"
+                // (lo que sigue a "BIN" son tramas binarias: un '\n' suelto no es texto)
+                *consumidos = terminador + 1;
+                if (datos[terminador] == '\r' && terminador + 1 < tamano && datos[terminador + 1] == '\n') {
+                    *consumidos = terminador + 2;
+                }
+                return cantidad;
+            }
+            if (usados < largo) {
+                // Sin lugar para más registros: la línea queda para la próxima llamada
+                return cantidad;
+            }
+            
+            inicioLinea = terminador + 1;
+            *consumidos = inicioLinea;
+        }
+        bloque += ancho;
+    }
+    
+    // Última línea sin terminador
+    if (finDeDatos && inicioLinea < tamano) {
+        clasificarSegmento(datos + inicioLinea, tamano - inicioLinea, registros,
+                           maxRegistros, &cantidad, &usados);
+        *consumidos = inicioLinea + usados;
+    }
+    
+    return cantidad;
+}
+
+TramaBase* parsearLinea(char* linea) {
+    RegistroTrama registro;
+    if (!analizarTrama(linea, (int)strlen(linea), &registro)) {
+        return nullptr;
+    }
+    
+    if (registro.tipo == TRAMA_LOAD) {
+        return new TramaLoad(registro.caracter);
+    }
+    if (registro.rotor != 0) {
+        // "Mk,N" y "MP,N" solo sirven con una cascada, que esta API no ofrece
+        return nullptr;
+    }
+    return new TramaMap(registro.rotacion);
+}
+
+TramaBase* parsearLinea(const char* linea, int longitud, RanurasDeTrama* ranuras) {
+    RegistroTrama registro;
+    if (!analizarTrama(linea, longitud, &registro)) {
+        return nullptr;
+    }
+    return ranuras->asignar(registro);
+}
+
+TramaBase* parsearLinea(const char* linea, RanurasDeTrama* ranuras) {
+    return parsearLinea(linea, (int)strlen(linea), ranuras);
+}
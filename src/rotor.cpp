@@ -0,0 +1,80 @@
+/**
+ * @file rotor.cpp
+ * @brief Decodificación vectorizada de corridas de caracteres.
+ */
+
+#include "prt7/rotor.h"
+#include "prt7/plataforma.h"
+
+using namespace std;
+
+void decodificarCorrida(const char* entrada, char* salida, size_t cantidad, const RotorDeMapeo& rotor) {
+    PRT7_CONTAR(caracteresEnLote, cantidad);
+    size_t i = 0;
+    
+#if defined(PRT7_SIMD_SSE2) || defined(PRT7_SIMD_NEON)
+    char desplazamiento = (char)rotor.getDesplazamiento();
+#endif
+    
+#if defined(PRT7_SIMD_AVX2)
+    {
+        __m256i antesDeA = _mm256_set1_epi8('A' - 1);
+        __m256i despuesDeZ = _mm256_set1_epi8('Z' + 1);
+        __m256i zeta = _mm256_set1_epi8('Z');
+        __m256i vuelta = _mm256_set1_epi8(26);
+        __m256i paso = _mm256_set1_epi8(desplazamiento);
+        
+        for (; i + 32 <= cantidad; i += 32) {
+            __m256i bloque = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(entrada + i));
+            __m256i esLetra = _mm256_and_si256(_mm256_cmpgt_epi8(bloque, antesDeA),
+                                               _mm256_cmpgt_epi8(despuesDeZ, bloque));
+            __m256i suma = _mm256_add_epi8(bloque, paso);
+            suma = _mm256_sub_epi8(suma, _mm256_and_si256(_mm256_cmpgt_epi8(suma, zeta), vuelta));
+            __m256i resultado = _mm256_or_si256(_mm256_and_si256(esLetra, suma),
+                                                _mm256_andnot_si256(esLetra, bloque));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(salida + i), resultado);
+        }
+    }
+#endif
+    
+#if defined(PRT7_SIMD_SSE2)
+    {
+        // Con letras de 'A' a 'Z' y desplazamiento < 26 la suma no pasa de 127 (sin desborde con signo)
+        __m128i antesDeA = _mm_set1_epi8('A' - 1);
+        __m128i despuesDeZ = _mm_set1_epi8('Z' + 1);
+        __m128i zeta = _mm_set1_epi8('Z');
+        __m128i vuelta = _mm_set1_epi8(26);
+        __m128i paso = _mm_set1_epi8(desplazamiento);
+        
+        for (; i + 16 <= cantidad; i += 16) {
+            __m128i bloque = _mm_loadu_si128(reinterpret_cast<const __m128i*>(entrada + i));
+            __m128i esLetra = _mm_and_si128(_mm_cmpgt_epi8(bloque, antesDeA),
+                                            _mm_cmplt_epi8(bloque, despuesDeZ));
+            __m128i suma = _mm_add_epi8(bloque, paso);
+            suma = _mm_sub_epi8(suma, _mm_and_si128(_mm_cmpgt_epi8(suma, zeta), vuelta));
+            __m128i resultado = _mm_or_si128(_mm_and_si128(esLetra, suma),
+                                             _mm_andnot_si128(esLetra, bloque));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(salida + i), resultado);
+        }
+    }
+#elif defined(PRT7_SIMD_NEON)
+    {
+        uint8x16_t letraA = vdupq_n_u8('A');
+        uint8x16_t letraZ = vdupq_n_u8('Z');
+        uint8x16_t vuelta = vdupq_n_u8(26);
+        uint8x16_t paso = vdupq_n_u8((uint8_t)desplazamiento);
+        
+        for (; i + 16 <= cantidad; i += 16) {
+            uint8x16_t bloque = vld1q_u8(reinterpret_cast<const uint8_t*>(entrada + i));
+            uint8x16_t esLetra = vandq_u8(vcgeq_u8(bloque, letraA), vcleq_u8(bloque, letraZ));
+            uint8x16_t suma = vaddq_u8(bloque, paso);
+            suma = vsubq_u8(suma, vandq_u8(vcgtq_u8(suma, letraZ), vuelta));
+            vst1q_u8(reinterpret_cast<uint8_t*>(salida + i), vbslq_u8(esLetra, suma, bloque));
+        }
+    }
+#endif
+    
+    for (; i < cantidad; i++) {
+        salida[i] = rotor.getMapeo(entrada[i]);
+    }
+}
@@ -0,0 +1,13 @@
+/**
+ * @file salida.cpp
+ * @brief Salida de traza global.
+ */
+
+#include "prt7/salida.h"
+
+using namespace std;
+
+/**
+ * @brief Salida de traza por trama. Es nullptr cuando el nivel de salida no es SALIDA_TRAZA.
+ */
+SalidaBufferizada* salidaTraza = nullptr;
@@ -0,0 +1,121 @@
+/**
+ * @file serial.cpp
+ * @brief Configuración y apertura del puerto serial.
+ */
+
+#include "prt7/serial.h"
+
+#include <cstring>      // Para strncpy()
+#include <fcntl.h>      // Para open()
+#include <unistd.h>     // Para usleep()
+#ifdef __linux__
+#include <sys/ioctl.h>      // Para ioctl()
+#include <linux/serial.h>   // Para ASYNC_LOW_LATENCY
+#endif
+
+using namespace std;
+
+speed_t convertirBaudios(int baudios) {
+    switch (baudios) {
+        case 1200:   return B1200;
+        case 2400:   return B2400;
+        case 4800:   return B4800;
+        case 9600:   return B9600;
+        case 19200:  return B19200;
+        case 38400:  return B38400;
+        case 57600:  return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+#ifdef B460800
+        case 460800: return B460800;
+#endif
+#ifdef B500000
+        case 500000: return B500000;
+#endif
+#ifdef B576000
+        case 576000: return B576000;
+#endif
+#ifdef B921600
+        case 921600: return B921600;
+#endif
+        default:     return B0;
+    }
+}
+
+int configurarSerial(const ConfiguracionSerial& config) {
+    speed_t velocidad = convertirBaudios(config.baudios);
+    if (velocidad == B0) {
+        return -1;
+    }
+    
+    // Abrir el puerto serial
+    int fd = open(config.puerto, O_RDWR | O_NOCTTY);
+    
+    if (fd == -1) {
+        return -1;
+    }
+    
+    // Configurar parámetros del puerto
+    struct termios opciones;
+    
+    // Obtener configuración actual
+    tcgetattr(fd, &opciones);
+    
+    // Configurar velocidad
+    cfsetispeed(&opciones, velocidad);
+    cfsetospeed(&opciones, velocidad);
+    
+    // Configuración: 8N1 (8 bits, sin paridad, 1 bit de stop)
+    opciones.c_cflag &= ~PARENB;  // Sin paridad
+    opciones.c_cflag &= ~CSTOPB;  // 1 bit de stop
+    opciones.c_cflag &= ~CSIZE;   // Limpiar tamaño
+    opciones.c_cflag |= CS8;      // 8 bits
+    
+    // Deshabilitar control de flujo hardware
+    opciones.c_cflag &= ~CRTSCTS;
+    
+    // Habilitar lectura
+    opciones.c_cflag |= CREAD | CLOCAL;
+    
+    // Modo raw (sin procesamiento)
+    opciones.c_lflag &= ~(ICANON | ECHO | ECHOE | ISIG);
+    opciones.c_iflag &= ~(IXON | IXOFF | IXANY);
+    opciones.c_oflag &= ~OPOST;
+    
+    // Con VMIN = 1 y VTIME = 0, read() bloquea hasta que haya al menos un byte
+    opciones.c_cc[VMIN] = (cc_t)config.vmin;
+    opciones.c_cc[VTIME] = (cc_t)config.vtime;
+    
+    // Aplicar configuración
+    tcsetattr(fd, TCSANOW, &opciones);
+    
+#ifdef __linux__
+    if (config.bajaLatencia) {
+        // Pedir al driver que entregue los bytes sin acumularlos (se ignora si no lo soporta)
+        struct serial_struct serial;
+        if (ioctl(fd, TIOCGSERIAL, &serial) == 0) {
+            serial.flags |= ASYNC_LOW_LATENCY;
+            ioctl(fd, TIOCSSERIAL, &serial);
+        }
+    }
+#endif
+    
+    // Si el puerto reporta la configuración aplicada ya está listo; si no, esperar a que se estabilice
+    struct termios aplicadas;
+    bool listo = tcgetattr(fd, &aplicadas) == 0 &&
+                 cfgetispeed(&aplicadas) == velocidad &&
+                 (aplicadas.c_cflag & CSIZE) == CS8 &&
+                 (aplicadas.c_lflag & ICANON) == 0;
+    if (!listo) {
+        usleep(100000); // 100ms
+    }
+    
+    return fd;
+}
+
+int configurarSerial(const char* puerto) {
+    ConfiguracionSerial config;
+    strncpy(config.puerto, puerto, sizeof(config.puerto) - 1);
+    config.puerto[sizeof(config.puerto) - 1] = '\0';
+    return configurarSerial(config);
+}
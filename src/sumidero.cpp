@@ -0,0 +1,173 @@
+/**
+ * @file sumidero.cpp
+ * @brief Volcado incremental del mensaje y apertura de los destinos (archivo, socket UNIX o TCP).
+ */
+
+#include "prt7/sumidero.h"
+
+#include <cstring>      // Para strncmp(), strrchr(), memcpy()
+#include <fcntl.h>      // Para open()
+#include <iostream>     // Para std::cout
+#include <netdb.h>      // Para getaddrinfo()
+#include <netinet/in.h> // Para IPPROTO_TCP
+#include <netinet/tcp.h> // Para TCP_NODELAY
+#include <sys/socket.h> // Para socket(), connect()
+#include <sys/un.h>     // Para struct sockaddr_un
+#include <unistd.h>     // Para close(), STDOUT_FILENO
+
+#include "prt7/escritura.h"
+#include "prt7/plataforma.h"
+#include "prt7/salida.h"
+
+using namespace std;
+
+// CLASE BASE: SUMIDERO DE CARGA
+
+SumideroDeCarga::SumideroDeCarga(ListaDeCarga* origen)
+    : lista(origen), enviados(0), escrituras(0), ultimoVolcado(SalidaBufferizada::milisegundos()),
+      fallido(false) {}
+
+bool SumideroDeCarga::volcar() {
+    ultimoVolcado = SalidaBufferizada::milisegundos();
+    
+    struct iovec segmentos[IOV_MAX];
+    int cantidad = 0;
+    size_t enLote = 0;
+    const char* datos;
+    size_t largo;
+    
+    while (true) {
+        bool ultimo = !lista->leerNuevos(&datos, &largo);
+        if (!ultimo && !fallido) {
+            segmentos[cantidad].iov_base = const_cast<char*>(datos);
+            segmentos[cantidad].iov_len = largo;
+            cantidad++;
+            enLote += largo;
+        }
+        
+        if ((ultimo && cantidad > 0) || cantidad == IOV_MAX) {
+            escrituras++;
+            if (escribir(segmentos, cantidad)) {
+                enviados += enLote;
+            } else {
+                fallido = true;
+            }
+            cantidad = 0;
+            enLote = 0;
+        }
+        if (ultimo) break;
+    }
+    
+    lista->liberarEntregados();
+    return !fallido;
+}
+
+void SumideroDeCarga::volcarSiHaceFalta() {
+    size_t pendientes = lista->getPendientes();
+    if (pendientes >= UMBRAL ||
+        (pendientes > 0 && SalidaBufferizada::milisegundos() - ultimoVolcado >= INTERVALO_MS)) {
+        volcar();
+    }
+}
+
+// CLASE: SUMIDERO SOBRE UN DESCRIPTOR
+
+/**
+ * @brief Conecta a un socket UNIX de flujo.
+ * @param ruta Ruta del socket.
+ * @return El descriptor conectado, o -1 en caso de error.
+ */
+static int conectarUnix(const char* ruta) {
+    struct sockaddr_un direccion;
+    if (strlen(ruta) >= sizeof(direccion.sun_path)) return -1;
+    
+    memset(&direccion, 0, sizeof(direccion));
+    direccion.sun_family = AF_UNIX;
+    memcpy(direccion.sun_path, ruta, strlen(ruta) + 1);
+    
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd == -1) return -1;
+    if (connect(fd, (struct sockaddr*)&direccion, sizeof(direccion)) == -1) {
+        close(fd);
+        return -1;
+    }
+    return fd;
+}
+
+/**
+ * @brief Conecta a un servidor TCP.
+ *
+ * El sumidero ya junta los caracteres en lotes, así que se desactiva el
+ * algoritmo de Nagle para no demorar el último lote de cada volcado.
+ * @param anfitrion Nombre o dirección del servidor (e.g., "127.0.0.1").
+ * @param puerto Puerto, en texto.
+ * @return El descriptor conectado, o -1 en caso de error.
+ */
+static int conectarTcp(const char* anfitrion, const char* puerto) {
+    struct addrinfo pista;
+    memset(&pista, 0, sizeof(pista));
+    pista.ai_family = AF_UNSPEC;
+    pista.ai_socktype = SOCK_STREAM;
+    
+    struct addrinfo* direcciones;
+    if (getaddrinfo(anfitrion, puerto, &pista, &direcciones) != 0) return -1;
+    
+    int fd = -1;
+    for (struct addrinfo* actual = direcciones; actual != nullptr && fd == -1; actual = actual->ai_next) {
+        fd = socket(actual->ai_family, actual->ai_socktype, actual->ai_protocol);
+        if (fd == -1) continue;
+        if (connect(fd, actual->ai_addr, actual->ai_addrlen) == -1) {
+            close(fd);
+            fd = -1;
+        }
+    }
+    freeaddrinfo(direcciones);
+    
+    if (fd != -1) {
+        int activo = 1;
+        setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &activo, sizeof(activo));
+    }
+    return fd;
+}
+
+bool SumideroDeDescriptor::escribir(struct iovec* segmentos, int cantidad) {
+    if (fd == -1) return false;
+    if (fd == STDOUT_FILENO) cout.flush();
+    return esSocket ? enviarSegmentos(fd, segmentos, cantidad) : escribirSegmentos(fd, segmentos, cantidad);
+}
+
+bool SumideroDeDescriptor::abrir(const char* destino) {
+    cerrar();
+    
+    if (strncmp(destino, "unix:", 5) == 0) {
+        fd = conectarUnix(destino + 5);
+        esSocket = true;
+    } else if (strncmp(destino, "tcp:", 4) == 0) {
+        // "tcp:HOST:PUERTO"; el último ':' separa el puerto
+        const char* anfitrion = destino + 4;
+        const char* dosPuntos = strrchr(anfitrion, ':');
+        if (dosPuntos == nullptr || dosPuntos == anfitrion || dosPuntos[1] == '\0') return false;
+        
+        char nombre[256];
+        size_t largo = (size_t)(dosPuntos - anfitrion);
+        if (largo >= sizeof(nombre)) return false;
+        memcpy(nombre, anfitrion, largo);
+        nombre[largo] = '\0';
+        fd = conectarTcp(nombre, dosPuntos + 1);
+        esSocket = true;
+    } else if (strcmp(destino, "-") == 0) {
+        fd = STDOUT_FILENO;
+        esSocket = false;
+    } else {
+        fd = open(destino, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        esSocket = false;
+    }
+    return fd != -1;
+}
+
+void SumideroDeDescriptor::cerrar() {
+    if (fd != -1 && fd != STDOUT_FILENO) {
+        close(fd);
+    }
+    fd = -1;
+}